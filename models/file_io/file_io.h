@@ -17,6 +17,10 @@ namespace fileio {
         std::vector<std::array<double, 3>> vertices;
         std::vector<std::vector<int>> faces;
         std::vector<int> faceCells;
+        // Apenas VTK: tipo de cada célula (CELL_TYPES, ex. 10 = tetraedro) e o primeiro
+        // campo escalar de CELL_DATA. Ficam vazios quando o arquivo não os contém.
+        std::vector<int> cellTypes;
+        std::vector<double> cellScalars;
     };
 
     // Funções públicas de leitura e gravação
@@ -211,6 +211,32 @@ MeshData read_file_vtk(const std::string &filename) {
             connectivity_count = 0;            // Reseta o contador de células lidas.
             continue;                        // Pula para a próxima iteração, pois esta linha é apenas o cabeçalho da seção.
         }
+        // Tipos das células (um inteiro por célula, possivelmente vários por linha).
+        else if(string_utils::starts_with(upper_line, "CELL_TYPES")) {
+            if(parts.size() < 2)
+                throw std::runtime_error("Formato VTK inválido na linha de CELL_TYPES.");
+            mode = "CELL_TYPES";
+            continue;
+        }
+        // Atributos por célula: apenas o primeiro campo SCALARS é lido; POINT_DATA é ignorado.
+        else if(string_utils::starts_with(upper_line, "CELL_DATA")) {
+            mode = "CELL_DATA";
+            continue;
+        }
+        else if(string_utils::starts_with(upper_line, "POINT_DATA")) {
+            mode = "";
+            continue;
+        }
+        else if(string_utils::starts_with(upper_line, "SCALARS")) {
+            // Só entra em modo de leitura se for o primeiro campo escalar das células
+            mode = (mode == "CELL_DATA" && data.cellScalars.empty()) ? "CELL_SCALARS_HEADER" : "";
+            continue;
+        }
+        else if(string_utils::starts_with(upper_line, "LOOKUP_TABLE")) {
+            if(mode == "CELL_SCALARS_HEADER")
+                mode = "CELL_SCALARS";
+            continue;
+        }
         else {  // Para todas as outras linhas que não são cabeçalhos de seção:
             if(mode == "POINTS") {  // Se o modo atual é de leitura de pontos:
                 if(points_count < n_points) {  // Se ainda não foram lidos todos os pontos esperados:
@@ -248,6 +274,16 @@ MeshData read_file_vtk(const std::string &filename) {
                     connectivity_count++;  // Incrementa o contador de células lidas.
                 }
                 continue;  // Pula para a próxima iteração, pois a linha foi processada.
+            } else if(mode == "CELL_TYPES") {
+                for (const auto &token : parts)
+                    if(data.cellTypes.size() < data.faces.size())
+                        data.cellTypes.push_back(std::stoi(token));
+                continue;
+            } else if(mode == "CELL_SCALARS") {
+                for (const auto &token : parts)
+                    if(data.cellScalars.size() < data.faces.size())
+                        data.cellScalars.push_back(std::stod(token));
+                continue;
             }
         }
     }
@@ -122,6 +122,8 @@ namespace object {
         edges_ = calculateEdges(faces_); // Extrai linhas para Wireframe
         vertexToFacesMapping = computeVertexToFaces(); // Mapeia Vértice -> Faces Vizinhas
         faceAdjacencyMapping = computeFaceAdjacency(); // Mapeia Face -> Faces Vizinhas
+        rebuildTriangulation(); // Triângulos em cache (desenho, picking e Path Tracer)
+        markGeometryChanged();
 
         // 4. Upload para GPU
         if (initGl) {
@@ -138,6 +140,64 @@ namespace object {
             glDeleteBuffers(1, &ibo_faces_);
         if (ibo_edges_ != 0)
             glDeleteBuffers(1, &ibo_edges_);
+        if (vbo_ao_ != 0)
+            glDeleteBuffers(1, &vbo_ao_);
+        if (vbo_vertex_colors_ != 0)
+            glDeleteBuffers(1, &vbo_vertex_colors_);
+        if (vbo_textured_ != 0)
+            glDeleteBuffers(1, &vbo_textured_);
+        if (vbo_textured_mask_ != 0)
+            glDeleteBuffers(1, &vbo_textured_mask_);
+        if (tbo_triangle_face_ != 0)
+            glDeleteBuffers(1, &tbo_triangle_face_);
+        if (tbo_face_colors_ != 0)
+            glDeleteBuffers(1, &tbo_face_colors_);
+        if (tex_triangle_face_ != 0)
+            glDeleteTextures(1, &tex_triangle_face_);
+        if (tex_face_colors_ != 0)
+            glDeleteTextures(1, &tex_face_colors_);
+        if (tbo_face_triangles_ != 0)
+            glDeleteBuffers(1, &tbo_face_triangles_);
+        if (tbo_chunk_boxes_ != 0)
+            glDeleteBuffers(1, &tbo_chunk_boxes_);
+        if (tex_chunk_boxes_ != 0)
+            glDeleteTextures(1, &tex_chunk_boxes_);
+        if (tex_packed_positions_ != 0)
+            glDeleteTextures(1, &tex_packed_positions_);
+        if (hiZ_.pbo != 0)
+            glDeleteBuffers(1, &hiZ_.pbo);
+        if (tex_face_triangles_ != 0)
+            glDeleteTextures(1, &tex_face_triangles_);
+        if (faceProgramState_ == 1)
+            glDeleteProgram(shaderProgram_);
+        if (core_.state == 1) {
+            glDeleteProgram(core_.faceProgram);
+            glDeleteProgram(core_.wireProgram);
+            glDeleteProgram(core_.textureProgram);
+            if (core_.faceWireProgram != 0) glDeleteProgram(core_.faceWireProgram);
+            GLuint vaos[3] = {core_.meshVao, core_.edgeVao, core_.textureVao};
+            glDeleteVertexArrays(3, vaos);
+        }
+        if (gpuTimers_.state == 1)
+            for (auto &frameQueries: gpuTimers_.queries) glDeleteQueries(PASS_COUNT, frameQueries.data());
+        if (pickBuffer_.state == 1) {
+            glDeleteProgram(pickBuffer_.program);
+            if (pickBuffer_.vao != 0) glDeleteVertexArrays(1, &pickBuffer_.vao);
+            if (pickBuffer_.fbo != 0) glDeleteFramebuffers(1, &pickBuffer_.fbo);
+            if (pickBuffer_.depth != 0) glDeleteRenderbuffers(1, &pickBuffer_.depth);
+            if (pickBuffer_.triangleTex != 0) glDeleteTextures(1, &pickBuffer_.triangleTex);
+            if (pickBuffer_.vertexTex != 0) glDeleteTextures(1, &pickBuffer_.vertexTex);
+            if (pickBuffer_.pbo != 0) glDeleteBuffers(1, &pickBuffer_.pbo);
+        }
+    }
+
+    // Marca a geometria como alterada: buffers reenviados no próximo frame e nova versão.
+    // O contador é global para que um objeto recriado no mesmo endereço não repita a versão.
+    void Object::markGeometryChanged() {
+        static unsigned int s_geometryCounter = 0;
+        geometryVersion_ = ++s_geometryCounter;
+        geometryDirty_ = true;
+        textureBatchesDirty_ = true; // Os lotes texturizados copiam as posições
     }
 
     // Recalcula as relações de vizinhança.
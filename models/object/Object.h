@@ -2,12 +2,16 @@
 #define OBJECT_H
 
 #include <vector>
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <string>
 #include <map>
 #include <unordered_map>
 #include <GL/glew.h>
 #include <set>
+#include <chrono>
+#include "../utils/math_utils.h"
 
 #ifdef __APPLE__
 #include <GLUT/glut.h>
@@ -29,6 +33,214 @@ namespace object {
     using Color = std::array<float, 3>;
     using ColorsMap = std::map<std::string, Color>;
 
+    // Elementos de um atributo alterados desde o último envio à GPU. No envio viram
+    // intervalos contíguos [início, fim) para glBufferSubData; buracos pequenos são
+    // unidos (uma chamada maior sai mais barato que muitas pequenas).
+    struct DirtyRanges {
+        std::vector<unsigned int> indices;
+        bool all = false;
+
+        void mark(size_t i) { if (!all) indices.push_back(static_cast<unsigned int>(i)); }
+        void markAll() { all = true; indices.clear(); }
+        bool empty() const { return !all && indices.empty(); }
+        void clear() { all = false; indices.clear(); }
+
+        std::vector<std::pair<size_t, size_t>> spans(size_t count, size_t gap = 64) {
+            std::vector<std::pair<size_t, size_t>> out;
+            if (count == 0 || empty()) return out;
+            // Muitas mudanças espalhadas: um envio completo é mais barato
+            if (all || indices.size() > count / 4) {
+                out.push_back({0, count});
+                return out;
+            }
+            std::sort(indices.begin(), indices.end());
+            for (unsigned int i : indices) {
+                if (i >= count) break;
+                if (!out.empty() && i <= out.back().second + gap) out.back().second = std::max<size_t>(out.back().second, i + 1);
+                else out.push_back({i, i + 1});
+            }
+            return out;
+        }
+    };
+
+    // Buffer de IDs do picking: um FBO com duas imagens de inteiros de 32 bits (triângulo visível
+    // e vértice em cada pixel). Renderizado só quando a câmera ou a geometria mudam, lido de volta
+    // por um PBO de forma assíncrona; cliques consultam a cópia na CPU em O(1).
+    struct PickBuffer {
+        unsigned int fbo = 0, triangleTex = 0, vertexTex = 0, depth = 0, pbo = 0, program = 0, vao = 0;
+        int pointsLocation = -1, mvpLocation = -1, positionLocation = -1, triangleBaseLocation = -1;
+        bool compact = false; // Programa/VAO montados para as posições quantizadas
+        int state = 0; // 0 = não tentado, 1 = pronto, -1 = sem suporte (color picking legado)
+        int width = 0, height = 0;
+        std::array<float, 32> matrices{}; // Projeção + ModelView da última renderização
+        bool dirty = true; // Geometria mudou desde a última renderização
+        bool pending = false; // Leitura no PBO ainda não copiada para 'ids'
+        bool valid = false; // 'ids' corresponde à vista e à geometria atuais
+        std::vector<unsigned int> ids; // [0, W*H) triângulos, [W*H, 2*W*H) vértices (ID + 1; 0 = fundo)
+    };
+
+    // Triângulos por bloco no descarte e no LOD: poucos o bastante para o frustum recortar a malha,
+    // muitos o bastante para não virar uma chamada de desenho por punhado de triângulos.
+    static const int CHUNK_TRIANGLES = 512;
+
+    // Versão simplificada de um bloco (LOD): faixa própria de triângulos no IBO e o erro
+    // geométrico (no espaço do objeto) acumulado até ela.
+    struct ChunkLevel {
+        int firstTriangle = 0, triangleCount = 0;
+        float error = 0.0f;
+    };
+
+    // Faixa contígua de triângulos do IBO (ordem espacial) testada a cada frame antes de ser
+    // enviada: caixa envolvente para o frustum e cone de normais para o teste de costas.
+    struct MeshChunk {
+        int firstTriangle = 0, triangleCount = 0;
+        std::array<float, 3> boxMin{}, boxMax{};
+        std::array<float, 3> coneAxis{}; // Média das normais (unitária)
+        float coneAngle = -1.0f; // Maior desvio de uma normal para o eixo (rad); < 0 = sem cone
+        std::vector<ChunkLevel> levels; // Níveis simplificados (rebuildLod), do mais fino ao mais grosso
+    };
+
+    // Trecho do IBO das faces no formato compacto (ver ObjectQuantization.cpp): triângulos cujos
+    // vértices cabem numa janela de 65536 índices vão em 16 bits, relativos a baseVertex.
+    struct IndexSegment {
+        int firstTriangle = 0, triangleCount = 0;
+        bool wide = false; // 32 bits (índices absolutos)
+        size_t offset = 0; // Em bytes no IBO
+        int baseVertex = 0;
+    };
+
+    struct LodSettings {
+        bool enabled = false;
+        float pixelError = 1.0f; // Maior erro projetado aceito (pixels) ao trocar um bloco por um nível grosso
+    };
+
+    // Quádrica de erro (Garland-Heckbert): soma dos quadrados das distâncias de um ponto a um
+    // conjunto de planos, guardada como a matriz simétrica 4x4 (10 coeficientes).
+    struct Quadric {
+        double q[10] = {}; // aa ab ac ad bb bc bd cc cd dd
+
+        static Quadric plane(double a, double b, double c, double d) {
+            Quadric r;
+            double p[4] = {a, b, c, d};
+            for (int i = 0, k = 0; i < 4; ++i)
+                for (int j = i; j < 4; ++j) r.q[k++] = p[i] * p[j];
+            return r;
+        }
+        Quadric& operator+=(const Quadric& o) {
+            for (int i = 0; i < 10; ++i) q[i] += o.q[i];
+            return *this;
+        }
+        double evaluate(double x, double y, double z) const {
+            return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+                   + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+                   + q[7] * z * z + 2 * q[8] * z + q[9];
+        }
+        // Ponto de custo mínimo (gradiente nulo). false = sistema mal condicionado (região plana ou
+        // cilíndrica: há uma reta/plano inteiro de mínimos) e quem chama escolhe outro ponto.
+        bool minimize(std::array<double, 3>& p) const {
+            double c00 = q[4] * q[7] - q[5] * q[5], c01 = q[2] * q[5] - q[1] * q[7], c02 = q[1] * q[5] - q[2] * q[4];
+            double c11 = q[0] * q[7] - q[2] * q[2], c12 = q[1] * q[2] - q[0] * q[5], c22 = q[0] * q[4] - q[1] * q[1];
+            double det = q[0] * c00 + q[1] * c01 + q[2] * c02;
+            double trace = q[0] + q[4] + q[7];
+            if (std::fabs(det) <= 1e-9 * trace * trace * trace) return false;
+            p[0] = -(c00 * q[3] + c01 * q[6] + c02 * q[8]) / det;
+            p[1] = -(c01 * q[3] + c11 * q[6] + c12 * q[8]) / det;
+            p[2] = -(c02 * q[3] + c12 * q[6] + c22 * q[8]) / det;
+            return true;
+        }
+    };
+
+    struct CullingSettings {
+        bool frustum = true;
+        bool normalCones = false; // As faces são desenhadas dos dois lados: ligar só em malhas fechadas
+        bool occlusion = false; // Hi-Z da profundidade do quadro anterior
+    };
+
+    struct CullingStats {
+        int chunks = 0, visible = 0, frustumCulled = 0, coneCulled = 0, occlusionCulled = 0;
+        int drawCalls = 0; // Faixas contíguas de blocos visíveis (um glDrawElements cada)
+        int triangles = 0; // Enviados no último frame (com o LOD, já nos níveis escolhidos)
+    };
+
+    // Pirâmide de profundidade máxima (Hi-Z) montada na CPU a partir da profundidade de um quadro,
+    // lida por PBO como o buffer de IDs. Vale só para as matrizes com que aquele quadro foi desenhado.
+    struct HiZBuffer {
+        unsigned int pbo = 0;
+        int width = 0, height = 0;
+        std::array<float, 32> matrices{}; // Projeção + ModelView do quadro lido
+        bool pending = false; // Leitura no PBO ainda não convertida em pirâmide
+        bool valid = false;
+        std::vector<std::vector<float>> levels; // levels[0] = W x H; cada nível seguinte = max 2x2
+        std::vector<std::array<int, 2>> sizes;
+    };
+
+    // Simplificação por colapso de arestas (ver ObjectDecimation.cpp). Para no primeiro critério atingido.
+    struct DecimationSettings {
+        int targetFaces = 0; // Triângulos desejados (0 = só o limite de erro)
+        float maxError = 0.0f; // Maior desvio (unidades do modelo) aceito num colapso (0 = sem limite)
+        bool preserveBoundary = true; // Vértices de borda (arestas com uma face) não se movem
+        bool preserveGroups = true; // Idem para a fronteira entre grupos (face_cells_)
+    };
+
+    struct DecimationStats {
+        size_t facesBefore = 0, facesAfter = 0, verticesBefore = 0, verticesAfter = 0;
+        int rounds = 0;
+        float maxError = 0.0f; // Maior desvio (raiz do custo QEM) dos colapsos feitos
+        double seconds = 0.0;
+    };
+
+    // Passadas do desenho medidas pelo painel de tempos (ver ObjectProfiling.cpp)
+    enum RenderPass { PASS_FACES = 0, PASS_EDGES, PASS_VERTICES, PASS_TEXTURES, PASS_PICKING, PASS_COUNT };
+
+    // Tempos e volume de trabalho de um quadro (até endFrameTimings).
+    struct FrameTimings {
+        std::array<double, PASS_COUNT> gpuMs{}; // Timer queries: último quadro com resultado pronto
+        std::array<double, PASS_COUNT> cpuMs{}; // Submissão dos comandos de cada passada
+        bool gpuValid = false; // false = sem timer queries (ou ainda sem resultado)
+        double rebuildMs = 0.0; // Reenvios e reconstruções na CPU (buffers, blocos, LOD, lotes de textura)
+        double cullMs = 0.0; // Descarte por blocos (ObjectCulling.cpp)
+        size_t uploadBytes = 0; // Enviados à GPU (glBufferData/SubData, mapeamentos, texturas)
+        int triangles = 0, lines = 0, points = 0, drawCalls = 0;
+    };
+
+    // Timer queries (GL_TIME_ELAPSED) em anel de alguns quadros: cada resultado é lido quando a
+    // GPU o tem pronto, sem esperar, então os tempos de GPU chegam com até FRAMES quadros de atraso.
+    struct GpuTimers {
+        static const int FRAMES = 3;
+        int state = 0; // 0 = não tentado, 1 = pronto, -1 = sem suporte
+        int frame = 0;
+        std::array<std::array<unsigned int, PASS_COUNT>, FRAMES> queries{};
+        std::array<std::array<bool, PASS_COUNT>, FRAMES> issued{};
+        std::array<double, PASS_COUNT> latestMs{};
+        bool hasResult = false;
+    };
+
+    // Cronômetro de CPU: soma em 'target' o tempo até o fim do escopo.
+    struct ScopedCpuTimer {
+        explicit ScopedCpuTimer(double& target) : target_(target), start_(std::chrono::steady_clock::now()) {}
+        ~ScopedCpuTimer() {
+            target_ += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+        }
+        double& target_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Renderizador core profile: programas GLSL 3.30 e VAOs sobre os mesmos VBOs do caminho
+    // legado; a câmera chega por uniform em vez da pilha de matrizes do pipeline fixo.
+    struct CoreRenderer {
+        int state = 0; // 0 = não tentado, 1 = pronto, -1 = sem suporte (pipeline fixo)
+        unsigned int faceProgram = 0, wireProgram = 0, textureProgram = 0;
+        unsigned int meshVao = 0, edgeVao = 0, textureVao = 0; // Faces e pontos / arestas / lotes de textura
+        bool meshVaoReady = false, textureVaoReady = false;
+        int faceMvp = -1, faceUseAO = -1, faceTriangleBase = -1;
+        // Faces + wireframe em passada única (geometry shader calcula a distância às arestas)
+        unsigned int faceWireProgram = 0;
+        int faceWireMvp = -1, faceWireUseAO = -1, faceWireViewport = -1, faceWireEdgeColor = -1, faceWireLineWidth = -1;
+        int faceWireTriangleBase = -1, faceWireLodBase = -1;
+        int wireMvp = -1, wireColor = -1, wirePointSize = -1, wireUseVertexColor = -1, wireSelectedOnly = -1;
+        int textureMvp = -1;
+    };
+
     class Object {
     public:
         Object(const std::array<float, 3>& position,
@@ -43,12 +255,40 @@ namespace object {
         // --- Métodos de Renderização ---
         void draw(const ColorsMap& colors, bool vertexOnlyMode, bool faceOnlyMode);
         void drawTexturedFaces();
+        // Mesmas camadas de draw() + drawTexturedFaces() pelo renderizador core profile. 'projection'
+        // e 'view' são as matrizes da câmera (sem a do objeto). false = sem OpenGL 3.3: use draw().
+        bool drawCore(const math_utils::Mat4& projection, const math_utils::Mat4& view,
+                      const ColorsMap& colors, bool vertexOnlyMode, bool faceOnlyMode);
         void setShaderProgram(GLuint program) { shaderProgram_ = program; }
+        // Arestas desenhadas no próprio shader das faces (drawCore), sem a passada de GL_LINES.
+        // Ignorado no pipeline fixo e no modo apenas vértices (não há faces para carregá-las).
+        void setSinglePassWireframe(bool enabled) { singlePassWireframe_ = enabled; }
+        bool isSinglePassWireframe() const { return singlePassWireframe_; }
+        // Descarte por blocos no drawCore (o pipeline fixo sempre desenha a malha inteira).
+        void setCullingSettings(const CullingSettings& settings) { cullingSettings_ = settings; }
+        const CullingSettings& getCullingSettings() const { return cullingSettings_; }
+        const CullingStats& getCullingStats() const { return cullingStats_; }
+        // Níveis de detalhe por bloco (drawCore). A hierarquia é montada na primeira vez que é usada
+        // e refeita a cada mudança de geometria; o picking continua na malha completa.
+        void setLodSettings(const LodSettings& settings) { lodSettings_ = settings; }
+        const LodSettings& getLodSettings() const { return lodSettings_; }
         void updateVBOs();
+        // Painel de tempos: o display fecha cada quadro com endFrameTimings. Tempos de CPU, contagens
+        // e bytes enviados são sempre medidos; as timer queries só com o perfilamento ligado.
+        void setProfilingEnabled(bool enabled) { profiling_ = enabled; }
+        bool isProfilingEnabled() const { return profiling_; }
+        void endFrameTimings();
+        const FrameTimings& getFrameTimings() const { return frameTimings_; }
 
         // --- Métodos de Picking ---
         int pickFace(int mouseX, int mouseY, const int viewport[4]) const;
         int pickVertex(int mouseX, int mouseY, const int viewport[4]) const;
+        // Faces (ou vértices) visíveis dentro de um polígono na tela (retângulo ou laço, em pixels
+        // da janela, Y para baixo), lidas do buffer de IDs. false = buffer indisponível para a vista.
+        bool pickRegion(const std::vector<std::array<float, 2>>& polygon, const int viewport[4], bool vertices,
+                        std::vector<int>& ids) const;
+        // Adiciona faces e vértices à seleção de uma vez (um único reenvio de cores no próximo frame).
+        void addToSelection(const std::vector<int>& faces, const std::vector<int>& vertices);
 
         // --- Métodos de Edição e Seleção ---
         void setFaceColor(int faceIndex, const Color& color);
@@ -71,6 +311,11 @@ namespace object {
         void editVertexCoordinates(int vertexIndex);
         void updateConnectivity();
 
+        // Reduz a malha por colapsos de aresta (QEM) em paralelo. Polígonos viram triângulos; cores,
+        // texturas e seleção voltam ao padrão. Funciona sem contexto OpenGL (os buffers são refeitos
+        // no próximo desenho).
+        DecimationStats decimate(const DecimationSettings& settings);
+
         // --- Métodos de Textura ---
         void applyTextureToSelectedFaces(const std::string& filepath);
 
@@ -79,6 +324,11 @@ namespace object {
         const std::vector<std::vector<unsigned int>>& getFaces() const { return faces_; }
         const std::vector<std::pair<unsigned int, unsigned int>>& getEdges() const { return edges_; }
         const std::vector<unsigned int>& getFaceCells() const { return face_cells_; }
+        const std::array<float, 3>& getPosition() const { return position_; }
+        float getScale() const { return scale_; }
+        // Muda a cada edição de vértices/faces e é única entre objetos: estruturas derivadas
+        // fora do objeto (ex.: a BVH do picking por raio) comparam-na para saber se estão velhas.
+        unsigned int getGeometryVersion() const { return geometryVersion_; }
 
         int getCurrentIndex(int originalIndex) const;
 
@@ -92,20 +342,79 @@ namespace object {
         const std::map<int, std::vector<Vec2>>& getFaceUvMap() const;
 
         std::vector<std::pair<unsigned int, unsigned int>> calculateEdges(const std::vector<std::vector<unsigned int>>& faces);
-        std::vector<std::array<unsigned int, 3>> triangulateFaces(const std::vector<std::vector<unsigned int>>& faces) const;
+        // Triangulação em leque em cache, refeita apenas quando a topologia muda.
+        // Compartilhada pelo desenho, pelo picking e pela exportação para o Path Tracer:
+        // - getTriangleIndices: 3 índices de vértice por triângulo (o mesmo conteúdo do IBO)
+        // - getTriangleToFace: face dona de cada triângulo
+        // - getFaceTriangles: faixa [primeiro, fim) de cada face (tamanho F); as faces seguem a ordem
+        //   espacial (Morton), não a do arquivo, e o k-ésimo triângulo da face usa os cantos (0, k+1, k+2)
+        const std::vector<unsigned int>& getTriangleIndices() const { return face_index_array_; }
+        const std::vector<int>& getTriangleToFace() const { return triangleToFace_; }
+        const std::vector<std::array<int, 2> >& getFaceTriangles() const { return faceTriangles_; }
         void setTransparentMaterialForSelectedFaces(bool enable, float ior);
         bool isFaceTransparent(int faceIndex) const;
         void resetSelectedFacesToDefault();
 
+        // --- Oclusão Ambiente (AO) ---
+        // Valor por vértice em [0, 1] (1 = totalmente exposto; -1 = ainda não calculado).
+        // Quando habilitada, modula a cor das faces no rasterizador.
+        void setVertexAO(const std::vector<float>& ao);
+        const std::vector<float>& getVertexAO() const { return vertexAO_; }
+        void setAOEnabled(bool enabled) { aoEnabled_ = enabled; }
+        bool isAOEnabled() const { return aoEnabled_; }
+        // Caixa que envolve a geometria alterada desde o último bake (false = nada mudou).
+        bool getAODirtyRegion(std::array<float, 3>& minP, std::array<float, 3>& maxP) const;
+        void clearAODirtyRegion() { aoDirty_ = false; }
+
     private:
+        void rebuildTriangulation();
+        void markGeometryChanged();
         void setupVBOs();
+        void uploadEdgeIndices();
+        void rebuildChunks();
+        void fitChunkBounds(MeshChunk& chunk, const unsigned int* indices) const;
+        void rebuildLod();
+        void uploadQuantizedPositions();
+        void uploadTriangleIndices(bool withLod);
+        int drawTriangleRange(int first, int count, GLint triangleBaseLocation) const;
+        void cullChunks(const math_utils::Mat4& projection, const math_utils::Mat4& modelView,
+                        std::vector<std::pair<int, int>>& ranges);
+        bool resolveHiZ(const std::array<float, 32>& matrices);
+        bool isOccluded(const MeshChunk& chunk, const math_utils::Mat4& mvp) const;
+        void readBackDepth(const math_utils::Mat4& projection, const math_utils::Mat4& modelView);
+        void uploadFaceColors();
+        void uploadDirtyRanges();
+        void syncGpuBuffers();
+        void syncVertexSelection();
+        bool initPickProgram();
+        void updatePickBuffer(const math_utils::Mat4& projection, const math_utils::Mat4& modelView);
+        bool resolvePickBuffer(const int viewport[4]) const;
+        bool lookupPickBuffer(int mouseX, int mouseY, const int viewport[4], bool vertices, int& id) const;
+        bool initFaceProgram();
         void drawFacesVBO(const Color& defaultColor, bool vertexOnlyMode);
+        void drawFacesImmediate(const Color& defaultColor);
         void drawEdgesVBO(const Color& color);
-        void drawVerticesVBO(const Color& defaultColor);
+        void drawVerticesVBO();
+        void setVertexDefaultColor(const Color& color);
+        void rebuildTextureBatches();
+        void syncTextureMask();
+        bool initCoreRenderer();
+        void setupCoreVertexArrays();
+        void drawTexturedFacesCore(const math_utils::Mat4& mvp);
+        void beginPass(RenderPass pass);
+        void endPass(RenderPass pass);
+        void countUpload(size_t bytes) { currentTimings_.uploadBytes += bytes; }
 
         std::vector<std::vector<int>> computeVertexToFaces() const;
         std::vector<std::vector<int>> computeFaceAdjacency() const;
         GLuint loadTexture(const std::string& filepath);
+        void markAODirty(const std::array<float, 3>& p);
+        void markAODirtyAroundVertex(unsigned int vertexIndex);
+
+        std::vector<float> vertexAO_;
+        bool aoEnabled_ = false;
+        bool aoDirty_ = false;
+        std::array<float, 3> aoDirtyMin_{}, aoDirtyMax_{};
 
         std::string filename_;
         std::array<float, 3> position_;
@@ -124,13 +433,73 @@ namespace object {
         unsigned int ibo_edges_ = 0;
         GLuint shaderProgram_ = 0;
 
-        std::vector<float> vertex_array_;
+        // Faces em modo retido: cor por face lida no shader via gl_PrimitiveID
+        // (triângulo -> face -> cor, ambos em texture buffers) e AO como atributo por vértice.
+        unsigned int vbo_ao_ = 0;
+        unsigned int tbo_triangle_face_ = 0, tex_triangle_face_ = 0;
+        unsigned int tbo_face_colors_ = 0, tex_face_colors_ = 0;
+        unsigned int tbo_face_triangles_ = 0, tex_face_triangles_ = 0; // faceTriangles_ (wireframe em passada única)
+        int faceProgramState_ = 0; // 0 = não tentado, 1 = pronto, -1 = sem suporte (modo imediato)
+        GLint aoAttribLocation_ = -1, useAOLocation_ = -1;
+        bool geometryDirty_ = false; // Vértices/faces mudaram: reenviar os buffers
+        bool singlePassWireframe_ = false;
+        bool edgeIboSinglePass_ = false; // O IBO de arestas guarda só as arestas fora de triângulos
+        unsigned int geometryVersion_ = 0;
+        DirtyRanges faceColorsDirty_; // Faces com cor alterada (seleção, material)
+        DirtyRanges vertexAODirty_; // Vértices com AO alterada (bake incremental)
+
+        // Pontos dos vértices: cor RGBA8 por vértice, com o bit de seleção no alfa (255 = selecionado).
+        // A seleção desenhada é comparada à atual a cada frame; só os vértices que mudaram são reenviados.
+        unsigned int vbo_vertex_colors_ = 0;
+        DirtyRanges vertexColorsDirty_;
+        Color vertexDefaultColor_{0.0f, 0.0f, 0.0f}; // Pontos sem cor em vertexColors
+        std::vector<unsigned char> vertexSelected_;
+        std::vector<int> drawnSelectedVertices_;
+
+        // Faces texturizadas: triângulos (posição + UV intercalados) agrupados por textura num único VBO,
+        // refeito só quando a atribuição de texturas ou a geometria mudam; um glDrawArrays por textura.
+        // Faces selecionadas somem pela máscara (alfa 0 por canto), sem refazer os lotes.
+        struct TextureBatch {
+            GLuint texture;
+            GLint first; // Primeiro canto no VBO
+            GLsizei count;
+        };
+        unsigned int vbo_textured_ = 0, vbo_textured_mask_ = 0;
+        std::vector<TextureBatch> textureBatches_;
+        std::vector<int> texturedFaceFirstCorner_; // Face -> primeiro canto no VBO (-1 = sem textura)
+        std::vector<unsigned char> texturedMask_; // RGBA8 por canto (branco; alfa 0 = face selecionada)
+        std::vector<int> drawnMaskedFaces_; // Seleção aplicada na máscara enviada
+        DirtyRanges texturedMaskDirty_;
+        bool textureBatchesDirty_ = true;
+
+        CoreRenderer core_;
+        std::vector<MeshChunk> chunks_;
+        CullingSettings cullingSettings_;
+        CullingStats cullingStats_;
+        HiZBuffer hiZ_;
+        LodSettings lodSettings_;
+        std::vector<unsigned int> lodIndices_; // Níveis simplificados, no IBO das faces depois de face_index_array_
+        std::vector<int> lodTriangleFace_; // Face de origem de cada triângulo do LOD
+        bool lodDirty_ = true;
+        // Formato compacto do renderizador core: posições em 16 bits na caixa de um bloco (caixas no
+        // texture buffer abaixo) e IBO das faces em trechos de 16/32 bits
+        bool compactGeometry_ = false;
+        std::vector<IndexSegment> indexSegments_;
+        unsigned int tbo_chunk_boxes_ = 0, tex_chunk_boxes_ = 0;
+        unsigned int tex_packed_positions_ = 0; // vbo_vertices_ como texture buffer (RGBA16UI)
+        mutable PickBuffer pickBuffer_; // Mutável: a consulta (const) conclui a leitura assíncrona
+        bool profiling_ = false;
+        GpuTimers gpuTimers_;
+        FrameTimings currentTimings_, frameTimings_; // Quadro em andamento / último fechado
+        std::chrono::steady_clock::time_point passStart_;
+
+        // vertices_, edges_ e face_index_array_ vão para os buffers sem cópia intermediária
         std::vector<unsigned int> face_index_array_;
-        std::vector<unsigned int> edge_index_array_;
+        size_t edgeIndexCount_ = 0; // Índices no IBO das arestas (GL_LINES)
+        std::vector<int> triangleToFace_; // Face dona de cada triângulo do IBO (cache da triangulação)
+        std::vector<std::array<int, 2> > faceTriangles_; // Faixa [primeiro, fim) de triângulos de cada face
 
-        mutable std::unordered_map<int, int> faceTriangleMap;
         std::unordered_map<int, int> originalToCurrentIndex;
-        std::vector<std::vector<unsigned int>> facesOriginais;
 
         std::vector<int> selectedFaces;
         std::vector<int> selectedVertices;
@@ -0,0 +1,334 @@
+/*
+ * ======================================================================================
+ * OBJECT CULLING - DESCARTE POR BLOCOS (FRUSTUM, CONE DE NORMAIS E OCLUSÃO)
+ * ======================================================================================
+ * * Com o zoom alto só uma parte da malha aparece na tela, mas todas as faces eram enviadas
+ * à GPU a cada frame. Aqui a malha é dividida em blocos e só os que podem aparecer são
+ * desenhados pelo drawCore.
+ * * 1. BLOCOS (Chunks):
+ * - Faixas contíguas de ~CHUNK_TRIANGLES triângulos da triangulação em cache, cortadas entre
+ * faces. A triangulação segue a curva de Morton dos centroides (rebuildTriangulation), então
+ * cada faixa é um aglomerado compacto da malha, e não uma tira fina na ordem do arquivo.
+ * - Por serem contíguos, o próprio IBO das faces é desenhado em faixas (drawTriangleRange, com
+ * deslocamento), sem cópia reordenada dos índices; blocos visíveis vizinhos viram uma chamada.
+ * - Cada bloco guarda a caixa envolvente e o cone de normais (eixo médio + maior desvio).
+ * - Com o LOD ligado, os níveis simplificados de cada bloco ficam nele mesmo (ver ObjectLod.cpp).
+ * * 2. FRUSTUM: a caixa é testada contra os 6 planos extraídos da MVP (no espaço do objeto).
+ * * 3. CONE DE NORMAIS (opcional): descarta o bloco se TODAS as faces estão de costas para a
+ * câmera. Desligado por padrão: as faces são desenhadas dos dois lados (malhas abertas e
+ * orientação inconsistente são comuns nos arquivos de entrada).
+ * * 4. OCLUSÃO Hi-Z (opcional):
+ * - A profundidade de um quadro é lida por PBO (assíncrona) e vira, na CPU, uma pirâmide de
+ * profundidade MÁXIMA. O bloco é oculto se a sua profundidade mínima projetada passa da
+ * máxima da região que ele cobre.
+ * - A pirâmide só vale para as matrizes com que foi lida: enquanto a câmera e a geometria
+ * não mudam (o caso comum nos redesenhos de seleção/hover), nada que ela esconde pode
+ * aparecer. Com a câmera em movimento, valem apenas frustum e cone.
+ * * ======================================================================================
+ */
+
+#include "object.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace object {
+    // ============================================================
+    // 1. CONSTRUÇÃO DOS BLOCOS
+    // ============================================================
+
+    // Caixa e cone de normais de uma faixa de triângulos (indices = triângulo inicial da faixa).
+    void Object::fitChunkBounds(MeshChunk &chunk, const unsigned int *indices) const {
+        chunk.boxMin = {1e30f, 1e30f, 1e30f};
+        chunk.boxMax = {-1e30f, -1e30f, -1e30f};
+        chunk.coneAngle = -1.0f;
+
+        // Caixa e normais unitárias (triângulos degenerados não entram no cone)
+        std::vector<std::array<float, 3> > normals;
+        std::array<float, 3> sum = {0.0f, 0.0f, 0.0f};
+        for (int t = 0; t < chunk.triangleCount; ++t) {
+            const auto &a = vertices_[indices[t * 3 + 0]];
+            const auto &b = vertices_[indices[t * 3 + 1]];
+            const auto &c = vertices_[indices[t * 3 + 2]];
+            for (const auto *p: {&a, &b, &c})
+                for (int k = 0; k < 3; ++k) {
+                    chunk.boxMin[k] = std::min(chunk.boxMin[k], (*p)[k]);
+                    chunk.boxMax[k] = std::max(chunk.boxMax[k], (*p)[k]);
+                }
+            std::array<float, 3> e1 = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            std::array<float, 3> e2 = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            std::array<float, 3> n = math_utils::cross_product(e1, e2);
+            if (math_utils::norm(n) == 0.0f) continue;
+            n = math_utils::normalize(n);
+            normals.push_back(n);
+            for (int k = 0; k < 3; ++k) sum[k] += n[k];
+        }
+
+        // Cone: eixo = média das normais; ângulo = maior desvio. Só serve abaixo de 90 graus.
+        if (!normals.empty() && math_utils::norm(sum) > 1e-6f) {
+            chunk.coneAxis = math_utils::normalize(sum);
+            float minDot = 1.0f;
+            for (const auto &n: normals)
+                minDot = std::min(minDot, n[0] * chunk.coneAxis[0] + n[1] * chunk.coneAxis[1] + n[2] * chunk.coneAxis[2]);
+            if (minDot > 0.0f) chunk.coneAngle = std::acos(std::min(1.0f, minDot));
+        }
+    }
+
+    // Refeita no setupVBOs (qualquer mudança de geometria): caixas e cones dependem das posições.
+    // A ordem espacial vem da triangulação; aqui só se corta o IBO em faixas.
+    void Object::rebuildChunks() {
+        chunks_.clear();
+        int triCount = static_cast<int>(triangleToFace_.size());
+        for (int first = 0; first < triCount;) {
+            // Uma face nunca se divide entre dois blocos (o LOD simplifica faces inteiras)
+            int end = std::min(first + CHUNK_TRIANGLES, triCount);
+            while (end < triCount && triangleToFace_[end] == triangleToFace_[end - 1]) ++end;
+            MeshChunk chunk;
+            chunk.firstTriangle = first;
+            chunk.triangleCount = end - first;
+            fitChunkBounds(chunk, face_index_array_.data() + static_cast<size_t>(first) * 3);
+            chunks_.push_back(chunk);
+            first = end;
+        }
+
+        // O IBO voltou a ter só a malha completa: o LOD (se ligado) é reenviado no próximo drawCore
+        lodDirty_ = true;
+
+        // Profundidade lida antes da mudança não vale mais
+        hiZ_.valid = false;
+        hiZ_.pending = false;
+        hiZ_.matrices = {};
+    }
+
+    // ============================================================
+    // 2. TESTES POR FRAME
+    // ============================================================
+
+    // Posição da câmera no espaço do objeto: -A^-1 * t, com A = parte 3x3 da ModelView (afim).
+    static std::array<float, 3> eyeInObjectSpace(const math_utils::Mat4 &mv) {
+        std::array<float, 3> c0 = {mv[0], mv[1], mv[2]}, c1 = {mv[4], mv[5], mv[6]}, c2 = {mv[8], mv[9], mv[10]};
+        std::array<float, 3> t = {mv[12], mv[13], mv[14]};
+        // Linhas da inversa = produtos vetoriais das colunas / determinante
+        std::array<float, 3> r0 = math_utils::cross_product(c1, c2);
+        std::array<float, 3> r1 = math_utils::cross_product(c2, c0);
+        std::array<float, 3> r2 = math_utils::cross_product(c0, c1);
+        float det = c0[0] * r0[0] + c0[1] * r0[1] + c0[2] * r0[2];
+        if (std::fabs(det) < 1e-20f) return {0.0f, 0.0f, 0.0f};
+        return {-(r0[0] * t[0] + r0[1] * t[1] + r0[2] * t[2]) / det,
+                -(r1[0] * t[0] + r1[1] * t[1] + r1[2] * t[2]) / det,
+                -(r2[0] * t[0] + r2[1] * t[1] + r2[2] * t[2]) / det};
+    }
+
+    // Caixa contra os planos do frustum (Gribb-Hartmann: linha 4 +- linha i da MVP).
+    static bool boxInFrustum(const math_utils::Mat4 &m, const std::array<float, 3> &lo, const std::array<float, 3> &hi) {
+        for (int i = 0; i < 3; ++i) {
+            for (float sign: {1.0f, -1.0f}) {
+                float plane[4];
+                for (int c = 0; c < 4; ++c) plane[c] = m[c * 4 + 3] + sign * m[c * 4 + i];
+                // Vértice da caixa mais "para dentro" do plano
+                float d = plane[3];
+                for (int k = 0; k < 3; ++k) d += plane[k] * (plane[k] >= 0.0f ? hi[k] : lo[k]);
+                if (d < 0.0f) return false;
+            }
+        }
+        return true;
+    }
+
+    // Todas as normais do cone apontam para longe da câmera em qualquer ponto da esfera
+    // envolvente: ângulo(eixo, centro - olho) + meio-ângulo do cone + raio angular < 90 graus.
+    static bool coneBackFacing(const MeshChunk &chunk, const std::array<float, 3> &eye) {
+        if (chunk.coneAngle < 0.0f) return false;
+        std::array<float, 3> center, v;
+        float radius2 = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            center[k] = 0.5f * (chunk.boxMin[k] + chunk.boxMax[k]);
+            float h = 0.5f * (chunk.boxMax[k] - chunk.boxMin[k]);
+            radius2 += h * h;
+            v[k] = center[k] - eye[k];
+        }
+        float dist = math_utils::norm(v);
+        float radius = std::sqrt(radius2);
+        if (dist <= radius) return false; // Câmera dentro da esfera
+        float cosAxis = (v[0] * chunk.coneAxis[0] + v[1] * chunk.coneAxis[1] + v[2] * chunk.coneAxis[2]) / dist;
+        float axisAngle = std::acos(std::max(-1.0f, std::min(1.0f, cosAxis)));
+        return axisAngle + chunk.coneAngle + std::asin(radius / dist) < 1.5707963f;
+    }
+
+    // Preenche 'ranges' com as faixas (primeiro triângulo, quantidade) a desenhar. Com o LOD,
+    // cada bloco entra no nível mais grosso cujo erro projetado na tela fica abaixo de
+    // lodSettings_.pixelError (nível 0 = a faixa do bloco na malha completa).
+    void Object::cullChunks(const math_utils::Mat4 &projection, const math_utils::Mat4 &modelView,
+                            std::vector<std::pair<int, int> > &ranges) {
+        ranges.clear();
+        cullingStats_ = CullingStats();
+        cullingStats_.chunks = static_cast<int>(chunks_.size());
+
+        // Pixels por unidade do objeto a distância 1 da câmera (a ModelView só tem escala uniforme)
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        float modelScale = math_utils::norm({modelView[0], modelView[1], modelView[2]});
+        float pixelsPerUnit = 0.5f * projection[5] * static_cast<float>(viewport[3]) * modelScale;
+
+        math_utils::Mat4 mvp = math_utils::mat4_multiply(projection, modelView);
+        std::array<float, 3> eye = eyeInObjectSpace(modelView);
+        std::array<float, 32> matrices;
+        std::copy(projection.begin(), projection.end(), matrices.begin());
+        std::copy(modelView.begin(), modelView.end(), matrices.begin() + 16);
+        bool useHiZ = cullingSettings_.occlusion && resolveHiZ(matrices);
+
+        for (const auto &chunk: chunks_) {
+            if (cullingSettings_.frustum && !boxInFrustum(mvp, chunk.boxMin, chunk.boxMax)) {
+                cullingStats_.frustumCulled++;
+                continue;
+            }
+            if (cullingSettings_.normalCones && coneBackFacing(chunk, eye)) {
+                cullingStats_.coneCulled++;
+                continue;
+            }
+            if (useHiZ && isOccluded(chunk, mvp)) {
+                cullingStats_.occlusionCulled++;
+                continue;
+            }
+            cullingStats_.visible++;
+
+            int first = chunk.firstTriangle, count = chunk.triangleCount;
+            if (lodSettings_.enabled && !chunk.levels.empty()) {
+                // Distância (no espaço da câmera) do ponto da esfera envolvente mais próximo
+                float center[3], radius2 = 0.0f;
+                for (int k = 0; k < 3; ++k) {
+                    center[k] = 0.5f * (chunk.boxMin[k] + chunk.boxMax[k]);
+                    float h = 0.5f * (chunk.boxMax[k] - chunk.boxMin[k]);
+                    radius2 += h * h;
+                }
+                float depth = -(modelView[2] * center[0] + modelView[6] * center[1] + modelView[10] * center[2] +
+                                modelView[14]);
+                float distance = depth - std::sqrt(radius2) * modelScale;
+                if (distance > 1e-4f) {
+                    for (const auto &level: chunk.levels) {
+                        if (level.error * pixelsPerUnit / distance > lodSettings_.pixelError) break;
+                        first = level.firstTriangle;
+                        count = level.triangleCount;
+                    }
+                }
+            }
+            cullingStats_.triangles += count;
+
+            // Une ao bloco anterior se for vizinho no IBO
+            if (!ranges.empty() && ranges.back().first + ranges.back().second == first)
+                ranges.back().second += count;
+            else
+                ranges.push_back({first, count});
+        }
+        cullingStats_.drawCalls = static_cast<int>(ranges.size());
+    }
+
+    // ============================================================
+    // 3. OCLUSÃO (PIRÂMIDE Hi-Z DO QUADRO ANTERIOR)
+    // ============================================================
+
+    // Chamado pelo drawCore logo após as faces. Só lê de novo quando a vista mudou desde a última
+    // leitura: com a câmera parada, a profundidade (das faces) não muda.
+    void Object::readBackDepth(const math_utils::Mat4 &projection, const math_utils::Mat4 &modelView) {
+        if (!cullingSettings_.occlusion) return;
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        int w = viewport[2], h = viewport[3];
+        std::array<float, 32> matrices;
+        std::copy(projection.begin(), projection.end(), matrices.begin());
+        std::copy(modelView.begin(), modelView.end(), matrices.begin() + 16);
+        if ((hiZ_.valid || hiZ_.pending) && matrices == hiZ_.matrices && w == hiZ_.width && h == hiZ_.height) return;
+        if (w <= 0 || h <= 0) return;
+
+        if (hiZ_.pbo == 0) glGenBuffers(1, &hiZ_.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, hiZ_.pbo);
+        if (w != hiZ_.width || h != hiZ_.height)
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<size_t>(w) * h * sizeof(float), nullptr, GL_STREAM_READ);
+        glReadPixels(viewport[0], viewport[1], w, h, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        hiZ_.width = w;
+        hiZ_.height = h;
+        hiZ_.matrices = matrices;
+        hiZ_.pending = true;
+        hiZ_.valid = false;
+    }
+
+    // Conclui a leitura pendente e monta a pirâmide. false = não há profundidade desta vista.
+    bool Object::resolveHiZ(const std::array<float, 32> &matrices) {
+        if (matrices != hiZ_.matrices || (!hiZ_.valid && !hiZ_.pending)) return false;
+        if (hiZ_.valid) return true;
+
+        size_t count = static_cast<size_t>(hiZ_.width) * hiZ_.height;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, hiZ_.pbo);
+        const void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, count * sizeof(float), GL_MAP_READ_BIT);
+        if (!data) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            return false;
+        }
+        hiZ_.levels.assign(1, std::vector<float>(count));
+        std::memcpy(hiZ_.levels[0].data(), data, count * sizeof(float));
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        hiZ_.pending = false;
+
+        // Cada nível guarda o máximo do bloco 2x2 abaixo (tamanhos ímpares: a última linha/coluna entra)
+        hiZ_.sizes.assign(1, {hiZ_.width, hiZ_.height});
+        while (hiZ_.sizes.back()[0] > 1 || hiZ_.sizes.back()[1] > 1) {
+            int pw = hiZ_.sizes.back()[0], ph = hiZ_.sizes.back()[1];
+            int w = (pw + 1) / 2, h = (ph + 1) / 2;
+            const std::vector<float> &prev = hiZ_.levels.back();
+            std::vector<float> level(static_cast<size_t>(w) * h);
+            for (int y = 0; y < h; ++y)
+                for (int x = 0; x < w; ++x) {
+                    int x0 = 2 * x, y0 = 2 * y, x1 = std::min(x0 + 1, pw - 1), y1 = std::min(y0 + 1, ph - 1);
+                    level[y * w + x] = std::max(std::max(prev[y0 * pw + x0], prev[y0 * pw + x1]),
+                                                std::max(prev[y1 * pw + x0], prev[y1 * pw + x1]));
+                }
+            hiZ_.levels.push_back(std::move(level));
+            hiZ_.sizes.push_back({w, h});
+        }
+        hiZ_.valid = true;
+        return true;
+    }
+
+    // Projeta a caixa; usa o nível em que o retângulo na tela cobre no máximo 2x2 texels.
+    bool Object::isOccluded(const MeshChunk &chunk, const math_utils::Mat4 &mvp) const {
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, minZ = 1e30f;
+        for (int i = 0; i < 8; ++i) {
+            float p[3] = {(i & 1) ? chunk.boxMax[0] : chunk.boxMin[0],
+                          (i & 2) ? chunk.boxMax[1] : chunk.boxMin[1],
+                          (i & 4) ? chunk.boxMax[2] : chunk.boxMin[2]};
+            float clip[4];
+            for (int r = 0; r < 4; ++r)
+                clip[r] = mvp[r] * p[0] + mvp[4 + r] * p[1] + mvp[8 + r] * p[2] + mvp[12 + r];
+            if (clip[3] <= 1e-5f) return false; // Cruza o plano da câmera: considera visível
+            float x = (clip[0] / clip[3] * 0.5f + 0.5f) * hiZ_.width;
+            float y = (clip[1] / clip[3] * 0.5f + 0.5f) * hiZ_.height;
+            float z = clip[2] / clip[3] * 0.5f + 0.5f;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            minZ = std::min(minZ, z);
+        }
+        if (minZ < 0.0f) return false;
+        int x0 = std::max(0, static_cast<int>(std::floor(minX)));
+        int y0 = std::max(0, static_cast<int>(std::floor(minY)));
+        int x1 = std::min(hiZ_.width - 1, static_cast<int>(std::floor(maxX)));
+        int y1 = std::min(hiZ_.height - 1, static_cast<int>(std::floor(maxY)));
+        if (x0 > x1 || y0 > y1) return false; // Fora da tela: decisão do frustum
+
+        int level = 0;
+        while (level + 1 < static_cast<int>(hiZ_.levels.size()) && ((x1 >> level) - (x0 >> level) > 1 ||
+                                                                    (y1 >> level) - (y0 >> level) > 1))
+            level++;
+        const std::vector<float> &depth = hiZ_.levels[level];
+        int w = hiZ_.sizes[level][0];
+        float maxDepth = 0.0f;
+        for (int y = y0 >> level; y <= (y1 >> level); ++y)
+            for (int x = x0 >> level; x <= (x1 >> level); ++x)
+                maxDepth = std::max(maxDepth, depth[y * w + x]);
+        return minZ > maxDepth;
+    }
+} // namespace object
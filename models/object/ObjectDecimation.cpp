@@ -0,0 +1,444 @@
+/*
+ * ======================================================================================
+ * OBJECT DECIMATION - SIMPLIFICAÇÃO PARALELA POR COLAPSO DE ARESTAS (QEM)
+ * ======================================================================================
+ * * Reduz malhas grandes (600k elementos) para a edição interativa e para a exportação.
+ * * 1. MÉTRICA (Garland-Heckbert):
+ * - Cada vértice acumula a quádrica dos planos dos seus triângulos; colapsar a aresta (u, v)
+ * num ponto p custa (Qu + Qv)(p), a soma dos quadrados das distâncias de p a esses planos.
+ * - p é o mínimo da quádrica (sistema 3x3); se ele não existir ou cair longe da aresta, fica o
+ * melhor entre as pontas e o ponto médio.
+ * * 2. RESTRIÇÕES:
+ * - Vértices de borda, de arestas não-manifold, da fronteira entre grupos (face_cells_) e de
+ * faces de 2 vértices ficam travados: podem absorver um vizinho, mas não se movem.
+ * - Condição de link (a malha continua manifold) e nenhum triângulo vizinho pode virar do avesso.
+ * * 3. PARALELISMO (FILA DE PRIORIDADE PARTICIONADA):
+ * - A cada rodada, os triângulos são distribuídos numa grade espacial. Um vértice é "interior"
+ * à célula se todos os seus triângulos estão nela; só arestas com as duas pontas interiores
+ * na mesma célula colapsam. Um colapso só toca triângulos da própria célula, então as células
+ * rodam em paralelo sem travas, cada uma com a sua fila de prioridade.
+ * - A ordem global é aproximada por um limiar de custo: na rodada só entram colapsos até o k-ésimo
+ * menor custo (k = quantos faltam para o alvo), e um contador atômico impede passar do alvo.
+ * - A grade anda meia célula a cada rodada: quem ficou na fronteira passa a ser interior.
+ * * 4. RESULTADO: triângulos na ordem das faces de origem, vértices compactados e o grupo de cada
+ * triângulo herdado da face original. A gravação é a de sempre (fileio::save_file).
+ * * ======================================================================================
+ */
+
+#include "object.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <queue>
+
+namespace object {
+    static const int DECIMATION_CELL_TRIANGLES = 4096; // Triângulos por célula da grade (por rodada)
+    static const int DECIMATION_MAX_ROUNDS = 200;
+
+    namespace {
+        using Point = std::array<double, 3>;
+
+        struct Candidate {
+            double cost;
+            int a, b, versionA, versionB;
+            bool operator<(const Candidate &o) const { return cost > o.cost; } // Menor custo no topo
+        };
+
+        struct DecimationMesh {
+            std::vector<Point> pos;
+            std::vector<Quadric> quadric;
+            std::vector<char> locked;
+            std::vector<int> version;
+            std::vector<std::vector<int> > vertexTriangles; // Pode conter triângulos mortos (limpos por rodada)
+            std::vector<std::array<int, 3> > tri;
+            std::vector<char> triAlive;
+            std::vector<int> triCell;
+            std::vector<int> vertexCell; // Célula em que o vértice é interior na rodada (-1 = fronteira)
+
+            bool hasVertex(int t, int v) const { return tri[t][0] == v || tri[t][1] == v || tri[t][2] == v; }
+
+            void neighbors(int v, std::vector<int> &out) const {
+                out.clear();
+                for (int t: vertexTriangles[v])
+                    if (triAlive[t])
+                        for (int w: tri[t])
+                            if (w != v) out.push_back(w);
+                std::sort(out.begin(), out.end());
+                out.erase(std::unique(out.begin(), out.end()), out.end());
+            }
+
+            // Ponto do colapso e custo. Ponta travada = o ponto é ela.
+            double evaluate(int a, int b, Point &p) const {
+                Quadric q = quadric[a];
+                q += quadric[b];
+                const Point &pa = pos[a], &pb = pos[b];
+                if (locked[a]) p = pa;
+                else if (locked[b]) p = pb;
+                else {
+                    Point mid = {0.5 * (pa[0] + pb[0]), 0.5 * (pa[1] + pb[1]), 0.5 * (pa[2] + pb[2])};
+                    double len2 = 0.0, off2 = 0.0;
+                    bool solved = q.minimize(p);
+                    if (solved) {
+                        for (int k = 0; k < 3; ++k) {
+                            len2 += (pa[k] - pb[k]) * (pa[k] - pb[k]);
+                            off2 += (p[k] - mid[k]) * (p[k] - mid[k]);
+                        }
+                    }
+                    if (!solved || off2 > len2) {
+                        // Sem mínimo único (ou longe demais): a melhor das três opções
+                        p = mid;
+                        double best = q.evaluate(mid[0], mid[1], mid[2]);
+                        for (const Point *c: {&pa, &pb}) {
+                            double cost = q.evaluate((*c)[0], (*c)[1], (*c)[2]);
+                            if (cost < best) {
+                                best = cost;
+                                p = *c;
+                            }
+                        }
+                    }
+                }
+                return std::max(0.0, q.evaluate(p[0], p[1], p[2]));
+            }
+
+            bool collapsible(int a, int b) const {
+                int cell = vertexCell[a];
+                return cell >= 0 && vertexCell[b] == cell && !(locked[a] && locked[b]);
+            }
+
+            // Condição de link e teste de dobra (normal nova contra a antiga)
+            bool valid(int a, int b, const Point &p, std::vector<int> &na, std::vector<int> &nb,
+                       std::vector<int> &common) const {
+                int shared = 0;
+                for (int t: vertexTriangles[a]) if (triAlive[t] && hasVertex(t, b)) shared++;
+                if (shared == 0) return false;
+                neighbors(a, na);
+                neighbors(b, nb);
+                common.clear();
+                std::set_intersection(na.begin(), na.end(), nb.begin(), nb.end(), std::back_inserter(common));
+                if (static_cast<int>(common.size()) != shared) return false;
+
+                for (int moved: {a, b}) {
+                    int other = moved == a ? b : a;
+                    for (int t: vertexTriangles[moved]) {
+                        if (!triAlive[t] || hasVertex(t, other)) continue;
+                        Point v[3], w[3];
+                        for (int k = 0; k < 3; ++k) {
+                            v[k] = w[k] = pos[tri[t][k]];
+                            if (tri[t][k] == moved) w[k] = p;
+                        }
+                        Point before = cross(v), after = cross(w);
+                        double lb = length(before), la = length(after);
+                        if (lb == 0.0) continue; // Já era degenerado
+                        if (before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.2 * lb * la)
+                            return false;
+                    }
+                }
+                return true;
+            }
+
+            static Point cross(const Point *v) {
+                Point e1 = {v[1][0] - v[0][0], v[1][1] - v[0][1], v[1][2] - v[0][2]};
+                Point e2 = {v[2][0] - v[0][0], v[2][1] - v[0][1], v[2][2] - v[0][2]};
+                return {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            }
+
+            static double length(const Point &v) { return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]); }
+
+            // Colapsa (a, b) em p. Sobrevive a ponta travada (ou a); devolve triângulos removidos.
+            int collapse(int a, int b, const Point &p) {
+                int keep = locked[b] ? b : a, gone = keep == a ? b : a;
+                int removed = 0;
+                for (int t: vertexTriangles[gone]) {
+                    if (!triAlive[t]) continue;
+                    if (hasVertex(t, keep)) {
+                        triAlive[t] = 0;
+                        removed++;
+                    } else {
+                        for (int k = 0; k < 3; ++k) if (tri[t][k] == gone) tri[t][k] = keep;
+                        vertexTriangles[keep].push_back(t);
+                    }
+                }
+                vertexTriangles[gone].clear();
+                auto &list = vertexTriangles[keep];
+                list.erase(std::remove_if(list.begin(), list.end(), [&](int t) { return !triAlive[t]; }), list.end());
+                pos[keep] = p;
+                quadric[keep] += quadric[gone];
+                locked[keep] = locked[keep] || locked[gone];
+                version[keep]++;
+                version[gone]++;
+                vertexCell[gone] = -1;
+                return removed;
+            }
+        };
+    }
+
+    DecimationStats Object::decimate(const DecimationSettings &settings) {
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        DecimationStats stats;
+        stats.facesBefore = faces_.size();
+        stats.verticesBefore = vertices_.size();
+
+        // ============================================================
+        // 1. TRIANGULAÇÃO, TRAVAS E QUÁDRICAS
+        // ============================================================
+        DecimationMesh mesh;
+        int nv = static_cast<int>(vertices_.size());
+        mesh.pos.resize(nv);
+        for (int v = 0; v < nv; ++v) mesh.pos[v] = {vertices_[v][0], vertices_[v][1], vertices_[v][2]};
+        mesh.quadric.resize(nv);
+        mesh.locked.assign(nv, 0);
+        mesh.version.assign(nv, 0);
+        mesh.vertexTriangles.resize(nv);
+        mesh.vertexCell.assign(nv, -1);
+
+        bool hasGroups = face_cells_.size() == faces_.size();
+        std::vector<int> triFace; // Face de origem de cada triângulo
+        std::vector<int> keptFaces; // Faces com menos de 3 vértices: ficam como estão
+        for (int f = 0; f < static_cast<int>(faces_.size()); ++f) {
+            const auto &face = faces_[f];
+            if (face.size() < 3) {
+                keptFaces.push_back(f);
+                for (unsigned int v: face) mesh.locked[v] = 1;
+                continue;
+            }
+            for (size_t k = 1; k + 1 < face.size(); ++k) {
+                int a = face[0], b = face[k], c = face[k + 1];
+                if (a == b || b == c || a == c) continue;
+                mesh.tri.push_back({a, b, c});
+                triFace.push_back(f);
+            }
+        }
+        int nt = static_cast<int>(mesh.tri.size());
+        mesh.triAlive.assign(nt, 1);
+        mesh.triCell.assign(nt, -1);
+        for (int t = 0; t < nt; ++t)
+            for (int v: mesh.tri[t]) mesh.vertexTriangles[v].push_back(t);
+
+        // Arestas ordenadas: borda (1 triângulo), não-manifold (> 2) e fronteira de grupo travam as pontas
+        std::vector<std::pair<uint64_t, int> > edgeUse;
+        edgeUse.reserve(static_cast<size_t>(nt) * 3);
+        for (int t = 0; t < nt; ++t)
+            for (int k = 0; k < 3; ++k) {
+                uint64_t a = mesh.tri[t][k], b = mesh.tri[t][(k + 1) % 3];
+                edgeUse.push_back({std::min(a, b) << 32 | std::max(a, b), t});
+            }
+        std::sort(edgeUse.begin(), edgeUse.end());
+        for (size_t i = 0; i < edgeUse.size();) {
+            size_t j = i;
+            bool mixedGroups = false;
+            while (j < edgeUse.size() && edgeUse[j].first == edgeUse[i].first) {
+                if (hasGroups && face_cells_[triFace[edgeUse[j].second]] != face_cells_[triFace[edgeUse[i].second]])
+                    mixedGroups = true;
+                ++j;
+            }
+            size_t count = j - i;
+            if (count > 2 || (count == 1 && settings.preserveBoundary) || (mixedGroups && settings.preserveGroups)) {
+                mesh.locked[edgeUse[i].first >> 32] = 1;
+                mesh.locked[edgeUse[i].first & 0xFFFFFFFFu] = 1;
+            }
+            i = j;
+        }
+        std::vector<std::pair<uint64_t, int> >().swap(edgeUse);
+
+#pragma omp parallel for schedule(static)
+        for (int v = 0; v < nv; ++v) {
+            for (int t: mesh.vertexTriangles[v]) {
+                const auto &tr = mesh.tri[t];
+                Point corners[3] = {mesh.pos[tr[0]], mesh.pos[tr[1]], mesh.pos[tr[2]]};
+                Point n = DecimationMesh::cross(corners);
+                double len = DecimationMesh::length(n);
+                if (len == 0.0) continue;
+                for (double &c: n) c /= len;
+                mesh.quadric[v] += Quadric::plane(n[0], n[1], n[2],
+                                                  -(n[0] * corners[0][0] + n[1] * corners[0][1] + n[2] * corners[0][2]));
+            }
+        }
+
+        // ============================================================
+        // 2. RODADAS DE COLAPSOS EM PARALELO
+        // ============================================================
+        int target = std::max(0, settings.targetFaces - static_cast<int>(keptFaces.size()));
+        if (settings.targetFaces <= 0 && settings.maxError <= 0.0f) target = nt; // Nenhum critério: nada a fazer
+        double maxCost = settings.maxError > 0.0f ? static_cast<double>(settings.maxError) * settings.maxError
+                                                  : std::numeric_limits<double>::infinity();
+        Point lo = {1e300, 1e300, 1e300}, hi = {-1e300, -1e300, -1e300};
+        for (const auto &p: mesh.pos)
+            for (int k = 0; k < 3; ++k) {
+                lo[k] = std::min(lo[k], p[k]);
+                hi[k] = std::max(hi[k], p[k]);
+            }
+
+        int aliveTriangles = nt;
+        int totalRemoved = 0;
+        double worstCost = 0.0;
+        int idleRounds = 0;
+        for (int round = 0; round < DECIMATION_MAX_ROUNDS && aliveTriangles > target && idleRounds < 2; ++round) {
+            stats.rounds++;
+
+            // a. Grade: células com ~DECIMATION_CELL_TRIANGLES; nas rodadas ímpares, deslocada meia célula
+            int perAxis = std::max(1, static_cast<int>(std::cbrt(aliveTriangles / double(DECIMATION_CELL_TRIANGLES))));
+            double shift = (round % 2) ? 0.5 : 0.0;
+            int cellsPerAxis = perAxis + 1;
+#pragma omp parallel for schedule(static)
+            for (int t = 0; t < nt; ++t) {
+                if (!mesh.triAlive[t]) continue;
+                int cell = 0;
+                for (int k = 2; k >= 0; --k) {
+                    double c = (mesh.pos[mesh.tri[t][0]][k] + mesh.pos[mesh.tri[t][1]][k] + mesh.pos[mesh.tri[t][2]][k]) / 3.0;
+                    double extent = hi[k] - lo[k];
+                    int i = extent > 0.0 ? static_cast<int>((c - lo[k]) / extent * perAxis + shift) : 0;
+                    cell = cell * cellsPerAxis + std::min(std::max(i, 0), perAxis);
+                }
+                mesh.triCell[t] = cell;
+            }
+
+            // b. Vértices interiores de cada célula (listas de triângulos já sem os mortos)
+            int cellCount = cellsPerAxis * cellsPerAxis * cellsPerAxis;
+#pragma omp parallel for schedule(static)
+            for (int v = 0; v < nv; ++v) {
+                auto &list = mesh.vertexTriangles[v];
+                list.erase(std::remove_if(list.begin(), list.end(), [&](int t) { return !mesh.triAlive[t]; }), list.end());
+                int cell = list.empty() ? -1 : mesh.triCell[list[0]];
+                for (int t: list) if (mesh.triCell[t] != cell) cell = -1;
+                mesh.vertexCell[v] = cell;
+            }
+            std::vector<std::vector<int> > cellVertices(cellCount);
+            for (int v = 0; v < nv; ++v)
+                if (mesh.vertexCell[v] >= 0) cellVertices[mesh.vertexCell[v]].push_back(v);
+
+            // c. Custos das arestas candidatas e limiar da rodada (k-ésimo menor custo)
+            std::vector<std::vector<Candidate> > cellCandidates(cellCount);
+#pragma omp parallel for schedule(dynamic, 1)
+            for (int c = 0; c < cellCount; ++c) {
+                std::vector<int> around;
+                Point p;
+                for (int a: cellVertices[c]) {
+                    mesh.neighbors(a, around);
+                    for (int b: around)
+                        if (b > a && mesh.collapsible(a, b))
+                            cellCandidates[c].push_back({mesh.evaluate(a, b, p), a, b, mesh.version[a], mesh.version[b]});
+                }
+            }
+            std::vector<double> costs;
+            for (const auto &list: cellCandidates)
+                for (const auto &cand: list) if (cand.cost <= maxCost) costs.push_back(cand.cost);
+            if (costs.empty()) {
+                idleRounds++;
+                continue;
+            }
+            // Cada colapso interior remove 2 triângulos; no máximo metade das candidatas por rodada
+            size_t wanted = static_cast<size_t>(std::max(1, (aliveTriangles - target + 1) / 2));
+            wanted = std::min(wanted, std::max<size_t>(1, costs.size() / 2));
+            std::nth_element(costs.begin(), costs.begin() + (wanted - 1), costs.end());
+            double threshold = std::min(maxCost, costs[wanted - 1]);
+
+            // d. Colapsos por célula, em paralelo, cada uma com a sua fila
+            std::atomic<int> removedTotal(0);
+            int budget = aliveTriangles - target;
+            double roundWorst = 0.0;
+#pragma omp parallel for schedule(dynamic, 1) reduction(max:roundWorst)
+            for (int c = 0; c < cellCount; ++c) {
+                std::priority_queue<Candidate> heap;
+                for (const auto &cand: cellCandidates[c]) if (cand.cost <= threshold) heap.push(cand);
+                std::vector<Candidate>().swap(cellCandidates[c]);
+                std::vector<int> na, nb, common;
+                Point p;
+                while (!heap.empty() && removedTotal.load(std::memory_order_relaxed) < budget) {
+                    Candidate cand = heap.top();
+                    heap.pop();
+                    if (cand.versionA != mesh.version[cand.a] || cand.versionB != mesh.version[cand.b]) continue;
+                    if (!mesh.collapsible(cand.a, cand.b)) continue;
+                    double cost = mesh.evaluate(cand.a, cand.b, p);
+                    if (!mesh.valid(cand.a, cand.b, p, na, nb, common)) continue;
+
+                    int keep = mesh.locked[cand.b] ? cand.b : cand.a;
+                    removedTotal.fetch_add(mesh.collapse(cand.a, cand.b, p), std::memory_order_relaxed);
+                    roundWorst = std::max(roundWorst, cost);
+
+                    // Arestas do sobrevivente com custo novo
+                    mesh.neighbors(keep, na);
+                    for (int w: na) {
+                        if (!mesh.collapsible(keep, w)) continue;
+                        double wcost = mesh.evaluate(keep, w, p);
+                        if (wcost <= threshold) heap.push({wcost, keep, w, mesh.version[keep], mesh.version[w]});
+                    }
+                }
+            }
+            int removed = removedTotal.load();
+            aliveTriangles -= removed;
+            totalRemoved += removed;
+            worstCost = std::max(worstCost, roundWorst);
+            idleRounds = removed == 0 ? idleRounds + 1 : 0;
+        }
+
+        // ============================================================
+        // 3. MALHA RESULTANTE
+        // ============================================================
+        if (totalRemoved == 0) {
+            // Já no alvo (ou nada colapsável): a malha original fica intacta, sem triangular
+            stats.facesAfter = stats.facesBefore;
+            stats.verticesAfter = stats.verticesBefore;
+            stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            return stats;
+        }
+        std::vector<int> remap(nv, -1);
+        std::vector<std::array<float, 3> > newVertices;
+        auto mapVertex = [&](int v) {
+            if (remap[v] < 0) {
+                remap[v] = static_cast<int>(newVertices.size());
+                newVertices.push_back({static_cast<float>(mesh.pos[v][0]), static_cast<float>(mesh.pos[v][1]),
+                                       static_cast<float>(mesh.pos[v][2])});
+            }
+            return static_cast<unsigned int>(remap[v]);
+        };
+        // Na ordem das faces de origem (os triângulos já estão nela; as faces mantidas entram no lugar)
+        std::vector<std::vector<unsigned int> > newFaces;
+        std::vector<unsigned int> newCells;
+        size_t kept = 0;
+        for (int t = 0; t <= nt; ++t) {
+            int face = t < nt ? triFace[t] : static_cast<int>(faces_.size());
+            while (kept < keptFaces.size() && keptFaces[kept] <= face) {
+                std::vector<unsigned int> f;
+                for (unsigned int v: faces_[keptFaces[kept]]) f.push_back(mapVertex(v));
+                newFaces.push_back(f);
+                if (hasGroups) newCells.push_back(face_cells_[keptFaces[kept]]);
+                kept++;
+            }
+            if (t == nt || !mesh.triAlive[t]) continue;
+            newFaces.push_back({mapVertex(mesh.tri[t][0]), mapVertex(mesh.tri[t][1]), mapVertex(mesh.tri[t][2])});
+            if (hasGroups) newCells.push_back(face_cells_[face]);
+        }
+
+        // Estado derivado da malha antiga volta ao padrão (como numa malha recém-carregada)
+        vertices_ = std::move(newVertices);
+        faces_ = std::move(newFaces);
+        face_cells_ = std::move(newCells);
+        vertexColors.assign(vertices_.size(), Color{0.0f, 0.0f, 0.0f});
+        faceColors.assign(faces_.size(), Color{0.8f, 0.8f, 0.8f});
+        vertexAO_.clear(); // Bake completo no próximo pedido
+        face_texture_map_.clear();
+        face_uv_map_.clear();
+        transparent_faces_.clear();
+        selectedFaces.clear();
+        selectedVertices.clear();
+        selectedFace = -1;
+        selectedVertex = -1;
+        originalToCurrentIndex.clear();
+        for (size_t i = 0; i < faces_.size(); ++i)
+            originalToCurrentIndex[static_cast<int>(i)] = static_cast<int>(i);
+
+        updateConnectivity();
+        rebuildTriangulation();
+        markGeometryChanged(); // Os buffers são refeitos no próximo desenho (syncGpuBuffers)
+
+        stats.facesAfter = faces_.size();
+        stats.verticesAfter = vertices_.size();
+        stats.maxError = static_cast<float>(std::sqrt(worstCost));
+        stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return stats;
+    }
+} // namespace object
@@ -7,7 +7,7 @@
  * * 1. GERENCIAMENTO DE ESTADO VISUAL:
  * - Define quais vértices/faces estão selecionados (listas `selectedFaces`, `selectedVertices`).
  * - Altera cores para feedback visual (Vermelho = Selecionado, Cinza = Padrão).
- * - Sincroniza essas mudanças com a GPU chamando `updateVBOs()`.
+ * - Marca apenas as faces/vértices alterados; o próximo frame envia só esses trechos à GPU.
  * * 2. OPERAÇÕES DE MODELAGEM (MESH EDITING):
  * - Criação de Geometria: Adiciona vértices, faces e conecta elementos.
  * - Remoção de Geometria: Deleta elementos e corrige a topologia para evitar "buracos" lógicos (índices inválidos).
@@ -47,7 +47,7 @@ namespace object {
 
         if (faceIndex >= 0 && faceIndex < static_cast<int>(faceColors.size())) {
             faceColors[faceIndex] = color;
-            updateVBOs();
+            faceColorsDirty_.mark(faceIndex);
         }
     }
 
@@ -58,8 +58,10 @@ namespace object {
         if (vertexColors.size() != vertices_.size())
             vertexColors.resize(vertices_.size(), Color{0.0f, 0.0f, 0.0f});
 
-        if (vertexIndex >= 0 && vertexIndex < static_cast<int>(vertexColors.size()))
+        if (vertexIndex >= 0 && vertexIndex < static_cast<int>(vertexColors.size()) && vertexColors[vertexIndex] != color) {
             vertexColors[vertexIndex] = color;
+            vertexColorsDirty_.mark(vertexIndex);
+        }
     }
 
     // Limpa todas as seleções e restaura as cores originais
@@ -70,22 +72,24 @@ namespace object {
         selectedVertices.clear();
 
         selectedFaces.clear();
-        // Verificação de material
+        // Verificação de material (só as faces cuja cor muda vão para a GPU)
         for (int i = 0; i < faceColors.size(); ++i) {
-            if (transparent_faces_.count(i)) {
-                faceColors[i] = {0.6f, 0.8f, 1.0f}; // Vidro
-            } else {
-                faceColors[i] = {0.8f, 0.8f, 0.8f}; // Sólido
+            Color restored = transparent_faces_.count(i) ? Color{0.6f, 0.8f, 1.0f} // Vidro
+                                                         : Color{0.8f, 0.8f, 0.8f}; // Sólido
+            if (faceColors[i] != restored) {
+                faceColors[i] = restored;
+                faceColorsDirty_.mark(i);
             }
         }
-        updateVBOs();
     }
 
     // Reseta todas as cores da malha
     void Object::clearColors() {
         std::fill(vertexColors.begin(), vertexColors.end(), Color{0.0f, 0.0f, 0.0f});
+        vertexColorsDirty_.markAll();
         Color faceDefault = {0.8f, 0.8f, 0.8f};
         std::fill(faceColors.begin(), faceColors.end(), faceDefault);
+        faceColorsDirty_.markAll();
     }
 
     // ============================================================
@@ -175,6 +179,7 @@ namespace object {
             }
             face_uv_map_[faceIdx] = uvs; // Armazena UVs calculados
         }
+        textureBatchesDirty_ = true;
     }
 
     void Object::resetSelectedFacesToDefault() {
@@ -186,6 +191,7 @@ namespace object {
 
             // 2. Limpa coordenadas UV
             face_uv_map_.erase(faceIdx);
+            textureBatchesDirty_ = true;
 
             // 3. Remove da lista de transparência (Path Tracing)
             transparent_faces_.erase(faceIdx);
@@ -193,6 +199,7 @@ namespace object {
             // 4. Restaura a cor visual para Cinza Padrão
             if (faceIdx < faceColors.size()) {
                 faceColors[faceIdx] = {0.8f, 0.8f, 0.8f};
+                faceColorsDirty_.mark(faceIdx);
             }
         }
     }
@@ -207,16 +214,17 @@ namespace object {
                 // Pinta de "Ciano Azulado" para indicar vidro/água
                 if (faceIdx < faceColors.size()) {
                     faceColors[faceIdx] = {0.6f, 0.8f, 1.0f};
+                    faceColorsDirty_.mark(faceIdx);
                 }
             } else {
                 transparent_faces_.erase(faceIdx);
                 // Restaura cor padrão (Cinza)
                 if (faceIdx < faceColors.size()) {
                     faceColors[faceIdx] = {0.8f, 0.8f, 0.8f};
+                    faceColorsDirty_.mark(faceIdx);
                 }
             }
         }
-        updateVBOs();
     }
 
     bool Object::isFaceTransparent(int faceIndex) const {
@@ -255,7 +263,6 @@ namespace object {
                 }
             }
         }
-        updateVBOs();
     }
 
     // Seleciona todos os vértices que compõem uma face
@@ -269,7 +276,6 @@ namespace object {
                 setVertexColor(vertexIndex, {1.0f, 0.0f, 0.0f});
             }
         }
-        updateVBOs();
     }
 
     // Seleciona todas as faces que compartilham o vértice dado (Vertex Star)
@@ -283,7 +289,6 @@ namespace object {
                 setFaceColor(faceIndex, {1.0f, 0.0f, 0.0f});
             }
         }
-        updateVBOs();
     }
 
     // Seleciona faces que compartilham arestas com a face dada
@@ -297,7 +302,6 @@ namespace object {
                 setFaceColor(neighborFaceIndex, {1.0f, 0.0f, 0.0f});
             }
         }
-        updateVBOs();
     }
 
     // ============================================================
@@ -318,10 +322,12 @@ namespace object {
         // Atualiza estrutura de dados
         faces_.push_back(newFace);
         faceColors.push_back(Color{0.8f, 0.8f, 0.8f});
+        for (unsigned int v: newFace) markAODirty(vertices_[v]);
 
         // Recalcula arestas para o wireframe
         edges_ = calculateEdges(faces_);
-        updateVBOs();
+        rebuildTriangulation();
+        markGeometryChanged(); // Reenvia tudo no próximo frame
 
         // Limpa seleção
         for (int index: selectedVertices) setVertexColor(index, Color{0.0f, 0.0f, 0.0f});
@@ -340,7 +346,8 @@ namespace object {
         if (sscanf(inputX, "%f", &x) == 1 && sscanf(inputY, "%f", &y) == 1 && sscanf(inputZ, "%f", &z) == 1) {
             vertices_.push_back({x, y, z});
             vertexColors.push_back(Color{0.0f, 0.0f, 0.0f});
-            updateVBOs();
+            if (!vertexAO_.empty()) vertexAO_.push_back(-1.0f);
+            markGeometryChanged(); // Reenvia tudo no próximo frame
         }
     }
 
@@ -351,6 +358,7 @@ namespace object {
         float x = 0, y = 0, z = 0;
         vertices_.push_back({x, y, z});
         vertexColors.push_back({0, 0, 0});
+        if (!vertexAO_.empty()) vertexAO_.push_back(-1.0f);
 
         if (selectedVertices.size() >= 2) {
             std::vector<unsigned int> newFace;
@@ -358,8 +366,10 @@ namespace object {
             newFace.push_back(vertices_.size() - 1);
             faces_.push_back(newFace);
             faceColors.push_back({0.8f, 0.8f, 0.8f});
+            for (unsigned int v: newFace) markAODirty(vertices_[v]);
+            rebuildTriangulation();
         }
-        updateVBOs();
+        markGeometryChanged(); // Reenvia tudo no próximo frame
     }
 
     void Object::createVertexAndLinkToSelectedFaces() {
@@ -378,9 +388,14 @@ namespace object {
         if (!inputX) return;
 
         float val;
-        if (sscanf(inputX, "%f", &val) == 1) vertices_[vertexIndex][0] = val;
+        if (sscanf(inputX, "%f", &val) == 1) {
+            // A região afetada inclui as faces vizinhas antes e depois do movimento
+            markAODirtyAroundVertex(vertexIndex);
+            vertices_[vertexIndex][0] = val;
+            markAODirtyAroundVertex(vertexIndex);
+        }
 
-        updateVBOs();
+        markGeometryChanged(); // Reenvia tudo no próximo frame
     }
 
     // ============================================================
@@ -401,6 +416,8 @@ namespace object {
 
             int newIdx = 0;
             for (int i = 0; i < (int) faces_.size(); ++i) {
+                if (toDelete.count(i))
+                    for (unsigned int v: faces_[i]) markAODirty(vertices_[v]);
                 if (toDelete.find(i) == toDelete.end()) {
                     newFaces.push_back(faces_[i]);
                     newColors.push_back(faceColors[i]);
@@ -426,6 +443,8 @@ namespace object {
             std::unordered_set<int> toDelete(selectedVertices.begin(), selectedVertices.end());
             std::vector<std::array<float, 3> > newVerts;
             std::vector<Color> newVColors;
+            std::vector<float> newAO;
+            bool keepAO = vertexAO_.size() == vertices_.size();
             std::vector<int> mapOldToNew(vertices_.size(), -1); // Mapa para corrigir índices nas faces
 
             // Reconstrói lista de vértices e cria mapa de redirecionamento
@@ -434,10 +453,14 @@ namespace object {
                     mapOldToNew[i] = newVerts.size();
                     newVerts.push_back(vertices_[i]);
                     newVColors.push_back(vertexColors[i]);
+                    if (keepAO) newAO.push_back(vertexAO_[i]);
+                } else {
+                    markAODirtyAroundVertex(i); // As faces que usavam o vértice somem
                 }
             }
             vertices_ = newVerts;
             vertexColors = newVColors;
+            vertexAO_ = newAO;
 
             // Atualiza faces (remove as quebradas que usavam vértices deletados)
             std::vector<std::vector<unsigned int> > validFaces;
@@ -455,9 +478,56 @@ namespace object {
         }
         edges_ = calculateEdges(faces_);
         updateConnectivity();
+        rebuildTriangulation();
+        markGeometryChanged();
         setupVBOs();
     }
 
+    // ============================================================
+    // 6. OCLUSÃO AMBIENTE (REGIÃO ALTERADA)
+    // ============================================================
+    // Cada edição expande uma caixa com a geometria afetada; o bake incremental
+    // recalcula apenas os vértices próximos dela (ver render/AmbientOcclusion.h).
+
+    void Object::markAODirty(const std::array<float, 3> &p) {
+        if (!aoDirty_) {
+            aoDirtyMin_ = aoDirtyMax_ = p;
+            aoDirty_ = true;
+            return;
+        }
+        for (int k = 0; k < 3; ++k) {
+            aoDirtyMin_[k] = std::min(aoDirtyMin_[k], p[k]);
+            aoDirtyMax_[k] = std::max(aoDirtyMax_[k], p[k]);
+        }
+    }
+
+    // Marca todas as faces que usam o vértice (o mapa Vértice -> Faces pode estar desatualizado após edições)
+    void Object::markAODirtyAroundVertex(unsigned int vertexIndex) {
+        markAODirty(vertices_[vertexIndex]);
+        for (const auto &face: faces_) {
+            if (std::find(face.begin(), face.end(), vertexIndex) == face.end()) continue;
+            for (unsigned int v: face) markAODirty(vertices_[v]);
+        }
+    }
+
+    // Guarda a AO e marca só os vértices cujo valor mudou (bake incremental envia pouco)
+    void Object::setVertexAO(const std::vector<float> &ao) {
+        if (ao.size() != vertexAO_.size()) {
+            vertexAODirty_.markAll();
+        } else {
+            for (size_t i = 0; i < ao.size(); ++i)
+                if (ao[i] != vertexAO_[i]) vertexAODirty_.mark(i);
+        }
+        vertexAO_ = ao;
+    }
+
+    bool Object::getAODirtyRegion(std::array<float, 3> &minP, std::array<float, 3> &maxP) const {
+        if (!aoDirty_) return false;
+        minP = aoDirtyMin_;
+        maxP = aoDirtyMax_;
+        return true;
+    }
+
     // Helper interno para rastrear IDs originais (Picking)
     int Object::getCurrentIndex(int originalIndex) const {
         auto it = originalToCurrentIndex.find(originalIndex);
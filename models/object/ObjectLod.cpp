@@ -0,0 +1,291 @@
+/*
+ * ======================================================================================
+ * OBJECT LOD - NÍVEIS DE DETALHE CONTÍNUOS POR BLOCO
+ * ======================================================================================
+ * * Em malhas enormes (dragão, vértebras) a maior parte dos triângulos fica menor que um pixel
+ * no zoom usual. O LOD pré-calcula versões simplificadas de cada bloco e o drawCore escolhe,
+ * bloco a bloco, a mais grossa cujo erro projetado na tela fica abaixo de um limiar.
+ * * 1. BLOCOS:
+ * - Os mesmos do descarte (rebuildChunks): a triangulação segue a curva de Morton dos
+ * centroides, então cada bloco já é uma vizinhança compacta de faces inteiras.
+ * * 2. SIMPLIFICAÇÃO (QEM):
+ * - Colapsos de meia-aresta (u -> v, v já existente) pelo menor custo da quádrica de erro.
+ * Sem vértices novos: todos os níveis indexam o mesmo VBO, e AO/seleção continuam valendo.
+ * - Cada nível é uma cópia instantânea quando o bloco cai para metade dos triângulos do anterior;
+ * o erro do nível é o maior erro (raiz do custo) de todos os colapsos até ele.
+ * - Os blocos são independentes e simplificados em paralelo (OpenMP).
+ * * 3. SEM RACHADURAS:
+ * - Vértices usados por mais de um bloco, de borda da malha ou de arestas não-manifold nunca
+ * se movem. A fronteira entre dois blocos é a mesma em qualquer par de níveis.
+ * * 4. ARMAZENAMENTO:
+ * - O nível 0 de um bloco é a sua faixa na malha completa, sem cópia. Só os níveis
+ * simplificados vão no IBO das faces, depois da malha completa, e a face de origem de cada
+ * triângulo no texture buffer triângulo -> face: o shader das faces desenha qualquer nível
+ * sem mudança (uTriangleBase + gl_PrimitiveID).
+ * - No wireframe em passada única, o nível 0 (abaixo de uLodBase) ainda esconde as diagonais
+ * do leque; nos simplificados todas as arestas são do triângulo.
+ * * ======================================================================================
+ */
+
+#include "object.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <queue>
+#include <unordered_map>
+
+namespace object {
+    static const int LOD_MIN_TRIANGLES = 16; // Abaixo disso, nenhum nível a mais
+    static const int LOD_MAX_LEVELS = 8;
+
+    // Nível simplificado de um bloco, com índices globais
+    struct SimplifiedLevel {
+        std::vector<unsigned int> indices;
+        std::vector<int> faces;
+        float error = 0.0f;
+    };
+
+    // ============================================================
+    // 1. SIMPLIFICAÇÃO DE UM BLOCO
+    // ============================================================
+
+    // 'indices'/'faces': triângulos do bloco (índices globais). shared[v] = vértice usado por outro bloco.
+    static std::vector<SimplifiedLevel> simplifyChunk(const std::vector<std::array<float, 3> > &vertices,
+                                                      const std::vector<unsigned int> &indices,
+                                                      const std::vector<int> &faces,
+                                                      const std::vector<char> &shared) {
+        std::vector<SimplifiedLevel> levels;
+
+        // Vértices locais
+        std::vector<unsigned int> local(indices);
+        std::sort(local.begin(), local.end());
+        local.erase(std::unique(local.begin(), local.end()), local.end());
+        int nv = static_cast<int>(local.size());
+        int nt = static_cast<int>(faces.size());
+        auto toLocal = [&](unsigned int v) {
+            return static_cast<int>(std::lower_bound(local.begin(), local.end(), v) - local.begin());
+        };
+
+        std::vector<std::array<int, 3> > tri(nt);
+        std::vector<char> alive(nt, 1);
+        std::vector<std::vector<int> > adj(nv);
+        std::vector<Quadric> quadric(nv);
+        std::vector<char> locked(nv, 0);
+        std::vector<int> version(nv, 0);
+        std::unordered_map<uint64_t, int> edgeUse;
+
+        auto pos = [&](int v) -> const std::array<float, 3> & { return vertices[local[v]]; };
+        for (int t = 0; t < nt; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                tri[t][k] = toLocal(indices[t * 3 + k]);
+                adj[tri[t][k]].push_back(t);
+            }
+            for (int k = 0; k < 3; ++k) {
+                uint64_t a = tri[t][k], b = tri[t][(k + 1) % 3];
+                edgeUse[std::min(a, b) << 32 | std::max(a, b)]++;
+            }
+            // Plano do triângulo (normal unitária) somado nos três cantos
+            const auto &a = pos(tri[t][0]), &b = pos(tri[t][1]), &c = pos(tri[t][2]);
+            std::array<float, 3> n = math_utils::cross_product({b[0] - a[0], b[1] - a[1], b[2] - a[2]},
+                                                               {c[0] - a[0], c[1] - a[1], c[2] - a[2]});
+            if (math_utils::norm(n) == 0.0f) continue;
+            n = math_utils::normalize(n);
+            Quadric q = Quadric::plane(n[0], n[1], n[2], -(n[0] * a[0] + n[1] * a[1] + n[2] * a[2]));
+            for (int k = 0; k < 3; ++k) quadric[tri[t][k]] += q;
+        }
+        for (int v = 0; v < nv; ++v) locked[v] = shared[local[v]];
+        for (const auto &e: edgeUse)
+            if (e.second != 2) locked[e.first >> 32] = locked[e.first & 0xFFFFFFFFu] = 1;
+
+        // Fila de colapsos (u -> v); entradas ficam velhas quando u ou v mudam
+        struct Candidate {
+            double cost;
+            int u, v, versionU, versionV;
+            bool operator<(const Candidate &o) const { return cost > o.cost; }
+        };
+        std::priority_queue<Candidate> heap;
+        auto push = [&](int u, int v) {
+            if (locked[u]) return;
+            Quadric q = quadric[u];
+            q += quadric[v];
+            const auto &p = pos(v);
+            heap.push({std::max(0.0, q.evaluate(p[0], p[1], p[2])), u, v, version[u], version[v]});
+        };
+        for (int t = 0; t < nt; ++t)
+            for (int k = 0; k < 3; ++k) {
+                push(tri[t][k], tri[t][(k + 1) % 3]);
+                push(tri[t][(k + 1) % 3], tri[t][k]);
+            }
+
+        auto neighbors = [&](int v, std::vector<int> &out) {
+            out.clear();
+            for (int t: adj[v])
+                if (alive[t])
+                    for (int w: tri[t])
+                        if (w != v) out.push_back(w);
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+        };
+
+        // Colapso válido: a aresta existe, a condição de link vale (a malha continua manifold) e
+        // nenhum triângulo em volta de u vira do avesso.
+        std::vector<int> nu, nvv, common;
+        auto valid = [&](int u, int v) {
+            int sharedTris = 0;
+            for (int t: adj[u])
+                if (alive[t] && (tri[t][0] == v || tri[t][1] == v || tri[t][2] == v)) sharedTris++;
+            if (sharedTris == 0) return false;
+            neighbors(u, nu);
+            neighbors(v, nvv);
+            common.clear();
+            std::set_intersection(nu.begin(), nu.end(), nvv.begin(), nvv.end(), std::back_inserter(common));
+            if (static_cast<int>(common.size()) != sharedTris) return false;
+
+            const auto &pv = pos(v);
+            for (int t: adj[u]) {
+                if (!alive[t] || tri[t][0] == v || tri[t][1] == v || tri[t][2] == v) continue;
+                std::array<float, 3> p[3], q[3];
+                for (int k = 0; k < 3; ++k) p[k] = q[k] = pos(tri[t][k]);
+                for (int k = 0; k < 3; ++k) if (tri[t][k] == u) q[k] = pv;
+                std::array<float, 3> before = math_utils::cross_product(
+                    {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]},
+                    {p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2]});
+                std::array<float, 3> after = math_utils::cross_product(
+                    {q[1][0] - q[0][0], q[1][1] - q[0][1], q[1][2] - q[0][2]},
+                    {q[2][0] - q[0][0], q[2][1] - q[0][1], q[2][2] - q[0][2]});
+                float dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+                if (dot <= 0.2f * math_utils::norm(before) * math_utils::norm(after)) return false;
+            }
+            return true;
+        };
+
+        auto snapshot = [&](float error) {
+            SimplifiedLevel level;
+            level.error = error;
+            for (int t = 0; t < nt; ++t) {
+                if (!alive[t]) continue;
+                for (int k = 0; k < 3; ++k) level.indices.push_back(local[tri[t][k]]);
+                level.faces.push_back(faces[t]);
+            }
+            levels.push_back(std::move(level));
+        };
+
+        int aliveCount = nt, target = nt / 2;
+        double maxCost = 0.0;
+        while (!heap.empty() && aliveCount > LOD_MIN_TRIANGLES && static_cast<int>(levels.size()) < LOD_MAX_LEVELS) {
+            Candidate c = heap.top();
+            heap.pop();
+            if (c.versionU != version[c.u] || c.versionV != version[c.v] || adj[c.u].empty()) continue;
+            if (!valid(c.u, c.v)) continue;
+
+            // Colapso u -> v
+            int u = c.u, v = c.v;
+            for (int t: adj[u]) {
+                if (!alive[t]) continue;
+                if (tri[t][0] == v || tri[t][1] == v || tri[t][2] == v) {
+                    alive[t] = 0;
+                    aliveCount--;
+                } else {
+                    for (int k = 0; k < 3; ++k) if (tri[t][k] == u) tri[t][k] = v;
+                    adj[v].push_back(t);
+                }
+            }
+            adj[u].clear();
+            adj[v].erase(std::remove_if(adj[v].begin(), adj[v].end(), [&](int t) { return !alive[t]; }), adj[v].end());
+            quadric[v] += quadric[u];
+            version[u]++;
+            version[v]++;
+            maxCost = std::max(maxCost, c.cost);
+
+            neighbors(v, nvv);
+            for (int w: nvv) {
+                push(w, v);
+                push(v, w);
+            }
+
+            if (aliveCount <= target) {
+                snapshot(static_cast<float>(std::sqrt(maxCost)));
+                target = aliveCount / 2;
+            }
+        }
+        // Fila esgotada no meio do caminho: guarda o que conseguiu se a redução valer a pena
+        int lastCount = levels.empty() ? nt : static_cast<int>(levels.back().faces.size());
+        if (aliveCount < lastCount * 3 / 4 && static_cast<int>(levels.size()) < LOD_MAX_LEVELS)
+            snapshot(static_cast<float>(std::sqrt(maxCost)));
+        return levels;
+    }
+
+    // ============================================================
+    // 2. HIERARQUIA E ENVIO
+    // ============================================================
+
+    void Object::rebuildLod() {
+        lodIndices_.clear();
+        lodTriangleFace_.clear();
+        for (auto &chunk: chunks_) chunk.levels.clear();
+        lodDirty_ = false;
+        if (vertices_.empty() || chunks_.empty()) return;
+
+        // 1. Vértices compartilhados entre blocos: travados em todos os níveis (sem rachaduras)
+        int chunkCount = static_cast<int>(chunks_.size());
+        std::vector<int> owner(vertices_.size(), -1);
+        std::vector<char> shared(vertices_.size(), 0);
+        for (int c = 0; c < chunkCount; ++c) {
+            size_t first = static_cast<size_t>(chunks_[c].firstTriangle) * 3;
+            size_t last = first + static_cast<size_t>(chunks_[c].triangleCount) * 3;
+            for (size_t i = first; i < last; ++i) {
+                unsigned int v = face_index_array_[i];
+                if (owner[v] == -1) owner[v] = c;
+                else if (owner[v] != c) shared[v] = 1;
+            }
+        }
+
+        // 2. Simplificação de cada bloco, em paralelo. O nível 0 é a própria faixa do bloco no IBO
+        std::vector<std::vector<SimplifiedLevel> > simplified(chunkCount);
+#pragma omp parallel for schedule(dynamic, 4)
+        for (int c = 0; c < chunkCount; ++c) {
+            const MeshChunk &chunk = chunks_[c];
+            auto firstIndex = face_index_array_.begin() + static_cast<size_t>(chunk.firstTriangle) * 3;
+            auto firstFace = triangleToFace_.begin() + chunk.firstTriangle;
+            std::vector<unsigned int> indices(firstIndex, firstIndex + static_cast<size_t>(chunk.triangleCount) * 3);
+            std::vector<int> faces(firstFace, firstFace + chunk.triangleCount);
+            simplified[c] = simplifyChunk(vertices_, indices, faces, shared);
+        }
+
+        // 3. Só os níveis simplificados vão depois da malha completa; a numeração continua a dela
+        int next = static_cast<int>(triangleToFace_.size());
+        size_t fullTriangles = 0, coarsestTriangles = 0;
+        for (int c = 0; c < chunkCount; ++c) {
+            MeshChunk &chunk = chunks_[c];
+            for (const auto &level: simplified[c]) {
+                ChunkLevel l;
+                l.firstTriangle = next;
+                l.triangleCount = static_cast<int>(level.faces.size());
+                l.error = level.error;
+                lodIndices_.insert(lodIndices_.end(), level.indices.begin(), level.indices.end());
+                lodTriangleFace_.insert(lodTriangleFace_.end(), level.faces.begin(), level.faces.end());
+                next += l.triangleCount;
+                chunk.levels.push_back(l);
+            }
+            fullTriangles += chunk.triangleCount;
+            coarsestTriangles += chunk.levels.empty() ? chunk.triangleCount : chunk.levels.back().triangleCount;
+        }
+
+        // 4. IBO das faces = malha completa + LOD; triângulo -> face idem
+        uploadTriangleIndices(true);
+        if (tbo_triangle_face_ != 0) {
+            // Aloca o total e envia as duas partes, sem cópia concatenada
+            size_t base = triangleToFace_.size() * sizeof(int);
+            glBindBuffer(GL_TEXTURE_BUFFER, tbo_triangle_face_);
+            glBufferData(GL_TEXTURE_BUFFER, base + lodTriangleFace_.size() * sizeof(int), nullptr, GL_STATIC_DRAW);
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, base, triangleToFace_.data());
+            glBufferSubData(GL_TEXTURE_BUFFER, base, lodTriangleFace_.size() * sizeof(int), lodTriangleFace_.data());
+            countUpload(base + lodTriangleFace_.size() * sizeof(int));
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        }
+
+        std::cout << "LOD: " << chunkCount << " blocos, " << fullTriangles << " -> " << coarsestTriangles
+                << " triangulos no nivel mais grosso." << std::endl;
+    }
+} // namespace object
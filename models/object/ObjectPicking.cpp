@@ -20,10 +20,21 @@
  * - R = (ID >> 16) & 0xFF
  * - G = (ID >> 8) & 0xFF
  * - B = (ID) & 0xFF
+ * * 4. BUFFER DE IDS EM CACHE (OpenGL 3.2+):
+ * - Com suporte a alvos inteiros, os IDs são renderizados em um FBO próprio (R32UI, sem o
+ * limite de 24 bits do RGB), uma imagem para triângulos e outra para vértices.
+ * - Isso só acontece no fim de um frame em que a câmera ou a geometria mudaram; a cópia para
+ * a CPU é feita por um PBO (assíncrona), e cada clique vira uma consulta O(1) na memória.
+ * - Sem suporte (ou antes do primeiro frame), vale o color picking descrito acima.
+ * - O buffer de IDs só usa recursos do core profile (VAO, shaders GLSL 1.50, matriz por
+ * uniform): serve tanto ao pipeline fixo (matrizes lidas da pilha) quanto ao drawCore.
  * * ======================================================================================
  */
 
 #include "object.h"
+#include "../utils/math_utils.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -66,6 +77,12 @@ namespace object {
     // ============================================================
 
     int Object::pickFace(int mouseX, int mouseY, const int viewport[4]) const {
+        int cachedFace;
+        if (lookupPickBuffer(mouseX, mouseY, viewport, false, cachedFace)) {
+            if (cachedFace >= 0) std::cout << "Face original selecionada: " << cachedFace << std::endl;
+            return cachedFace;
+        }
+
         // Salva estado atual do OpenGL (cores, luzes, texturas) para restaurar depois.
         // O picking é uma operação "invisível" e não deve afetar a tela.
         glPushAttrib(GL_ALL_ATTRIB_BITS);
@@ -81,11 +98,9 @@ namespace object {
         glPushMatrix();
         applyPickingTransform(position_, scale_);
 
-        // Obtém a geometria triangulada
-        auto tri_faces = triangulateFaces(faces_);
-
+        // Usa a triangulação em cache (refeita apenas quando a topologia muda)
         glBegin(GL_TRIANGLES);
-        for (size_t i = 0; i < tri_faces.size(); ++i) {
+        for (size_t i = 0; i < triangleToFace_.size(); ++i) {
             unsigned int index = static_cast<unsigned int>(i);
 
             // CODIFICAÇÃO: ID (Int) -> Cor (RGB)
@@ -98,7 +113,7 @@ namespace object {
 
             // Desenha o triângulo
             for (int j = 0; j < 3; ++j) {
-                unsigned int vertexIndex = tri_faces[i][j];
+                unsigned int vertexIndex = face_index_array_[i * 3 + j];
                 const std::array<float, 3> &vertex = vertices_[vertexIndex];
                 glVertex3f(vertex[0], vertex[1], vertex[2]);
             }
@@ -121,10 +136,10 @@ namespace object {
         int pickedTriangleIndex = (pixel[0] << 16) | (pixel[1] << 8) | pixel[2];
 
         // Mapeia o triângulo clicado de volta para a Face Original (N-Gono)
-        auto it = faceTriangleMap.find(pickedTriangleIndex);
-        if (it != faceTriangleMap.end()) {
-            std::cout << "Face original selecionada: " << it->second << std::endl;
-            return it->second;
+        if (pickedTriangleIndex < static_cast<int>(triangleToFace_.size())) {
+            int face = triangleToFace_[pickedTriangleIndex];
+            std::cout << "Face original selecionada: " << face << std::endl;
+            return face;
         }
 
         return -1;
@@ -135,6 +150,9 @@ namespace object {
     // ============================================================
 
     int Object::pickVertex(int mouseX, int mouseY, const int viewport[4]) const {
+        int cachedVertex;
+        if (lookupPickBuffer(mouseX, mouseY, viewport, true, cachedVertex)) return cachedVertex;
+
         glPushAttrib(GL_ALL_ATTRIB_BITS);
 
         glDisable(GL_DITHER);
@@ -204,7 +222,266 @@ namespace object {
             if (face_cells_[i] == targetID) {
                 selectedFaces.push_back(static_cast<int>(i));
                 faceColors[i] = {1.0f, 0.0f, 0.0f};
+                faceColorsDirty_.mark(i);
             }
         }
     }
+
+    // ============================================================
+    // 5. BUFFER DE IDS EM CACHE (FBO + PBO)
+    // ============================================================
+
+    // Chamado no fim do draw() (ou do drawCore()), com as matrizes da vista atual (a ModelView
+    // já inclui a matriz do objeto). Se nada mudou, não faz nada.
+    void Object::updatePickBuffer(const math_utils::Mat4 &projection, const math_utils::Mat4 &modelView) {
+        if (pickBuffer_.state == 1 && pickBuffer_.compact != compactGeometry_) {
+            // Trocou de pipeline: o atributo de posição mudou de formato
+            glDeleteProgram(pickBuffer_.program);
+            glDeleteVertexArrays(1, &pickBuffer_.vao);
+            pickBuffer_.program = pickBuffer_.vao = 0;
+            pickBuffer_.state = 0;
+        }
+        if (vbo_vertices_ == 0 || !initPickProgram()) return;
+        PickBuffer &pb = pickBuffer_;
+
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        std::array<float, 32> matrices;
+        std::copy(projection.begin(), projection.end(), matrices.begin());
+        std::copy(modelView.begin(), modelView.end(), matrices.begin() + 16);
+        int w = viewport[2], h = viewport[3];
+        if (w <= 0 || h <= 0) return;
+        bool resized = w != pb.width || h != pb.height;
+        if (!pb.dirty && !resized && matrices == pb.matrices) return;
+
+        // 1. (Re)aloca o FBO e o PBO no tamanho da janela
+        if (pb.fbo == 0 || resized) {
+            if (pb.fbo == 0) {
+                glGenFramebuffers(1, &pb.fbo);
+                glGenTextures(1, &pb.triangleTex);
+                glGenTextures(1, &pb.vertexTex);
+                glGenRenderbuffers(1, &pb.depth);
+                glGenBuffers(1, &pb.pbo);
+            }
+            for (GLuint tex: {pb.triangleTex, pb.vertexTex}) {
+                glBindTexture(GL_TEXTURE_2D, tex);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, w, h, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+            }
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glBindRenderbuffer(GL_RENDERBUFFER, pb.depth);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pb.pbo);
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<size_t>(w) * h * 2 * sizeof(GLuint), nullptr,
+                         GL_STREAM_READ);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            pb.width = w;
+            pb.height = h;
+        }
+
+        // VAO próprio (posição no atributo do programa + IBO das faces): os nomes dos buffers
+        // não mudam depois de criados, então basta configurá-lo uma vez
+        if (pb.vao == 0) {
+            glGenVertexArrays(1, &pb.vao);
+            glBindVertexArray(pb.vao);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices_);
+            glEnableVertexAttribArray(pb.positionLocation);
+            if (pb.compact)
+                glVertexAttribIPointer(pb.positionLocation, 4, GL_UNSIGNED_SHORT, 0, nullptr);
+            else
+                glVertexAttribPointer(pb.positionLocation, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_faces_);
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        }
+
+        // Estado salvo à mão (sem glPushAttrib, que não existe no core profile)
+        GLint prevDraw = 0, prevRead = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevDraw);
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevRead);
+        GLboolean blend = glIsEnabled(GL_BLEND), depthTest = glIsEnabled(GL_DEPTH_TEST), dither = glIsEnabled(GL_DITHER);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, pb.fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pb.triangleTex, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, pb.vertexTex, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, pb.depth);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "FBO do picking incompleto: usando color picking." << std::endl;
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, prevDraw);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, prevRead);
+            pb.state = -1;
+            return;
+        }
+
+        glViewport(0, 0, w, h);
+        glDisable(GL_BLEND);
+        glDisable(GL_DITHER);
+        math_utils::Mat4 mvp = math_utils::mat4_multiply(projection, modelView);
+        glUseProgram(pb.program);
+        glUniformMatrix4fv(pb.mvpLocation, 1, GL_FALSE, mvp.data());
+        glBindVertexArray(pb.vao);
+        const GLuint background[4] = {0, 0, 0, 0};
+
+        // 2. Triângulos visíveis (com teste de profundidade)
+        glDrawBuffer(GL_COLOR_ATTACHMENT0);
+        glClearBufferuiv(GL_COLOR, 0, background);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        glEnable(GL_DEPTH_TEST);
+        glUniform1i(pb.pointsLocation, 0);
+        if (pb.compact) {
+            glActiveTexture(GL_TEXTURE4);
+            glBindTexture(GL_TEXTURE_BUFFER, tex_chunk_boxes_);
+            glActiveTexture(GL_TEXTURE0);
+        }
+        drawTriangleRange(0, static_cast<int>(triangleToFace_.size()), pb.triangleBaseLocation); // Só a malha completa
+
+        // 3. Vértices (sem profundidade e com pontos grandes, como no color picking)
+        glDrawBuffer(GL_COLOR_ATTACHMENT1);
+        glClearBufferuiv(GL_COLOR, 0, background);
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_PROGRAM_POINT_SIZE); // Tamanho do ponto vem do shader
+        glUniform1i(pb.pointsLocation, 1);
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(vertices_.size()));
+        glDisable(GL_PROGRAM_POINT_SIZE);
+
+        glBindVertexArray(0);
+        glUseProgram(0);
+
+        // 4. Leitura assíncrona: a cópia FBO -> PBO entra na fila da GPU e o frame segue;
+        // o mapeamento só acontece no próximo clique, quando a cópia já terminou.
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pb.pbo);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glReadPixels(0, 0, w, h, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        glReadBuffer(GL_COLOR_ATTACHMENT1);
+        glReadPixels(0, 0, w, h, GL_RED_INTEGER, GL_UNSIGNED_INT,
+                     reinterpret_cast<void *>(static_cast<size_t>(w) * h * sizeof(GLuint)));
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, prevDraw);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, prevRead);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        if (blend) glEnable(GL_BLEND);
+        if (depthTest) glEnable(GL_DEPTH_TEST);
+        if (dither) glEnable(GL_DITHER);
+
+        pb.matrices = matrices;
+        pb.dirty = false;
+        pb.pending = true;
+        pb.valid = true;
+    }
+
+    // Garante que a cópia na CPU ('ids') vale para a vista atual, concluindo a leitura assíncrona
+    // se preciso. false = sem suporte, geometria alterada ou janela redimensionada.
+    bool Object::resolvePickBuffer(const int viewport[4]) const {
+        PickBuffer &pb = pickBuffer_;
+        if (pb.state != 1 || !pb.valid || pb.dirty || geometryDirty_) return false;
+        if (viewport[2] != pb.width || viewport[3] != pb.height) return false;
+
+        // Uma cópia por renderização do buffer, não por clique
+        if (pb.pending) {
+            size_t count = static_cast<size_t>(pb.width) * pb.height * 2;
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pb.pbo);
+            const void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, count * sizeof(GLuint), GL_MAP_READ_BIT);
+            if (!data) {
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                return false;
+            }
+            pb.ids.resize(count);
+            std::memcpy(pb.ids.data(), data, count * sizeof(GLuint));
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            pb.pending = false;
+        }
+        return true;
+    }
+
+    // Responde um clique pelo buffer de IDs. Retorna false se o cache não vale para a vista
+    // atual: quem chama usa o color picking.
+    bool Object::lookupPickBuffer(int mouseX, int mouseY, const int viewport[4], bool vertices, int &id) const {
+        if (!resolvePickBuffer(viewport)) return false;
+        const PickBuffer &pb = pickBuffer_;
+
+        id = -1;
+        int x = mouseX - viewport[0];
+        int y = viewport[3] - 1 - mouseY; // GLUT conta Y de cima para baixo
+        if (x < 0 || y < 0 || x >= pb.width || y >= pb.height) return true;
+
+        size_t layer = vertices ? static_cast<size_t>(pb.width) * pb.height : 0;
+        unsigned int value = pb.ids[layer + static_cast<size_t>(y) * pb.width + x];
+        if (value == 0) return true; // Fundo
+        if (vertices) {
+            if (value <= vertices_.size()) id = static_cast<int>(value - 1);
+        } else if (value <= triangleToFace_.size()) {
+            id = triangleToFace_[value - 1]; // Triângulo -> Face original (N-Gono)
+        }
+        return true;
+    }
+
+    // ============================================================
+    // 6. SELEÇÃO POR REGIÃO (RETÂNGULO / LAÇO)
+    // ============================================================
+
+    // Varre os pixels da caixa do polígono no buffer de IDs: só elementos visíveis (faces
+    // encobertas não aparecem no buffer). Cada ID é reportado uma vez.
+    bool Object::pickRegion(const std::vector<std::array<float, 2> > &polygon, const int viewport[4], bool vertices,
+                            std::vector<int> &ids) const {
+        ids.clear();
+        if (polygon.size() < 3 || !resolvePickBuffer(viewport)) return false;
+        const PickBuffer &pb = pickBuffer_;
+
+        float minX = polygon[0][0], maxX = minX, minY = polygon[0][1], maxY = minY;
+        for (const auto &p: polygon) {
+            minX = std::min(minX, p[0]);
+            maxX = std::max(maxX, p[0]);
+            minY = std::min(minY, p[1]);
+            maxY = std::max(maxY, p[1]);
+        }
+        int x0 = std::max(0, static_cast<int>(minX) - viewport[0]);
+        int x1 = std::min(pb.width - 1, static_cast<int>(maxX) - viewport[0]);
+        int y0 = std::max(0, static_cast<int>(minY));
+        int y1 = std::min(pb.height - 1, static_cast<int>(maxY));
+
+        size_t layer = vertices ? static_cast<size_t>(pb.width) * pb.height : 0;
+        size_t limit = vertices ? vertices_.size() : triangleToFace_.size();
+        std::vector<unsigned char> seen(vertices ? vertices_.size() : faces_.size(), 0);
+        for (int y = y0; y <= y1; ++y) {
+            const unsigned int *row = &pb.ids[layer + static_cast<size_t>(pb.height - 1 - y) * pb.width];
+            for (int x = x0; x <= x1; ++x) {
+                unsigned int value = row[x];
+                if (value == 0 || value > limit) continue;
+                int id = vertices ? static_cast<int>(value - 1) : triangleToFace_[value - 1];
+                if (seen[id]) continue;
+                if (!math_utils::point_in_polygon(x + viewport[0] + 0.5f, y + 0.5f, polygon)) continue;
+                seen[id] = 1;
+                ids.push_back(id);
+            }
+        }
+        return true;
+    }
+
+    void Object::addToSelection(const std::vector<int> &faces, const std::vector<int> &vertices) {
+        std::vector<unsigned char> isSelected(faces_.size(), 0);
+        for (int f: selectedFaces)
+            if (f >= 0 && f < static_cast<int>(faces_.size())) isSelected[f] = 1;
+        for (int f: faces) {
+            if (f < 0 || f >= static_cast<int>(faces_.size()) || isSelected[f]) continue;
+            isSelected[f] = 1;
+            selectedFaces.push_back(f);
+            setFaceColor(f, {1.0f, 0.0f, 0.0f}); // Só marca o trecho; o envio acontece no draw()
+        }
+
+        isSelected.assign(vertices_.size(), 0);
+        for (int v: selectedVertices)
+            if (v >= 0 && v < static_cast<int>(vertices_.size())) isSelected[v] = 1;
+        for (int v: vertices) {
+            if (v < 0 || v >= static_cast<int>(vertices_.size()) || isSelected[v]) continue;
+            isSelected[v] = 1;
+            selectedVertices.push_back(v);
+            setVertexColor(v, {1.0f, 0.0f, 0.0f});
+        }
+        std::cout << "Regiao: " << faces.size() << " faces e " << vertices.size() << " vertices." << std::endl;
+    }
 } // namespace object
@@ -0,0 +1,89 @@
+/*
+ * ======================================================================================
+ * OBJECT PROFILING - TEMPOS DE GPU E CPU POR PASSADA DO DESENHO
+ * ======================================================================================
+ * * Sem medir não dá para saber se um quadro lento vem das faces, das arestas, dos pontos,
+ * das texturas ou das reconstruções na CPU. Cada passada de draw()/drawCore() fica entre
+ * beginPass e endPass:
+ * * 1. GPU: uma timer query (GL_TIME_ELAPSED) por passada. Só uma pode estar ativa por vez,
+ * e as passadas são sequenciais, então não se sobrepõem. As queries formam um anel de
+ * GpuTimers::FRAMES quadros; no fim de cada quadro os quadros anteriores cujos resultados
+ * já estão prontos são lidos (GL_QUERY_RESULT_AVAILABLE), nunca esperando pela GPU.
+ * * 2. CPU: o tempo de submissão de cada passada e, em separado (ScopedCpuTimer), os
+ * reenvios/reconstruções e o descarte por blocos.
+ * * 3. VOLUME: triângulos, linhas e pontos enviados, chamadas de desenho e bytes enviados à
+ * GPU (countUpload em cada glBufferData/glBufferSubData/mapeamento/textura).
+ * * As queries só são emitidas com o perfilamento ligado (painel visível); o resto custa
+ * apenas a leitura do relógio.
+ * * ======================================================================================
+ */
+
+#include "object.h"
+#include <iostream>
+
+namespace object {
+    // Inicia a passada: cronômetro de CPU e, com o perfilamento ligado, a timer query do quadro atual.
+    void Object::beginPass(RenderPass pass) {
+        passStart_ = std::chrono::steady_clock::now();
+        if (!profiling_) return;
+
+        GpuTimers &timers = gpuTimers_;
+        if (timers.state == 0) {
+            timers.state = -1;
+            if (!GLEW_VERSION_3_3 && !GLEW_ARB_timer_query) {
+                std::cout << "Timer queries indisponiveis: painel apenas com tempos de CPU." << std::endl;
+                return;
+            }
+            for (auto &frameQueries: timers.queries) glGenQueries(PASS_COUNT, frameQueries.data());
+            timers.state = 1;
+        }
+        if (timers.state != 1) return;
+
+        int slot = timers.frame % GpuTimers::FRAMES;
+        glBeginQuery(GL_TIME_ELAPSED, timers.queries[slot][pass]);
+        timers.issued[slot][pass] = true;
+    }
+
+    void Object::endPass(RenderPass pass) {
+        currentTimings_.cpuMs[pass] += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - passStart_).count();
+        int slot = gpuTimers_.frame % GpuTimers::FRAMES;
+        if (profiling_ && gpuTimers_.state == 1 && gpuTimers_.issued[slot][pass]) glEndQuery(GL_TIME_ELAPSED);
+    }
+
+    // Fecha o quadro: publica os tempos de CPU e contagens, avança o anel e lê os quadros anteriores
+    // que a GPU já concluiu (do mais antigo ao mais novo; o mais novo pronto vence).
+    void Object::endFrameTimings() {
+        GpuTimers &timers = gpuTimers_;
+        if (timers.state == 1) {
+            timers.frame = (timers.frame + 1) % GpuTimers::FRAMES;
+            for (int i = 0; i < GpuTimers::FRAMES; ++i) {
+                int slot = (timers.frame + i) % GpuTimers::FRAMES;
+                auto &issued = timers.issued[slot];
+                if (std::find(issued.begin(), issued.end(), true) == issued.end()) continue;
+
+                bool ready = true;
+                for (int p = 0; p < PASS_COUNT && ready; ++p) {
+                    if (!issued[p]) continue;
+                    GLint available = 0;
+                    glGetQueryObjectiv(timers.queries[slot][p], GL_QUERY_RESULT_AVAILABLE, &available);
+                    ready = available != 0;
+                }
+                if (!ready) continue;
+
+                for (int p = 0; p < PASS_COUNT; ++p) {
+                    GLuint64 nanoseconds = 0;
+                    if (issued[p]) glGetQueryObjectui64v(timers.queries[slot][p], GL_QUERY_RESULT, &nanoseconds);
+                    timers.latestMs[p] = static_cast<double>(nanoseconds) / 1.0e6;
+                    issued[p] = false;
+                }
+                timers.hasResult = true;
+            }
+        }
+
+        frameTimings_ = currentTimings_;
+        frameTimings_.gpuValid = profiling_ && timers.hasResult;
+        if (frameTimings_.gpuValid) frameTimings_.gpuMs = timers.latestMs;
+        currentTimings_ = FrameTimings();
+    }
+} // namespace object
@@ -0,0 +1,254 @@
+/*
+ * ======================================================================================
+ * OBJECT QUANTIZATION - FORMATO COMPACTO DOS VÉRTICES E ÍNDICES (RENDERIZADOR CORE)
+ * ======================================================================================
+ * * Em malhas grandes o que pesa na GPU são posições em float e índices de 32 bits, lidos a
+ * cada frame. No drawCore a geometria vai num formato compacto, decodificado no vertex shader:
+ * * 1. POSIÇÕES (16 bits):
+ * - Cada vértice é quantizado na caixa envolvente do primeiro bloco de descarte que o usa
+ * (ObjectCulling.cpp): uvec4 = (x, y, z em 16 bits, índice da caixa). São 8 bytes em vez de 12.
+ * - As caixas (mínimo e passo = extensão / 65535) ficam num texture buffer; o shader faz
+ * mínimo + q * passo. O vértice é único no VBO, então os blocos vizinhos decodificam a mesma
+ * posição: sem rachaduras entre blocos nem entre níveis do LOD.
+ * - Vértices fora de triângulos usam uma última caixa, a da malha inteira.
+ * - Os lotes de textura não copiam posições: guardam o índice do vértice e leem o mesmo VBO
+ * como texture buffer (a textura cai sobre a face com o mesmo Z).
+ * * 2. ÍNDICES (16 bits por trecho):
+ * - O IBO das faces é cortado em trechos de triângulos consecutivos cujos índices cabem numa
+ * janela de 65536 vértices; cada trecho guarda índices de 16 bits relativos ao menor deles e é
+ * desenhado com glDrawElementsBaseVertex. Trechos curtos demais voltam a 32 bits.
+ * - Malhas escaneadas/geradas vêm espacialmente coerentes: quase tudo cabe em 16 bits.
+ * * 3. COR E AO: as cores das faces e dos pontos já são RGBA8; a AO vai em 8 bits normalizados.
+ * * O pipeline fixo (e o color picking legado) continua com floats e índices de 32 bits: o
+ * formato acompanha quem desenha (drawCore ou draw), e a troca reenvia a geometria.
+ * * ======================================================================================
+ */
+
+#include "object.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace object {
+    static const unsigned int INDEX_WINDOW = 65535; // Maior diferença entre índices de um trecho de 16 bits
+    static const int MIN_NARROW_TRIANGLES = 64; // Trechos menores voltam a 32 bits (menos chamadas)
+    static const int MAX_BOXES = 65536; // O índice da caixa vai no 4º componente de 16 bits
+
+    // ============================================================
+    // 1. POSIÇÕES QUANTIZADAS
+    // ============================================================
+
+    // Chamado no setupVBOs, depois de rebuildChunks (as caixas são as dos blocos de descarte).
+    void Object::uploadQuantizedPositions() {
+        // Com blocos demais para 16 bits, blocos consecutivos dividem a caixa (união das caixas)
+        int chunkCount = static_cast<int>(chunks_.size());
+        int group = std::max(1, (chunkCount + MAX_BOXES - 2) / (MAX_BOXES - 1));
+        int boxCount = (chunkCount + group - 1) / group;
+
+        std::vector<std::array<float, 3> > boxMin(boxCount + 1, {1e30f, 1e30f, 1e30f});
+        std::vector<std::array<float, 3> > boxMax(boxCount + 1, {-1e30f, -1e30f, -1e30f});
+        for (int c = 0; c < chunkCount; ++c)
+            for (int k = 0; k < 3; ++k) {
+                boxMin[c / group][k] = std::min(boxMin[c / group][k], chunks_[c].boxMin[k]);
+                boxMax[c / group][k] = std::max(boxMax[c / group][k], chunks_[c].boxMax[k]);
+            }
+        for (const auto &v: vertices_) // Última caixa: a malha inteira
+            for (int k = 0; k < 3; ++k) {
+                boxMin[boxCount][k] = std::min(boxMin[boxCount][k], v[k]);
+                boxMax[boxCount][k] = std::max(boxMax[boxCount][k], v[k]);
+            }
+
+        // Caixa de cada vértice: a do primeiro bloco que o usa
+        std::vector<int> home(vertices_.size(), boxCount);
+        std::vector<char> assigned(vertices_.size(), 0);
+        for (int c = 0; c < chunkCount; ++c) {
+            const MeshChunk &chunk = chunks_[c];
+            size_t begin = static_cast<size_t>(chunk.firstTriangle) * 3;
+            size_t end = begin + static_cast<size_t>(chunk.triangleCount) * 3;
+            for (size_t i = begin; i < end; ++i) {
+                unsigned int v = face_index_array_[i];
+                if (assigned[v]) continue;
+                assigned[v] = 1;
+                home[v] = c / group;
+            }
+        }
+
+        // Texture buffer RGBA32F: (mínimo, 0) e (passo, 0) por caixa
+        std::vector<float> boxes(static_cast<size_t>(boxCount + 1) * 8, 0.0f);
+        std::vector<std::array<float, 3> > step(boxCount + 1);
+        for (int b = 0; b <= boxCount; ++b) {
+            if (boxMin[b][0] > boxMax[b][0]) boxMin[b] = boxMax[b] = {0.0f, 0.0f, 0.0f}; // Caixa vazia
+            for (int k = 0; k < 3; ++k) {
+                step[b][k] = (boxMax[b][k] - boxMin[b][k]) / static_cast<float>(INDEX_WINDOW);
+                boxes[b * 8 + k] = boxMin[b][k];
+                boxes[b * 8 + 4 + k] = step[b][k];
+            }
+        }
+
+        // Quantiza direto no VBO mapeado (sem cópia de staging na CPU)
+        size_t bytes = vertices_.size() * 4 * sizeof(uint16_t);
+        if (vbo_vertices_ == 0) glGenBuffers(1, &vbo_vertices_);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices_);
+        glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STATIC_DRAW);
+        auto *packed = static_cast<uint16_t *>(
+            bytes ? glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT) : nullptr);
+        if (packed) {
+            for (size_t i = 0; i < vertices_.size(); ++i) {
+                int b = home[i];
+                for (int k = 0; k < 3; ++k) {
+                    float q = step[b][k] > 0.0f ? (vertices_[i][k] - boxMin[b][k]) / step[b][k] : 0.0f;
+                    packed[i * 4 + k] = static_cast<uint16_t>(std::min(65535.0f, std::max(0.0f, std::round(q))));
+                }
+                packed[i * 4 + 3] = static_cast<uint16_t>(b);
+            }
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            countUpload(bytes);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        // O mesmo VBO visto como texture buffer: os lotes de textura buscam a posição pelo índice
+        if (tex_packed_positions_ == 0) glGenTextures(1, &tex_packed_positions_);
+        glBindTexture(GL_TEXTURE_BUFFER, tex_packed_positions_);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA16UI, vbo_vertices_);
+
+        if (tbo_chunk_boxes_ == 0) glGenBuffers(1, &tbo_chunk_boxes_);
+        if (tex_chunk_boxes_ == 0) glGenTextures(1, &tex_chunk_boxes_);
+        glBindBuffer(GL_TEXTURE_BUFFER, tbo_chunk_boxes_);
+        glBufferData(GL_TEXTURE_BUFFER, boxes.size() * sizeof(float), boxes.data(), GL_STATIC_DRAW);
+        countUpload(boxes.size() * sizeof(float));
+        glBindTexture(GL_TEXTURE_BUFFER, tex_chunk_boxes_);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, tbo_chunk_boxes_);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    // ============================================================
+    // 2. ÍNDICES EM TRECHOS DE 16/32 BITS
+    // ============================================================
+
+    // Envia o IBO das faces: face_index_array_ e, com withLod, lodIndices_ logo depois. As duas
+    // partes vão direto para o buffer (sem vetor concatenado). Fora do formato compacto, um único
+    // trecho de 32 bits com os índices como estão.
+    void Object::uploadTriangleIndices(bool withLod) {
+        indexSegments_.clear();
+        const std::vector<unsigned int> &base = face_index_array_;
+        const std::vector<unsigned int> &extra = withLod ? lodIndices_ : base; // Ignorado sem LOD
+        size_t total = base.size() + (withLod ? extra.size() : 0);
+        auto index = [&](size_t i) { return i < base.size() ? base[i] : extra[i - base.size()]; };
+        int triCount = static_cast<int>(total / 3);
+        if (ibo_faces_ == 0) glGenBuffers(1, &ibo_faces_);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_faces_);
+
+        if (!compactGeometry_) {
+            IndexSegment all;
+            all.triangleCount = triCount;
+            all.wide = true;
+            indexSegments_.push_back(all);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, total * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, base.size() * sizeof(unsigned int), base.data());
+            if (withLod)
+                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, base.size() * sizeof(unsigned int),
+                                extra.size() * sizeof(unsigned int), extra.data());
+            countUpload((base.size() + (withLod ? extra.size() : 0)) * sizeof(unsigned int));
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            return;
+        }
+
+        // 1. Trechos gulosos: cresce enquanto a janela [menor, maior] cabe em 16 bits
+        unsigned int lo = 0, hi = 0;
+        for (int t = 0; t < triCount; ++t) {
+            size_t i0 = static_cast<size_t>(t) * 3;
+            unsigned int tri[3] = {index(i0), index(i0 + 1), index(i0 + 2)};
+            unsigned int tLo = std::min({tri[0], tri[1], tri[2]}), tHi = std::max({tri[0], tri[1], tri[2]});
+            if (!indexSegments_.empty() && std::max(hi, tHi) - std::min(lo, tLo) <= INDEX_WINDOW) {
+                lo = std::min(lo, tLo);
+                hi = std::max(hi, tHi);
+                indexSegments_.back().triangleCount++;
+                continue;
+            }
+            // Fecha o trecho anterior
+            if (!indexSegments_.empty()) {
+                IndexSegment &last = indexSegments_.back();
+                last.baseVertex = static_cast<int>(lo);
+                last.wide = hi - lo > INDEX_WINDOW || last.triangleCount < MIN_NARROW_TRIANGLES;
+            }
+            IndexSegment segment;
+            segment.firstTriangle = t;
+            segment.triangleCount = 1;
+            indexSegments_.push_back(segment);
+            lo = tLo;
+            hi = tHi;
+        }
+        if (!indexSegments_.empty()) {
+            IndexSegment &last = indexSegments_.back();
+            last.baseVertex = static_cast<int>(lo);
+            last.wide = hi - lo > INDEX_WINDOW || last.triangleCount < MIN_NARROW_TRIANGLES;
+        }
+
+        // 2. Trechos de 32 bits vizinhos viram um só
+        std::vector<IndexSegment> merged;
+        for (const auto &segment: indexSegments_) {
+            if (segment.wide && !merged.empty() && merged.back().wide)
+                merged.back().triangleCount += segment.triangleCount;
+            else
+                merged.push_back(segment);
+        }
+        indexSegments_.swap(merged);
+
+        // 3. Deslocamentos (trechos de 32 bits alinhados a 4 bytes)
+        size_t bytes = 0;
+        for (auto &segment: indexSegments_) {
+            if (segment.wide) {
+                segment.baseVertex = 0;
+                bytes = (bytes + 3) & ~static_cast<size_t>(3);
+            }
+            segment.offset = bytes;
+            bytes += static_cast<size_t>(segment.triangleCount) * 3 * (segment.wide ? sizeof(unsigned int) : sizeof(uint16_t));
+        }
+
+        // 4. Escreve direto no buffer mapeado
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, bytes, nullptr, GL_STATIC_DRAW);
+        auto *out = static_cast<unsigned char *>(
+            bytes ? glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)
+                  : nullptr);
+        if (out) {
+            for (const auto &segment: indexSegments_) {
+                size_t begin = static_cast<size_t>(segment.firstTriangle) * 3;
+                size_t count = static_cast<size_t>(segment.triangleCount) * 3;
+                if (segment.wide) {
+                    unsigned int *dst = reinterpret_cast<unsigned int *>(out + segment.offset);
+                    for (size_t i = 0; i < count; ++i) dst[i] = index(begin + i);
+                } else {
+                    uint16_t *dst = reinterpret_cast<uint16_t *>(out + segment.offset);
+                    for (size_t i = 0; i < count; ++i)
+                        dst[i] = static_cast<uint16_t>(index(begin + i) - static_cast<unsigned int>(segment.baseVertex));
+                }
+            }
+            glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+            countUpload(bytes);
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    // Desenha os triângulos [first, first + count) do IBO das faces (VAO já ligado), uma chamada
+    // por trecho atravessado. uTriangleBase recebe o primeiro triângulo de cada chamada.
+    // Retorna o número de chamadas.
+    int Object::drawTriangleRange(int first, int count, GLint triangleBaseLocation) const {
+        int end = first + count, calls = 0;
+        auto it = std::upper_bound(indexSegments_.begin(), indexSegments_.end(), first,
+                                   [](int t, const IndexSegment &s) { return t < s.firstTriangle; });
+        if (it != indexSegments_.begin()) --it;
+        for (; it != indexSegments_.end() && it->firstTriangle < end; ++it) {
+            int a = std::max(first, it->firstTriangle);
+            int b = std::min(end, it->firstTriangle + it->triangleCount);
+            if (a >= b) continue;
+            size_t indexSize = it->wide ? sizeof(unsigned int) : sizeof(uint16_t);
+            size_t offset = it->offset + static_cast<size_t>(a - it->firstTriangle) * 3 * indexSize;
+            glUniform1i(triangleBaseLocation, a);
+            glDrawElementsBaseVertex(GL_TRIANGLES, (b - a) * 3, it->wide ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT,
+                                     reinterpret_cast<const void *>(offset), it->baseVertex);
+            ++calls;
+        }
+        return calls;
+    }
+} // namespace object
@@ -8,25 +8,43 @@
  * * 1. TRIANGULAÇÃO (Tessellation):
  * - A GPU desenha nativamente apenas triângulos. O objeto pode conter faces complexas
  * (quadriláteros, polígonos côncavos/convexos).
- * - A função `triangulateFaces` converte qualquer N-gono em um conjunto de triângulos
- * usando o metodo "Triangle Fan" (Vértice 0 conecta a todos).
+ * - A função `rebuildTriangulation` converte qualquer N-gono em um conjunto de triângulos
+ * usando o metodo "Triangle Fan" (Vértice 0 conecta a todos), uma vez por mudança de topologia.
+ * - As faces são triangularizadas na ordem da curva de Morton dos centroides: faixas do IBO
+ * são regiões compactas da malha (blocos de descarte e LOD).
  * * 2. VERTEX BUFFER OBJECTS (VBOs) & INDEX BUFFER OBJECTS (IBOs):
  * - Em vez de enviar vértices um por um a cada frame (modo imediato `glBegin/glEnd` lento),
  * armazenamos os dados na memória da placa de vídeo (VRAM).
- * - VBO (`vbo_vertices_`): Guarda coordenadas (x, y, z).
+ * - VBO (`vbo_vertices_`): Guarda coordenadas (x, y, z), enviadas direto de `vertices_`
+ * (float3 contíguos), sem array achatado intermediário.
  * - IBO (`ibo_faces_`, `ibo_edges_`): Guarda apenas os índices (0, 1, 2...), economizando
  * memória e permitindo reutilização de vértices.
+ * - As faces são desenhadas com UM glDrawElements. A cor chapada de cada face vem de
+ * texture buffers lidos no shader com gl_PrimitiveID (triângulo -> face -> cor); mudar
+ * cores reenvia só esses buffers, e a triangulação só é refeita quando a topologia muda.
+ * Sem OpenGL 3.2 (ou se o shader falhar), cai no modo imediato com a triangulação em cache.
  * * 3. TEXTURIZAÇÃO (Texture Mapping):
  * - Utiliza a biblioteca `stb_image` para decodificar formatos PNG/JPG em arrays de bytes.
  * - Gerencia o upload para a GPU (`glTexImage2D`) e configurações de amostragem (filtros).
  * - Implementa lógica de overlay para desenhar texturas sobre a malha base, respeitando
  * a seleção do usuário (o vermelho da seleção tem prioridade sobre a textura).
+ * - As faces texturizadas ficam em lotes por textura num VBO (posição + UV), refeitos só quando
+ * as texturas ou a geometria mudam; a seleção as esconde por uma máscara de alfa por canto.
  * * 4. RENDERIZAÇÃO EM CAMADAS (Multi-pass Rendering):
  * - O metodo `draw` orquestra o desenho em ordem específica para lidar com profundidade:
  * a) Faces Sólidas (Fundo) -> Escreve no Z-Buffer.
  * b) Arestas (Wireframe) -> Linhas pretas para definição de forma.
  * c) Vértices (Pontos) -> Dupla passada para desenhar normais e selecionados (com Z-Test desativado).
  * d) Texturas (Overlay) -> Mistura com a cor base (Blend).
+ * * 5. RENDERIZADOR CORE PROFILE (`drawCore`):
+ * - As mesmas camadas sem pipeline fixo: VAOs sobre os mesmos buffers, shaders GLSL 3.30 e a
+ * câmera como uniform. É o caminho padrão do visualizador; `draw` fica como legado (sem GL 3.3
+ * ou com `--legacy-gl`).
+ * - As faces são desenhadas por faixas de blocos que sobrevivem ao descarte (frustum, cone de
+ * normais e oclusão Hi-Z; ver ObjectCulling.cpp), cada um no nível de detalhe escolhido pelo
+ * erro projetado quando o LOD está ligado (ver ObjectLod.cpp).
+ * - Wireframe em passada única (opcional): as arestas saem do shader das faces, pela distância
+ * de cada fragmento às arestas do triângulo; o IBO de arestas deixa de ser desenhado.
  * * ======================================================================================
  */
 
@@ -36,8 +54,10 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <cstring>
 #include <unordered_set>
 #include <algorithm>
+#include <cstdint>
 
 #ifdef __APPLE__
 #include <GLUT/glut.h>
@@ -46,44 +66,86 @@
 #endif
 
 namespace object {
+    // Os buffers recebem o armazenamento canônico direto: posições float3 e pares de índices
+    // precisam estar contíguos, sem preenchimento
+    static_assert(sizeof(std::array<float, 3>) == 3 * sizeof(float), "posicao com preenchimento");
+    static_assert(sizeof(std::pair<unsigned int, unsigned int>) == 2 * sizeof(unsigned int),
+                  "aresta com preenchimento");
+    static_assert(sizeof(std::array<int, 2>) == 2 * sizeof(int), "faixa de triangulos com preenchimento");
+
     // ============================================================
     // 1. HELPERS DE GEOMETRIA (Prepara dados para OpenGL)
     // ============================================================
 
+    // Intercala os 10 bits menos significativos com dois zeros entre cada bit (código de Morton)
+    static uint32_t spreadBits(uint32_t x) {
+        x &= 0x3FF;
+        x = (x | (x << 16)) & 0x030000FF;
+        x = (x | (x << 8)) & 0x0300F00F;
+        x = (x | (x << 4)) & 0x030C30C3;
+        x = (x | (x << 2)) & 0x09249249;
+        return x;
+    }
+
     /*
      * Converte a lista de faces (que pode conter polígonos de N lados)
      * em uma lista plana de triângulos compatível com o rasterizador da GPU.
      * * Algoritmo (Triangle Fan):
      * Para um polígono com vértices v0, v1, v2, v3...
      * Cria triângulos: (v0, v1, v2), (v0, v2, v3), etc.
+     * * Resultado em arrays densos (sem mapas): face_index_array_ (3 índices por triângulo),
+     * triangleToFace_ (triângulo -> face) e faceTriangles_ (face -> faixa de triângulos).
+     * * Ordem espacial: as faces entram na ordem da curva de Morton do centroide, e não na do
+     * arquivo. Os triângulos de uma face continuam juntos, e qualquer faixa do IBO vira uma
+     * região compacta da malha: os blocos de descarte/LOD (rebuildChunks) são só faixas.
+     * Só é chamada quando a topologia muda; desenho, picking e Path Tracer leem o cache.
      */
-    std::vector<std::array<unsigned int, 3> > Object::triangulateFaces(
-        const std::vector<std::vector<unsigned int> > &faces) const {
-        std::vector<std::array<unsigned int, 3> > triangles;
-        faceTriangleMap.clear(); // Reseta o mapa [Indice Triângulo -> Índice Face Original]
-
-        for (size_t faceIndex = 0; faceIndex < faces.size(); ++faceIndex) {
-            const auto &face = faces[faceIndex];
-            size_t n = face.size();
-
-            if (n < 3) continue; // Ignora linhas ou pontos degenerados
-
-            // Caso simples (Triângulo): Copia direto
-            else if (n == 3) {
-                triangles.push_back({face[0], face[1], face[2]});
-                // Mapeia o triângulo gerado de volta para a face original (útil para picking)
-                faceTriangleMap[static_cast<int>(triangles.size()) - 1] = static_cast<int>(faceIndex);
+    void Object::rebuildTriangulation() {
+        // 1. Caixa da malha e código de Morton (10 bits por eixo) do centroide de cada face
+        std::array<float, 3> lo = {1e30f, 1e30f, 1e30f}, hi = {-1e30f, -1e30f, -1e30f};
+        for (const auto &v: vertices_)
+            for (int k = 0; k < 3; ++k) {
+                lo[k] = std::min(lo[k], v[k]);
+                hi[k] = std::max(hi[k], v[k]);
             }
-            // Caso complexo (N-Gono): Divide em N-2 triângulos
-            else {
-                unsigned int v0 = face[0]; // Pivô do leque
-                for (size_t i = 1; i < n - 1; ++i) {
-                    triangles.push_back({v0, face[i], face[i + 1]});
-                    faceTriangleMap[static_cast<int>(triangles.size()) - 1] = static_cast<int>(faceIndex);
-                }
+        // Células cúbicas (maior lado da caixa): num eixo achatado, o Morton esticado intercalaria
+        // a variação pequena desse eixo com a dos outros e espalharia os blocos
+        float extent = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+        size_t triCount = 0;
+        std::vector<std::pair<uint32_t, int> > order; // (código, face); linhas/pontos não entram
+        order.reserve(faces_.size());
+        for (size_t f = 0; f < faces_.size(); ++f) {
+            const auto &face = faces_[f];
+            if (face.size() < 3) continue;
+            triCount += face.size() - 2; // Uma face de N lados gera N-2 triângulos
+            std::array<float, 3> c = {0.0f, 0.0f, 0.0f};
+            for (unsigned int v: face)
+                for (int k = 0; k < 3; ++k) c[k] += vertices_[v][k];
+            uint32_t code = 0;
+            for (int k = 0; k < 3; ++k) {
+                float cell = extent > 0.0f ? (c[k] / face.size() - lo[k]) / extent * 1023.0f : 0.0f;
+                code |= spreadBits(static_cast<uint32_t>(std::max(0.0f, std::min(1023.0f, cell)))) << k;
+            }
+            order.push_back({code, static_cast<int>(f)});
+        }
+        std::sort(order.begin(), order.end());
+
+        // 2. Preenche os arrays já no tamanho final, face a face na ordem espacial
+        face_index_array_.resize(triCount * 3);
+        triangleToFace_.resize(triCount);
+        faceTriangles_.assign(faces_.size(), {0, 0});
+        int t = 0;
+        for (const auto &entry: order) {
+            const auto &face = faces_[entry.second];
+            faceTriangles_[entry.second][0] = t;
+            for (size_t i = 1; i + 1 < face.size(); ++i, ++t) {
+                face_index_array_[t * 3 + 0] = face[0]; // Pivô do leque
+                face_index_array_[t * 3 + 1] = face[i];
+                face_index_array_[t * 3 + 2] = face[i + 1];
+                triangleToFace_[t] = entry.second;
             }
+            faceTriangles_[entry.second][1] = t;
         }
-        return triangles;
     }
 
     // ============================================================
@@ -129,6 +191,7 @@ namespace object {
 
         // Upload dos dados para a VRAM
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        countUpload(static_cast<size_t>(width) * height * nrChannels);
 
         // Salva uma cópia dos pixels na RAM (CPU) para o Path Tracer.
         // O Ray Tracing roda na CPU e não consegue ler a memória da GPU diretamente.
@@ -157,6 +220,21 @@ namespace object {
     // ============================================================
 
     void Object::draw(const ColorsMap &colors, bool vertexOnlyMode, bool faceOnlyMode) {
+        if (edgeIboSinglePass_) {
+            edgeIboSinglePass_ = false; // Volta do wireframe em passada única: IBO com todas as arestas
+            if (!geometryDirty_) uploadEdgeIndices();
+        }
+        if (compactGeometry_) {
+            compactGeometry_ = false; // O pipeline fixo lê floats e índices de 32 bits
+            geometryDirty_ = true;
+            textureBatchesDirty_ = true;
+        }
+        setVertexDefaultColor(colors.count("vertex") ? colors.at("vertex") : Color{0.0f, 0.0f, 0.0f});
+        {
+            ScopedCpuTimer timer(currentTimings_.rebuildMs);
+            syncGpuBuffers(); // Envia apenas o que mudou desde o último frame
+        }
+
         glPushMatrix(); // Salva a matriz atual da câmera
 
         // Aplica Transformações de Modelo (Model Matrix)
@@ -167,38 +245,251 @@ namespace object {
         // Camada 1: Faces Sólidas (Preenchimento)
         if (!vertexOnlyMode) {
             Color faceColor = colors.count("surface") ? colors.at("surface") : Color{1.0f, 0.0f, 0.0f};
+            beginPass(PASS_FACES);
             drawFacesVBO(faceColor, vertexOnlyMode);
+            endPass(PASS_FACES);
+            currentTimings_.triangles += static_cast<int>(triangleToFace_.size());
+            currentTimings_.drawCalls++;
         }
 
         // Camada 2: Arestas (Wireframe)
         // Desenhado por cima das faces para destacar a topologia
         Color edgeColor = colors.count("edge") ? colors.at("edge") : Color{0.0f, 0.0f, 0.0f};
+        beginPass(PASS_EDGES);
         drawEdgesVBO(edgeColor);
+        endPass(PASS_EDGES);
+        currentTimings_.lines += static_cast<int>(edgeIndexCount_ / 2);
+        currentTimings_.drawCalls++;
 
         // Camada 3: Vértices (Nuvem de Pontos)
         if (!faceOnlyMode) {
-            Color vertexColor = colors.count("vertex") ? colors.at("vertex") : Color{0.0f, 0.0f, 0.0f};
-            drawVerticesVBO(vertexColor);
+            beginPass(PASS_VERTICES);
+            drawVerticesVBO();
+            endPass(PASS_VERTICES);
+            currentTimings_.points += static_cast<int>(vertices_.size());
+            currentTimings_.drawCalls += drawnSelectedVertices_.empty() ? 1 : 2;
         }
 
+        // Buffer de IDs do picking (só renderiza se a câmera ou a geometria mudaram)
+        math_utils::Mat4 projection, modelView;
+        glGetFloatv(GL_PROJECTION_MATRIX, projection.data());
+        glGetFloatv(GL_MODELVIEW_MATRIX, modelView.data());
+        beginPass(PASS_PICKING);
+        updatePickBuffer(projection, modelView);
+        endPass(PASS_PICKING);
+
         glPopMatrix();
     }
 
-    // Desenha a geometria sólida usando triângulos
+    // Shaders das faces. O perfil de compatibilidade mantém as matrizes do pipeline fixo
+    // (glTranslatef/glRotatef da câmera) e o gl_PrimitiveID indexa o triângulo no IBO.
+    static const char *FACE_VERTEX_SHADER = R"(
+#version 150 compatibility
+in float aOcclusion;
+out float vOcclusion;
+void main() {
+    vOcclusion = aOcclusion;
+    gl_Position = ftransform();
+}
+)";
+
+    static const char *FACE_FRAGMENT_SHADER = R"(
+#version 150 compatibility
+uniform isamplerBuffer uTriangleFace;
+uniform samplerBuffer uFaceColor;
+uniform float uUseAO;
+in float vOcclusion;
+void main() {
+    int face = texelFetch(uTriangleFace, gl_PrimitiveID).r;
+    vec3 color = texelFetch(uFaceColor, face).rgb;
+    gl_FragColor = vec4(color * mix(1.0, vOcclusion, uUseAO), 1.0);
+}
+)";
+
+    static GLuint compileShader(GLenum type, const char *source, const char *label) {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        GLint ok = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        if (!ok) {
+            char log[1024];
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            std::cerr << "Erro ao compilar shader " << label << ": " << log << std::endl;
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    // Compila e liga um programa (vertex + fragment, e geometry se informado). Retorna 0 em caso de erro.
+    static GLuint buildProgram(const char *vertexSource, const char *fragmentSource, const char *label,
+                               const char *geometrySource = nullptr) {
+        GLuint vs = compileShader(GL_VERTEX_SHADER, vertexSource, label);
+        GLuint fs = compileShader(GL_FRAGMENT_SHADER, fragmentSource, label);
+        GLuint gs = geometrySource ? compileShader(GL_GEOMETRY_SHADER, geometrySource, label) : 0;
+        if (!vs || !fs || (geometrySource && !gs)) {
+            if (vs) glDeleteShader(vs);
+            if (fs) glDeleteShader(fs);
+            if (gs) glDeleteShader(gs);
+            return 0;
+        }
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vs);
+        glAttachShader(program, fs);
+        if (gs) glAttachShader(program, gs);
+        glLinkProgram(program);
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+        if (gs) glDeleteShader(gs);
+        GLint ok = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        if (!ok) {
+            char log[1024];
+            glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+            std::cerr << "Erro ao ligar shader " << label << ": " << log << std::endl;
+            glDeleteProgram(program);
+            return 0;
+        }
+        return program;
+    }
+
+    // Compila o programa das faces na primeira vez em que é necessário (precisa do contexto GL).
+    bool Object::initFaceProgram() {
+        if (faceProgramState_ != 0) return faceProgramState_ == 1;
+        faceProgramState_ = -1;
+        if (!GLEW_VERSION_3_2) {
+            std::cout << "OpenGL 3.2 indisponivel: faces em modo imediato." << std::endl;
+            return false;
+        }
+
+        GLuint program = buildProgram(FACE_VERTEX_SHADER, FACE_FRAGMENT_SHADER, "das faces");
+        if (!program) return false;
+
+        // Unidades fixas dos texture buffers (1 = triângulo -> face, 2 = cor da face)
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "uTriangleFace"), 1);
+        glUniform1i(glGetUniformLocation(program, "uFaceColor"), 2);
+        glUseProgram(0);
+        aoAttribLocation_ = glGetAttribLocation(program, "aOcclusion");
+        useAOLocation_ = glGetUniformLocation(program, "uUseAO");
+
+        shaderProgram_ = program;
+        faceProgramState_ = 1;
+        return true;
+    }
+
+    // Shaders do buffer de IDs do picking: escrevem inteiros de 32 bits (ID + 1; 0 = fundo).
+    // Faces gravam o índice do triângulo (gl_PrimitiveID); pontos gravam o índice do vértice.
+    static const char *PICK_VERTEX_SHADER = R"(
+#version 150
+in vec3 aPosition;
+uniform mat4 uMVP;
+flat out int vVertex;
+void main() {
+    vVertex = gl_VertexID;
+    gl_PointSize = 10.0; // Pontos grandes facilitam o clique
+    gl_Position = uMVP * vec4(aPosition, 1.0);
+}
+)";
+
+    // Mesmo shader para as posições quantizadas do renderizador core (ObjectQuantization.cpp)
+    static const char *PICK_COMPACT_VERTEX_SHADER = R"(
+#version 150
+in uvec4 aPosition;
+uniform mat4 uMVP;
+uniform samplerBuffer uChunkBoxes;
+flat out int vVertex;
+void main() {
+    int box = int(aPosition.w) * 2;
+    vec3 position = texelFetch(uChunkBoxes, box).xyz + vec3(aPosition.xyz) * texelFetch(uChunkBoxes, box + 1).xyz;
+    vVertex = gl_VertexID;
+    gl_PointSize = 10.0;
+    gl_Position = uMVP * vec4(position, 1.0);
+}
+)";
+
+    static const char *PICK_FRAGMENT_SHADER = R"(
+#version 150
+uniform int uPoints;
+uniform int uTriangleBase; // Primeiro triângulo da chamada (o IBO é desenhado em trechos)
+flat in int vVertex;
+out uvec4 fragId;
+void main() {
+    fragId = uvec4(uint(uPoints == 1 ? vVertex : uTriangleBase + gl_PrimitiveID) + 1u, 0u, 0u, 0u);
+}
+)";
+
+    bool Object::initPickProgram() {
+        if (pickBuffer_.state != 0) return pickBuffer_.state == 1;
+        pickBuffer_.state = -1;
+        if (!GLEW_VERSION_3_2) return false; // Sem alvos inteiros: color picking legado
+
+        // Programa para o formato atual da geometria; refeito se o formato mudar (updatePickBuffer)
+        pickBuffer_.compact = compactGeometry_;
+        pickBuffer_.program = buildProgram(compactGeometry_ ? PICK_COMPACT_VERTEX_SHADER : PICK_VERTEX_SHADER,
+                                           PICK_FRAGMENT_SHADER, "do picking");
+        if (!pickBuffer_.program) return false;
+        glUseProgram(pickBuffer_.program);
+        glUniform1i(glGetUniformLocation(pickBuffer_.program, "uChunkBoxes"), 4);
+        glUseProgram(0);
+        pickBuffer_.triangleBaseLocation = glGetUniformLocation(pickBuffer_.program, "uTriangleBase");
+        pickBuffer_.pointsLocation = glGetUniformLocation(pickBuffer_.program, "uPoints");
+        pickBuffer_.mvpLocation = glGetUniformLocation(pickBuffer_.program, "uMVP");
+        pickBuffer_.positionLocation = glGetAttribLocation(pickBuffer_.program, "aPosition");
+        pickBuffer_.state = 1;
+        return true;
+    }
+
+    // Desenha a geometria sólida: um único glDrawElements sobre o VBO/IBO já na GPU
     void Object::drawFacesVBO(const Color &defaultColor, bool vertexOnlyMode) {
         if (vertexOnlyMode) return;
+        if (!initFaceProgram()) {
+            drawFacesImmediate(defaultColor);
+            return;
+        }
 
-        auto tri_faces = triangulateFaces(faces_);
+        glUseProgram(shaderProgram_);
+        glUniform1f(useAOLocation_, aoEnabled_ && vertexAO_.size() == vertices_.size() ? 1.0f : 0.0f);
 
-        glBegin(GL_TRIANGLES); // Modo imediato (para flexibilidade de cor por face)
-        for (size_t i = 0; i < tri_faces.size(); ++i) {
-            // Descobre qual face original é dona deste triângulo
-            int origFace = static_cast<int>(i);
-            auto it = faceTriangleMap.find(static_cast<int>(i));
-            if (it != faceTriangleMap.end())
-                origFace = it->second;
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_BUFFER, tex_triangle_face_);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_BUFFER, tex_face_colors_);
+        glActiveTexture(GL_TEXTURE0);
 
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices_);
+        glVertexPointer(3, GL_FLOAT, 0, nullptr);
+        if (aoAttribLocation_ >= 0) {
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_ao_);
+            glEnableVertexAttribArray(aoAttribLocation_);
+            glVertexAttribPointer(aoAttribLocation_, 1, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_faces_);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(face_index_array_.size()), GL_UNSIGNED_INT, nullptr);
+
+        if (aoAttribLocation_ >= 0) glDisableVertexAttribArray(aoAttribLocation_);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glUseProgram(0);
+    }
+
+    // Caminho de compatibilidade (sem shaders): modo imediato, mas com a triangulação em cache
+    void Object::drawFacesImmediate(const Color &defaultColor) {
+        bool useAO = aoEnabled_ && vertexAO_.size() == vertices_.size();
+
+        glBegin(GL_TRIANGLES); // Modo imediato (para flexibilidade de cor por face)
+        for (size_t i = 0; i < triangleToFace_.size(); ++i) {
             // Lógica de Cor: Usa cor específica da face ou padrão
+            int origFace = triangleToFace_[i];
             Color col = defaultColor;
             if (origFace < static_cast<int>(faceColors.size()))
                 col = faceColors[origFace];
@@ -207,7 +498,12 @@ namespace object {
 
             // Envia os 3 vértices do triângulo
             for (int j = 0; j < 3; ++j) {
-                unsigned int vertexIndex = tri_faces[i][j];
+                unsigned int vertexIndex = face_index_array_[i * 3 + j];
+                // Oclusão ambiente pré-calculada escurece a cor da face por vértice
+                if (useAO) {
+                    float ao = vertexAO_[vertexIndex] < 0.0f ? 1.0f : vertexAO_[vertexIndex];
+                    glColor3f(col[0] * ao, col[1] * ao, col[2] * ao);
+                }
                 const std::array<float, 3> &vertex = vertices_[vertexIndex];
                 glVertex3f(vertex[0], vertex[1], vertex[2]);
             }
@@ -215,48 +511,151 @@ namespace object {
         glEnd();
     }
 
-    // Desenha texturas projetadas sobre as faces
-    void Object::drawTexturedFaces() {
-        if (face_texture_map_.empty()) return;
-        glEnable(GL_TEXTURE_2D);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDepthFunc(GL_LEQUAL);
-        glColor3f(1.0f, 1.0f, 1.0f);
+    // Refaz os lotes por textura: cada face texturizada vira triângulos em leque com
+    // (x, y, z, u, v) por canto. As UVs são por face, então os cantos não são compartilhados
+    // (glDrawArrays sem índices) e as faces de uma mesma textura ficam contíguas no VBO.
+    void Object::rebuildTextureBatches() {
+        textureBatchesDirty_ = false;
+        textureBatches_.clear();
+        texturedFaceFirstCorner_.assign(faces_.size(), -1);
 
+        // 1. Agrupa as faces por textura
+        std::map<GLuint, std::vector<int>> facesByTexture;
         for (auto const &[faceIdx, texID]: face_texture_map_) {
             if (faceIdx < 0 || faceIdx >= static_cast<int>(faces_.size())) continue;
+            if (faces_[faceIdx].size() < 3 || face_uv_map_.find(faceIdx) == face_uv_map_.end()) continue;
+            facesByTexture[texID].push_back(faceIdx);
+        }
 
-            // Se a face está selecionada, NÃO desenhamos a textura.
-            bool isSelected = false;
-            for (int s: selectedFaces) {
-                if (s == faceIdx) {
-                    isSelected = true;
-                    break;
+        // 2. Intercala posição e UV, um lote contíguo por textura. No formato compacto vai o índice
+        // do vértice no lugar da posição: o shader lê a posição quantizada do VBO da malha, e a
+        // textura cai exatamente sobre a face (mesmo Z, sem z-fighting com o glDepthFunc(GL_LEQUAL))
+        const size_t stride = compactGeometry_ ? 3 : 5; // Floats por canto
+        std::vector<float> data;
+        for (auto const &[texID, faceList]: facesByTexture) {
+            TextureBatch batch{texID, static_cast<GLint>(data.size() / stride), 0};
+            for (int faceIdx: faceList) {
+                const auto &face = faces_[faceIdx];
+                const auto &uvs = face_uv_map_[faceIdx];
+                texturedFaceFirstCorner_[faceIdx] = static_cast<int>(data.size() / stride);
+                for (size_t k = 1; k + 1 < face.size(); ++k) {
+                    for (size_t c: {size_t(0), k, k + 1}) {
+                        Vec2 uv = c < uvs.size() ? uvs[c] : Vec2{0.0f, 0.0f};
+                        if (compactGeometry_) {
+                            float index; // Bits do índice (lido como uint no shader)
+                            std::memcpy(&index, &face[c], sizeof(float));
+                            data.insert(data.end(), {index, uv.u, uv.v});
+                        } else {
+                            const auto &v = vertices_[face[c]];
+                            data.insert(data.end(), {v[0], v[1], v[2], uv.u, uv.v});
+                        }
+                    }
                 }
             }
-            if (isSelected) continue;
-
-            const auto &face = faces_[faceIdx];
-            // Verifica se existem coordenadas UV geradas para esta face
-            if (face_uv_map_.find(faceIdx) == face_uv_map_.end()) continue;
-            const auto &uvs = face_uv_map_[faceIdx];
-
-            // Vincula a textura correta
-            glBindTexture(GL_TEXTURE_2D, texID);
-
-            glBegin(GL_POLYGON);
-            for (size_t i = 0; i < face.size(); ++i) {
-                // Envia coordenada de textura (UV) antes do vértice
-                if (i < uvs.size()) glTexCoord2f(uvs[i].u, uvs[i].v);
-                int vIdx = face[i];
-                glVertex3f(vertices_[vIdx][0], vertices_[vIdx][1], vertices_[vIdx][2]);
+            batch.count = static_cast<GLsizei>(data.size() / stride) - batch.first;
+            textureBatches_.push_back(batch);
+        }
+
+        if (vbo_textured_ == 0) glGenBuffers(1, &vbo_textured_);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_textured_);
+        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_STATIC_DRAW);
+        countUpload(data.size() * sizeof(float));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        // 3. Máscara completa (a seleção é reaplicada por syncTextureMask)
+        texturedMask_.assign(data.size() / stride * 4, 255);
+        drawnMaskedFaces_.clear();
+        texturedMaskDirty_.markAll();
+    }
+
+    // Compara a seleção de faces com a aplicada na máscara e troca o alfa só dos cantos
+    // das faces que entraram ou saíram (envio parcial, os lotes não são refeitos).
+    void Object::syncTextureMask() {
+        auto setMask = [this](int faceIdx, unsigned char alpha) {
+            if (faceIdx < 0 || faceIdx >= static_cast<int>(texturedFaceFirstCorner_.size())) return;
+            int first = texturedFaceFirstCorner_[faceIdx];
+            if (first < 0) return;
+            int corners = (static_cast<int>(faces_[faceIdx].size()) - 2) * 3;
+            for (int c = first; c < first + corners; ++c) {
+                texturedMask_[c * 4 + 3] = alpha;
+                texturedMaskDirty_.mark(c);
+            }
+        };
+        if (selectedFaces != drawnMaskedFaces_) {
+            for (int f: drawnMaskedFaces_) setMask(f, 255);
+            for (int f: selectedFaces) setMask(f, 0);
+            drawnMaskedFaces_ = selectedFaces;
+        }
+        if (texturedMaskDirty_.empty()) return;
+
+        size_t corners = texturedMask_.size() / 4;
+        if (vbo_textured_mask_ == 0) glGenBuffers(1, &vbo_textured_mask_);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_textured_mask_);
+        if (texturedMaskDirty_.all) {
+            glBufferData(GL_ARRAY_BUFFER, texturedMask_.size(), texturedMask_.data(), GL_DYNAMIC_DRAW);
+            countUpload(texturedMask_.size());
+        } else {
+            for (const auto &[begin, end]: texturedMaskDirty_.spans(corners)) {
+                glBufferSubData(GL_ARRAY_BUFFER, begin * 4, (end - begin) * 4, &texturedMask_[begin * 4]);
+                countUpload((end - begin) * 4);
             }
-            glEnd();
         }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        texturedMaskDirty_.clear();
+    }
+
+    // Desenha as texturas projetadas sobre as faces: um glDrawArrays por textura.
+    // Se a face está selecionada, a textura NÃO aparece (alfa 0 da máscara descartado
+    // pelo alpha test), deixando o vermelho da seleção visível.
+    void Object::drawTexturedFaces() {
+        {
+            ScopedCpuTimer timer(currentTimings_.rebuildMs);
+            if (textureBatchesDirty_) rebuildTextureBatches();
+            if (textureBatches_.empty()) return;
+            syncTextureMask();
+        }
+        beginPass(PASS_TEXTURES);
+
+        glPushMatrix();
+        glTranslatef(position_[0], position_[1], position_[2]); // Mesma matriz de modelo de draw()
+        glScalef(scale_, scale_, scale_);
+
+        glEnable(GL_TEXTURE_2D);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glEnable(GL_ALPHA_TEST);
+        glAlphaFunc(GL_GREATER, 0.0f);
+        glDepthFunc(GL_LEQUAL);
+
+        const GLsizei stride = 5 * sizeof(float);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_textured_);
+        glVertexPointer(3, GL_FLOAT, stride, nullptr);
+        glTexCoordPointer(2, GL_FLOAT, stride, reinterpret_cast<void *>(3 * sizeof(float)));
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_textured_mask_);
+        glColorPointer(4, GL_UNSIGNED_BYTE, 0, nullptr);
+
+        for (const auto &batch: textureBatches_) {
+            glBindTexture(GL_TEXTURE_2D, batch.texture); // Vincula a textura do lote
+            glDrawArrays(GL_TRIANGLES, batch.first, batch.count);
+            currentTimings_.triangles += batch.count / 3;
+            currentTimings_.drawCalls++;
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glColor4f(1.0f, 1.0f, 1.0f, 1.0f); // A cor corrente fica indefinida após o color array
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDisable(GL_ALPHA_TEST);
         glDisable(GL_TEXTURE_2D);
         glDisable(GL_BLEND);
         glDepthFunc(GL_LESS);
+        glPopMatrix();
+        endPass(PASS_TEXTURES);
     }
 
     // Desenha o esqueleto da malha (Wireframe)
@@ -268,54 +667,50 @@ namespace object {
         glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices_);
         glVertexPointer(3, GL_FLOAT, 0, nullptr);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_edges_);
-        glDrawElements(GL_LINES, static_cast<GLsizei>(edge_index_array_.size()), GL_UNSIGNED_INT, nullptr);
+        glDrawElements(GL_LINES, static_cast<GLsizei>(edgeIndexCount_), GL_UNSIGNED_INT, nullptr);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         glDisableClientState(GL_VERTEX_ARRAY);
     }
 
     // Desenha os vértices como pontos
-    void Object::drawVerticesVBO(const Color &defaultColor) {
+    void Object::drawVerticesVBO() {
+        if (vertices_.empty() || vbo_vertex_colors_ == 0) return;
         float vertex_size = 5.0f;
-        std::unordered_set<int> selectedSet(selectedVertices.begin(), selectedVertices.end());
+        GLsizei count = static_cast<GLsizei>(vertices_.size());
 
-        // --- PASSADA 1: Vértices NÃO Selecionados (Fundo) ---
-        glPointSize(vertex_size); // Define tamanho global para este lote
-        glBegin(GL_POINTS);
-        for (size_t i = 0; i < vertices_.size(); ++i) {
-            // Se for selecionado, pula (será desenhado na Passada 2)
-            if (selectedSet.count(static_cast<int>(i))) continue;
+        glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_POINT_BIT | GL_CURRENT_BIT);
+        glDisable(GL_LIGHTING);
+        glDisable(GL_BLEND); // O alfa guarda o bit de seleção, não transparência
+        glPointSize(vertex_size);
 
-            Color col = defaultColor;
-            if (i < vertexColors.size()) col = vertexColors[i];
-            glColor3f(col[0], col[1], col[2]);
+        // Posições do VBO da malha + cor/seleção por vértice
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices_);
+        glVertexPointer(3, GL_FLOAT, 0, nullptr);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_vertex_colors_);
+        glColorPointer(4, GL_UNSIGNED_BYTE, 0, nullptr);
 
-            glVertex3f(vertices_[i][0], vertices_[i][1], vertices_[i][2]);
-        }
-        glEnd();
+        // --- PASSADA 1: Todos os vértices (com teste de profundidade) ---
+        glDrawArrays(GL_POINTS, 0, count);
 
         // --- PASSADA 2: Vértices SELECIONADOS (Destaque) ---
-        if (!selectedVertices.empty()) {
+        if (!drawnSelectedVertices_.empty()) {
             // [TRUQUE VISUAL] Desabilita Depth Test
             // Faz com que os vértices selecionados sejam desenhados "na frente" de tudo,
             // mesmo que estejam geometricamente atrás de uma face ou linha.
+            // O alpha test descarta os pontos sem o bit de seleção.
             glDisable(GL_DEPTH_TEST);
-
-            glPointSize(vertex_size);
-            glBegin(GL_POINTS);
-            for (int idx: selectedVertices) {
-                if (idx >= 0 && idx < static_cast<int>(vertices_.size())) {
-                    Color col = defaultColor;
-                    if (idx < static_cast<int>(vertexColors.size())) col = vertexColors[idx];
-                    glColor3f(col[0], col[1], col[2]);
-
-                    glVertex3f(vertices_[idx][0], vertices_[idx][1], vertices_[idx][2]);
-                }
-            }
-            glEnd();
-
-            glEnable(GL_DEPTH_TEST); // Restaura Depth Test
+            glEnable(GL_ALPHA_TEST);
+            glAlphaFunc(GL_GREATER, 0.5f);
+            glDrawArrays(GL_POINTS, 0, count);
         }
+
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glPopAttrib(); // Restaura Depth Test, alpha test e cor corrente
     }
 
     // ============================================================
@@ -323,52 +718,703 @@ namespace object {
     // ============================================================
 
     void Object::setupVBOs() {
-        // 1. Flattening: Converte estruturas complexas (vector<vec3>) em arrays planos (vector<float>)
-        vertex_array_.clear();
-        for (const auto &v: vertices_) {
-            vertex_array_.push_back(v[0]);
-            vertex_array_.push_back(v[1]);
-            vertex_array_.push_back(v[2]);
-        }
-
-        // 2. Prepara índices de faces (Triângulos)
-        face_index_array_.clear();
-        auto tri_faces = triangulateFaces(faces_);
-        for (const auto &tri: tri_faces) {
-            face_index_array_.push_back(tri[0]);
-            face_index_array_.push_back(tri[1]);
-            face_index_array_.push_back(tri[2]);
-        }
-
-        // 3. Prepara índices de arestas (Linhas)
-        edge_index_array_.clear();
-        for (const auto &edge: edges_) {
-            edge_index_array_.push_back(edge.first);
-            edge_index_array_.push_back(edge.second);
-        }
-
-        // 4. Gera Handles OpenGL se não existirem
-        if (vbo_vertices_ == 0)
-            glGenBuffers(1, &vbo_vertices_);
-        if (ibo_faces_ == 0)
-            glGenBuffers(1, &ibo_faces_);
-        if (ibo_edges_ == 0)
-            glGenBuffers(1, &ibo_edges_);
-
-        // 5. Upload dos dados
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices_);
-        glBufferData(GL_ARRAY_BUFFER, vertex_array_.size() * sizeof(float), vertex_array_.data(), GL_STATIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_faces_);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, face_index_array_.size() * sizeof(unsigned int), face_index_array_.data(),
-                     GL_STATIC_DRAW);
+        // 1. Blocos de descarte: as caixas também servem à quantização das posições
+        rebuildChunks();
+
+        // 2. Posições: float no pipeline fixo; 16 bits por caixa de bloco no formato compacto
+        if (compactGeometry_) {
+            uploadQuantizedPositions(); // Ver ObjectQuantization.cpp
+        } else {
+            // std::array<float, 3> não tem preenchimento: vertices_ já é o array plano x, y, z
+            if (vbo_vertices_ == 0)
+                glGenBuffers(1, &vbo_vertices_);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices_);
+            glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(vertices_[0]), vertices_.data(), GL_STATIC_DRAW);
+            countUpload(vertices_.size() * sizeof(vertices_[0]));
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        // 3. Os índices de faces (Triângulos) vêm da triangulação em cache (rebuildTriangulation),
+        // refeita apenas quando a topologia muda; aqui só são enviados.
+        uploadTriangleIndices(false);
+
+        // 4. Índices de arestas (Linhas)
+        uploadEdgeIndices();
+
+        // 5. Triângulo -> Face (texture buffer lido com gl_PrimitiveID)
+        if (GLEW_VERSION_3_1) {
+            if (tbo_triangle_face_ == 0) glGenBuffers(1, &tbo_triangle_face_);
+            if (tex_triangle_face_ == 0) glGenTextures(1, &tex_triangle_face_);
+            glBindBuffer(GL_TEXTURE_BUFFER, tbo_triangle_face_);
+            glBufferData(GL_TEXTURE_BUFFER, triangleToFace_.size() * sizeof(int), triangleToFace_.data(),
+                         GL_STATIC_DRAW);
+            countUpload(triangleToFace_.size() * sizeof(int));
+            glBindTexture(GL_TEXTURE_BUFFER, tex_triangle_face_);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, tbo_triangle_face_);
+
+            // Face -> faixa de triângulos (primeiro, fim): o wireframe em passada única distingue
+            // as arestas do polígono das diagonais internas do leque
+            if (tbo_face_triangles_ == 0) glGenBuffers(1, &tbo_face_triangles_);
+            if (tex_face_triangles_ == 0) glGenTextures(1, &tex_face_triangles_);
+            glBindBuffer(GL_TEXTURE_BUFFER, tbo_face_triangles_);
+            glBufferData(GL_TEXTURE_BUFFER, faceTriangles_.size() * sizeof(faceTriangles_[0]), faceTriangles_.data(),
+                         GL_STATIC_DRAW);
+            countUpload(faceTriangles_.size() * sizeof(faceTriangles_[0]));
+            glBindTexture(GL_TEXTURE_BUFFER, tex_face_triangles_);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32I, tbo_face_triangles_);
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        }
+
+        uploadFaceColors();
+        geometryDirty_ = false;
+        pickBuffer_.dirty = true;
+    }
+
+    // IBO das arestas (GL_LINES). No wireframe em passada única as arestas das faces saem do
+    // shader das faces; só as de faces sem triângulos (linhas de 2 vértices) ficam no buffer.
+    // Todas as arestas: edges_ vai direto (cada par são dois unsigned contíguos).
+    void Object::uploadEdgeIndices() {
+        if (ibo_edges_ == 0) glGenBuffers(1, &ibo_edges_);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_edges_);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, edge_index_array_.size() * sizeof(unsigned int), edge_index_array_.data(),
-                     GL_STATIC_DRAW);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        if (edgeIboSinglePass_) {
+            std::vector<unsigned int> lines; // Poucas: só as faces de 2 vértices
+            for (const auto &face: faces_) {
+                if (face.size() != 2) continue;
+                lines.push_back(face[0]);
+                lines.push_back(face[1]);
+            }
+            edgeIndexCount_ = lines.size();
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, lines.size() * sizeof(unsigned int), lines.data(), GL_STATIC_DRAW);
+        } else {
+            edgeIndexCount_ = edges_.size() * 2;
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, edges_.size() * sizeof(edges_[0]), edges_.data(), GL_STATIC_DRAW);
+        }
+        countUpload(edgeIndexCount_ * sizeof(unsigned int));
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 
+    // Converte a cor de uma face para RGBA8 (formato do texture buffer).
+    static void packFaceColor(const Color &c, unsigned char *out) {
+        for (int k = 0; k < 3; ++k)
+            out[k] = static_cast<unsigned char>(std::min(1.0f, std::max(0.0f, c[k])) * 255.0f + 0.5f);
+        out[3] = 255;
+    }
+
+    // Cor do ponto de um vértice em RGBA8, com o bit de seleção no alfa.
+    static void packVertexColor(const Color &c, bool selected, unsigned char *out) {
+        packFaceColor(c, out);
+        out[3] = selected ? 255 : 0;
+    }
+
+    // AO em 8 bits normalizados (-1 = ainda não calculada: sem oclusão).
+    static unsigned char packOcclusion(float ao) {
+        if (ao < 0.0f) return 255;
+        return static_cast<unsigned char>(std::min(1.0f, ao) * 255.0f + 0.5f);
+    }
+
+    // Aloca e envia por completo as cores das faces (RGBA8, uma por face), as cores/seleção
+    // dos pontos e a AO por vértice. Só acontece quando a topologia muda; o resto do tempo
+    // valem os envios parciais abaixo.
+    void Object::uploadFaceColors() {
+        syncVertexSelection(); // Garante o bit de seleção dimensionado para a malha atual
+        faceColorsDirty_.clear();
+        vertexAODirty_.clear();
+        vertexColorsDirty_.clear();
+
+        // Pontos (VBO comum, disponível em qualquer versão com VBOs)
+        std::vector<unsigned char> points(vertices_.size() * 4);
+        for (size_t i = 0; i < vertices_.size(); ++i)
+            packVertexColor(i < vertexColors.size() ? vertexColors[i] : vertexDefaultColor_,
+                            vertexSelected_[i] != 0, &points[i * 4]);
+        if (vbo_vertex_colors_ == 0) glGenBuffers(1, &vbo_vertex_colors_);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_vertex_colors_);
+        glBufferData(GL_ARRAY_BUFFER, points.size(), points.data(), GL_DYNAMIC_DRAW);
+        countUpload(points.size());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        if (!GLEW_VERSION_3_1) return; // Modo imediato lê as cores das faces direto da CPU
+
+        std::vector<unsigned char> rgba(faces_.size() * 4);
+        for (size_t f = 0; f < faces_.size(); ++f)
+            packFaceColor(f < faceColors.size() ? faceColors[f] : Color{0.8f, 0.8f, 0.8f}, &rgba[f * 4]);
+        if (tbo_face_colors_ == 0) glGenBuffers(1, &tbo_face_colors_);
+        if (tex_face_colors_ == 0) glGenTextures(1, &tex_face_colors_);
+        glBindBuffer(GL_TEXTURE_BUFFER, tbo_face_colors_);
+        glBufferData(GL_TEXTURE_BUFFER, rgba.size(), rgba.data(), GL_DYNAMIC_DRAW);
+        countUpload(rgba.size());
+        glBindTexture(GL_TEXTURE_BUFFER, tex_face_colors_);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA8, tbo_face_colors_);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        // AO por vértice em 8 bits normalizados (1 = sem oclusão quando ainda não calculada)
+        std::vector<unsigned char> ao(vertices_.size(), 255);
+        if (vertexAO_.size() == vertices_.size())
+            for (size_t i = 0; i < ao.size(); ++i) ao[i] = packOcclusion(vertexAO_[i]);
+        if (vbo_ao_ == 0) glGenBuffers(1, &vbo_ao_);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_ao_);
+        glBufferData(GL_ARRAY_BUFFER, ao.size(), ao.data(), GL_DYNAMIC_DRAW);
+        countUpload(ao.size());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // Envia apenas os trechos alterados (glBufferSubData). Os buffers de geometria
+    // (vértices e índices) não são tocados quando só a cor ou a seleção muda.
+    void Object::uploadDirtyRanges() {
+        // Cores e bit de seleção dos pontos
+        std::vector<unsigned char> points;
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_vertex_colors_);
+        for (const auto &[begin, end]: vertexColorsDirty_.spans(vertices_.size())) {
+            points.resize((end - begin) * 4);
+            for (size_t i = begin; i < end; ++i)
+                packVertexColor(i < vertexColors.size() ? vertexColors[i] : vertexDefaultColor_,
+                                vertexSelected_[i] != 0, &points[(i - begin) * 4]);
+            glBufferSubData(GL_ARRAY_BUFFER, begin * 4, points.size(), points.data());
+            countUpload(points.size());
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        vertexColorsDirty_.clear();
+
+        if (!GLEW_VERSION_3_1) {
+            faceColorsDirty_.clear();
+            vertexAODirty_.clear();
+            return;
+        }
+
+        // Cores das faces
+        std::vector<unsigned char> rgba;
+        glBindBuffer(GL_TEXTURE_BUFFER, tbo_face_colors_);
+        for (const auto &[begin, end]: faceColorsDirty_.spans(faces_.size())) {
+            rgba.resize((end - begin) * 4);
+            for (size_t f = begin; f < end; ++f)
+                packFaceColor(f < faceColors.size() ? faceColors[f] : Color{0.8f, 0.8f, 0.8f}, &rgba[(f - begin) * 4]);
+            glBufferSubData(GL_TEXTURE_BUFFER, begin * 4, rgba.size(), rgba.data());
+            countUpload(rgba.size());
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        faceColorsDirty_.clear();
+
+        // AO por vértice
+        if (vertexAO_.size() == vertices_.size()) {
+            std::vector<unsigned char> ao;
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_ao_);
+            for (const auto &[begin, end]: vertexAODirty_.spans(vertices_.size())) {
+                ao.resize(end - begin);
+                for (size_t i = begin; i < end; ++i) ao[i - begin] = packOcclusion(vertexAO_[i]);
+                glBufferSubData(GL_ARRAY_BUFFER, begin, ao.size(), ao.data());
+                countUpload(ao.size());
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        vertexAODirty_.clear();
+    }
+
+    // Cor dos pontos sem cor própria (colors["vertex"] de quem desenha). Se mudou, os pontos
+    // são reempacotados no próximo envio.
+    void Object::setVertexDefaultColor(const Color &color) {
+        if (color == vertexDefaultColor_) return;
+        vertexDefaultColor_ = color;
+        vertexColorsDirty_.markAll();
+    }
+
+    // Chamado uma vez por frame: aplica as mudanças acumuladas desde o último desenho.
+    void Object::syncGpuBuffers() {
+        syncVertexSelection();
+        if (geometryDirty_) setupVBOs();
+        else if (!faceColorsDirty_.empty() || !vertexAODirty_.empty() || !vertexColorsDirty_.empty())
+            uploadDirtyRanges();
+    }
+
+    // A seleção de vértices é editada por fora (getSelectedVertices); aqui ela é comparada
+    // à última desenhada e só os vértices que entraram ou saíram têm o bit de seleção trocado.
+    void Object::syncVertexSelection() {
+        if (vertexSelected_.size() != vertices_.size()) {
+            vertexSelected_.assign(vertices_.size(), 0);
+            drawnSelectedVertices_.clear();
+            vertexColorsDirty_.markAll();
+        }
+        if (selectedVertices == drawnSelectedVertices_) return;
+
+        for (int v: drawnSelectedVertices_) {
+            vertexSelected_[v] = 0;
+            vertexColorsDirty_.mark(v);
+        }
+        drawnSelectedVertices_.clear();
+        for (int v: selectedVertices) {
+            if (v < 0 || v >= static_cast<int>(vertices_.size())) continue;
+            vertexSelected_[v] = 1;
+            vertexColorsDirty_.mark(v);
+            drawnSelectedVertices_.push_back(v);
+        }
+    }
+
+    // Força o reenvio de todas as cores (para quem alterou as cores sem marcar os trechos).
     void Object::updateVBOs() {
-        setupVBOs();
+        faceColorsDirty_.markAll();
+        vertexAODirty_.markAll();
+        vertexColorsDirty_.markAll();
+    }
+
+    // ============================================================
+    // 5. RENDERIZADOR CORE PROFILE (VAOs + SHADERS)
+    // ============================================================
+    /*
+     * As mesmas camadas de draw(), sem pipeline fixo: nada de glPushMatrix, ftransform ou
+     * client arrays. Cada camada é um VAO sobre os buffers que o caminho legado já mantém
+     * (vértices, IBOs, AO, cores dos pontos, lotes de textura), então os envios parciais
+     * continuam valendo; a câmera chega como uniform (uMVP = Projeção * Vista * Modelo).
+     * As posições chegam quantizadas (ObjectQuantization.cpp) e são decodificadas no vertex shader.
+     */
+
+    static const char *CORE_FACE_VERTEX_SHADER = R"(
+#version 330 core
+layout(location = 0) in uvec4 aPosition; // xyz em 16 bits na caixa 'w'
+layout(location = 1) in float aOcclusion;
+uniform mat4 uMVP;
+uniform samplerBuffer uChunkBoxes; // Por caixa: (mínimo, passo)
+out float vOcclusion;
+void main() {
+    int box = int(aPosition.w) * 2;
+    vec3 position = texelFetch(uChunkBoxes, box).xyz + vec3(aPosition.xyz) * texelFetch(uChunkBoxes, box + 1).xyz;
+    vOcclusion = aOcclusion;
+    gl_Position = uMVP * vec4(position, 1.0);
+}
+)";
+
+    static const char *CORE_FACE_FRAGMENT_SHADER = R"(
+#version 330 core
+uniform isamplerBuffer uTriangleFace;
+uniform samplerBuffer uFaceColor;
+uniform float uUseAO;
+uniform int uTriangleBase; // Primeiro triângulo da faixa desenhada (gl_PrimitiveID recomeça em 0)
+in float vOcclusion;
+out vec4 fragColor;
+void main() {
+    int face = texelFetch(uTriangleFace, uTriangleBase + gl_PrimitiveID).r;
+    vec3 color = texelFetch(uFaceColor, face).rgb;
+    fragColor = vec4(color * mix(1.0, vOcclusion, uUseAO), 1.0);
+}
+)";
+
+    // Wireframe em passada única: o geometry shader dá a cada canto a sua altura (em pixels)
+    // até a aresta oposta; interpolada sem perspectiva, vira a distância do fragmento a cada
+    // aresta do triângulo (coordenadas baricêntricas escaladas).
+    static const char *CORE_FACE_WIRE_GEOMETRY_SHADER = R"(
+#version 330 core
+layout(triangles) in;
+layout(triangle_strip, max_vertices = 3) out;
+uniform vec2 uViewport;
+in float vOcclusion[];
+out float gOcclusion;
+noperspective out vec3 gEdgeDistance;
+void main() {
+    vec2 p[3];
+    bool behind = false;
+    for (int i = 0; i < 3; ++i) {
+        behind = behind || gl_in[i].gl_Position.w <= 0.0;
+        p[i] = gl_in[i].gl_Position.xy / gl_in[i].gl_Position.w * 0.5 * uViewport;
+    }
+    // Altura = 2 * área / comprimento da aresta oposta
+    float area2 = abs((p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[2].x - p[0].x) * (p[1].y - p[0].y));
+    vec3 h = area2 / max(vec3(length(p[2] - p[1]), length(p[2] - p[0]), length(p[1] - p[0])), vec3(1e-6));
+    for (int i = 0; i < 3; ++i) {
+        vec3 d = vec3(0.0);
+        d[i] = h[i];
+        gl_Position = gl_in[i].gl_Position;
+        gl_PrimitiveID = gl_PrimitiveIDIn;
+        gOcclusion = vOcclusion[i];
+        gEdgeDistance = behind ? vec3(1e6) : d; // Atravessa a câmera: sem aresta
+        EmitVertex();
+    }
+    EndPrimitive();
+}
+)";
+
+    static const char *CORE_FACE_WIRE_FRAGMENT_SHADER = R"(
+#version 330 core
+uniform isamplerBuffer uTriangleFace;
+uniform samplerBuffer uFaceColor;
+uniform isamplerBuffer uFaceTriangles; // (primeiro, fim) de cada face
+uniform float uUseAO;
+uniform vec3 uEdgeColor;
+uniform float uLineWidth;
+uniform int uTriangleBase;
+uniform int uLodBase; // Daqui em diante, níveis simplificados do LOD: todas as arestas aparecem
+in float gOcclusion;
+noperspective in vec3 gEdgeDistance;
+out vec4 fragColor;
+void main() {
+    int triangle = uTriangleBase + gl_PrimitiveID;
+    int face = texelFetch(uTriangleFace, triangle).r;
+    vec3 color = texelFetch(uFaceColor, face).rgb * mix(1.0, gOcclusion, uUseAO);
+    // Leque (0, k+1, k+2): a aresta oposta ao pivô é sempre do polígono; as outras duas só
+    // no primeiro/último triângulo da face (nos demais são diagonais internas)
+    ivec2 range = texelFetch(uFaceTriangles, face).rg;
+    int first = range.x, last = range.y - 1;
+    float d = gEdgeDistance.x;
+    if (triangle == last || triangle >= uLodBase) d = min(d, gEdgeDistance.y);
+    if (triangle == first || triangle >= uLodBase) d = min(d, gEdgeDistance.z);
+    // Cada triângulo pinta meia largura do seu lado: arestas compartilhadas somam a largura
+    // toda, como a linha de GL_LINES centrada na aresta
+    float edge = clamp(0.5 * uLineWidth - d, 0.0, 1.0);
+    fragColor = vec4(mix(color, uEdgeColor, edge), 1.0);
+}
+)";
+
+    // Arestas (cor uniforme) e pontos (cor por vértice, bit de seleção no alfa)
+    static const char *CORE_WIRE_VERTEX_SHADER = R"(
+#version 330 core
+layout(location = 0) in uvec4 aPosition;
+layout(location = 2) in vec4 aColor;
+uniform mat4 uMVP;
+uniform samplerBuffer uChunkBoxes;
+uniform float uPointSize;
+out vec4 vColor;
+void main() {
+    int box = int(aPosition.w) * 2;
+    vec3 position = texelFetch(uChunkBoxes, box).xyz + vec3(aPosition.xyz) * texelFetch(uChunkBoxes, box + 1).xyz;
+    vColor = aColor;
+    gl_PointSize = uPointSize;
+    gl_Position = uMVP * vec4(position, 1.0);
+}
+)";
+
+    static const char *CORE_WIRE_FRAGMENT_SHADER = R"(
+#version 330 core
+uniform vec4 uColor;
+uniform int uUseVertexColor;
+uniform int uSelectedOnly;
+in vec4 vColor;
+out vec4 fragColor;
+void main() {
+    vec4 color = uUseVertexColor == 1 ? vColor : uColor;
+    if (uSelectedOnly == 1 && color.a <= 0.5) discard; // Substitui o alpha test
+    fragColor = vec4(color.rgb, 1.0);
+}
+)";
+
+    // Lotes de textura: a máscara (alfa 0 = face selecionada) multiplica a textura. A posição
+    // vem do VBO da malha (visto como texture buffer) pelo índice do vértice de cada canto.
+    static const char *CORE_TEXTURE_VERTEX_SHADER = R"(
+#version 330 core
+layout(location = 0) in uint aVertex;
+layout(location = 2) in vec4 aMask;
+layout(location = 3) in vec2 aUV;
+uniform mat4 uMVP;
+uniform usamplerBuffer uPackedPositions;
+uniform samplerBuffer uChunkBoxes;
+out vec4 vMask;
+out vec2 vUV;
+void main() {
+    uvec4 q = texelFetch(uPackedPositions, int(aVertex));
+    int box = int(q.w) * 2;
+    vec3 position = texelFetch(uChunkBoxes, box).xyz + vec3(q.xyz) * texelFetch(uChunkBoxes, box + 1).xyz;
+    vMask = aMask;
+    vUV = aUV;
+    gl_Position = uMVP * vec4(position, 1.0);
+}
+)";
+
+    static const char *CORE_TEXTURE_FRAGMENT_SHADER = R"(
+#version 330 core
+uniform sampler2D uTexture;
+in vec4 vMask;
+in vec2 vUV;
+out vec4 fragColor;
+void main() {
+    vec4 color = texture(uTexture, vUV) * vMask;
+    if (color.a <= 0.0) discard;
+    fragColor = color;
+}
+)";
+
+    // Compila os programas e cria os VAOs na primeira vez em que é necessário.
+    bool Object::initCoreRenderer() {
+        CoreRenderer &core = core_;
+        if (core.state != 0) return core.state == 1;
+        core.state = -1;
+        if (!GLEW_VERSION_3_3) {
+            std::cout << "OpenGL 3.3 indisponivel: usando o pipeline fixo." << std::endl;
+            return false;
+        }
+
+        core.faceProgram = buildProgram(CORE_FACE_VERTEX_SHADER, CORE_FACE_FRAGMENT_SHADER, "das faces (core)");
+        core.wireProgram = buildProgram(CORE_WIRE_VERTEX_SHADER, CORE_WIRE_FRAGMENT_SHADER, "das arestas (core)");
+        core.textureProgram = buildProgram(CORE_TEXTURE_VERTEX_SHADER, CORE_TEXTURE_FRAGMENT_SHADER,
+                                           "das texturas (core)");
+        if (!core.faceProgram || !core.wireProgram || !core.textureProgram) {
+            for (GLuint program: {core.faceProgram, core.wireProgram, core.textureProgram})
+                if (program) glDeleteProgram(program);
+            return false;
+        }
+
+        // Unidades fixas: 0 = textura do lote, 1 = triângulo -> face, 2 = cor da face,
+        // 4 = caixas da quantização, 5 = posições quantizadas (lotes de textura)
+        glUseProgram(core.faceProgram);
+        glUniform1i(glGetUniformLocation(core.faceProgram, "uTriangleFace"), 1);
+        glUniform1i(glGetUniformLocation(core.faceProgram, "uFaceColor"), 2);
+        glUniform1i(glGetUniformLocation(core.faceProgram, "uChunkBoxes"), 4);
+        glUseProgram(core.wireProgram);
+        glUniform1i(glGetUniformLocation(core.wireProgram, "uChunkBoxes"), 4);
+        glUseProgram(core.textureProgram);
+        glUniform1i(glGetUniformLocation(core.textureProgram, "uTexture"), 0);
+        glUniform1i(glGetUniformLocation(core.textureProgram, "uChunkBoxes"), 4);
+        glUniform1i(glGetUniformLocation(core.textureProgram, "uPackedPositions"), 5);
+        glUseProgram(0);
+
+        core.faceMvp = glGetUniformLocation(core.faceProgram, "uMVP");
+        core.faceUseAO = glGetUniformLocation(core.faceProgram, "uUseAO");
+        core.faceTriangleBase = glGetUniformLocation(core.faceProgram, "uTriangleBase");
+        core.wireMvp = glGetUniformLocation(core.wireProgram, "uMVP");
+        core.wireColor = glGetUniformLocation(core.wireProgram, "uColor");
+        core.wirePointSize = glGetUniformLocation(core.wireProgram, "uPointSize");
+        core.wireUseVertexColor = glGetUniformLocation(core.wireProgram, "uUseVertexColor");
+        core.wireSelectedOnly = glGetUniformLocation(core.wireProgram, "uSelectedOnly");
+        core.textureMvp = glGetUniformLocation(core.textureProgram, "uMVP");
+
+        // Opcional: sem ele, o wireframe continua na passada de GL_LINES
+        core.faceWireProgram = buildProgram(CORE_FACE_VERTEX_SHADER, CORE_FACE_WIRE_FRAGMENT_SHADER,
+                                            "do wireframe (core)", CORE_FACE_WIRE_GEOMETRY_SHADER);
+        if (core.faceWireProgram) {
+            glUseProgram(core.faceWireProgram);
+            glUniform1i(glGetUniformLocation(core.faceWireProgram, "uTriangleFace"), 1);
+            glUniform1i(glGetUniformLocation(core.faceWireProgram, "uFaceColor"), 2);
+            glUniform1i(glGetUniformLocation(core.faceWireProgram, "uFaceTriangles"), 3);
+            glUniform1i(glGetUniformLocation(core.faceWireProgram, "uChunkBoxes"), 4);
+            glUseProgram(0);
+            core.faceWireMvp = glGetUniformLocation(core.faceWireProgram, "uMVP");
+            core.faceWireUseAO = glGetUniformLocation(core.faceWireProgram, "uUseAO");
+            core.faceWireViewport = glGetUniformLocation(core.faceWireProgram, "uViewport");
+            core.faceWireEdgeColor = glGetUniformLocation(core.faceWireProgram, "uEdgeColor");
+            core.faceWireLineWidth = glGetUniformLocation(core.faceWireProgram, "uLineWidth");
+            core.faceWireTriangleBase = glGetUniformLocation(core.faceWireProgram, "uTriangleBase");
+            core.faceWireLodBase = glGetUniformLocation(core.faceWireProgram, "uLodBase");
+        }
+
+        glGenVertexArrays(1, &core.meshVao);
+        glGenVertexArrays(1, &core.edgeVao);
+        glGenVertexArrays(1, &core.textureVao);
+        core.state = 1;
+        return true;
+    }
+
+    // Liga os VAOs aos buffers. Os nomes dos buffers não mudam depois de criados (os reenvios
+    // usam glBufferData/glBufferSubData sobre o mesmo nome), então cada VAO é configurado uma vez.
+    void Object::setupCoreVertexArrays() {
+        CoreRenderer &core = core_;
+        if (!core.meshVaoReady && vbo_vertices_ != 0 && vbo_ao_ != 0 && vbo_vertex_colors_ != 0) {
+            // Faces e pontos: posição quantizada (0), AO (1), cor/seleção do ponto (2) + IBO das faces
+            glBindVertexArray(core.meshVao);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices_);
+            glEnableVertexAttribArray(0);
+            glVertexAttribIPointer(0, 4, GL_UNSIGNED_SHORT, 0, nullptr);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_ao_);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 1, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_vertex_colors_);
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_faces_);
+
+            // Arestas: só a posição + IBO das arestas
+            glBindVertexArray(core.edgeVao);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices_);
+            glEnableVertexAttribArray(0);
+            glVertexAttribIPointer(0, 4, GL_UNSIGNED_SHORT, 0, nullptr);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_edges_);
+            core.meshVaoReady = true;
+        }
+        if (!core.textureVaoReady && vbo_textured_ != 0 && vbo_textured_mask_ != 0) {
+            // Lotes de textura: índice do vértice (0) e UV (3) intercalados, máscara (2)
+            const GLsizei stride = 3 * sizeof(float);
+            glBindVertexArray(core.textureVao);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_textured_);
+            glEnableVertexAttribArray(0);
+            glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, stride, nullptr);
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void *>(sizeof(float)));
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_textured_mask_);
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
+            core.textureVaoReady = true;
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    bool Object::drawCore(const math_utils::Mat4 &projection, const math_utils::Mat4 &view,
+                          const ColorsMap &colors, bool vertexOnlyMode, bool faceOnlyMode) {
+        if (!initCoreRenderer()) return false;
+        if (!compactGeometry_) {
+            compactGeometry_ = true; // Formato compacto (ObjectQuantization.cpp), reenviado abaixo
+            geometryDirty_ = true;
+            textureBatchesDirty_ = true;
+        }
+        bool singlePass = singlePassWireframe_ && !vertexOnlyMode && core_.faceWireProgram != 0;
+        if (singlePass != edgeIboSinglePass_) {
+            edgeIboSinglePass_ = singlePass; // O IBO de arestas muda de conteúdo
+            if (!geometryDirty_) uploadEdgeIndices();
+        }
+        setVertexDefaultColor(colors.count("vertex") ? colors.at("vertex") : Color{0.0f, 0.0f, 0.0f});
+        {
+            ScopedCpuTimer timer(currentTimings_.rebuildMs);
+            syncGpuBuffers(); // Envia apenas o que mudou desde o último frame
+            if (lodSettings_.enabled && lodDirty_) rebuildLod(); // Níveis de detalhe (ver ObjectLod.cpp)
+            setupCoreVertexArrays();
+        }
+        const CoreRenderer &core = core_;
+
+        // Matriz de Modelo (a mesma do glTranslatef/glScalef de draw())
+        using namespace math_utils;
+        Mat4 model = mat4_multiply(mat4_translate(position_[0], position_[1], position_[2]),
+                                   mat4_scale(scale_, scale_, scale_));
+        Mat4 modelView = mat4_multiply(view, model);
+        Mat4 mvp = mat4_multiply(projection, modelView);
+        glActiveTexture(GL_TEXTURE4); // Caixas da quantização: todas as camadas da malha
+        glBindTexture(GL_TEXTURE_BUFFER, tex_chunk_boxes_);
+        glActiveTexture(GL_TEXTURE0);
+
+        // Camada 1: Faces Sólidas (cor por face via gl_PrimitiveID, como no caminho legado)
+        Color edgeColor = colors.count("edge") ? colors.at("edge") : Color{0.0f, 0.0f, 0.0f};
+        float useAO = aoEnabled_ && vertexAO_.size() == vertices_.size() ? 1.0f : 0.0f;
+        if (!vertexOnlyMode) {
+            // Descarte antes da passada: a timer query das faces mede só a GPU
+            std::vector<std::pair<int, int> > ranges;
+            {
+                ScopedCpuTimer timer(currentTimings_.cullMs);
+                cullChunks(projection, modelView, ranges);
+            }
+
+            beginPass(PASS_FACES);
+            if (singlePass) {
+                // Faces + arestas do polígono no mesmo desenho
+                GLint viewport[4];
+                glGetIntegerv(GL_VIEWPORT, viewport);
+                glUseProgram(core.faceWireProgram);
+                glUniformMatrix4fv(core.faceWireMvp, 1, GL_FALSE, mvp.data());
+                glUniform1f(core.faceWireUseAO, useAO);
+                glUniform2f(core.faceWireViewport, static_cast<float>(viewport[2]), static_cast<float>(viewport[3]));
+                glUniform3f(core.faceWireEdgeColor, edgeColor[0], edgeColor[1], edgeColor[2]);
+                glUniform1f(core.faceWireLineWidth, 2.0f);
+                glUniform1i(core.faceWireLodBase, static_cast<GLint>(triangleToFace_.size()));
+            } else {
+                glUseProgram(core.faceProgram);
+                glUniformMatrix4fv(core.faceMvp, 1, GL_FALSE, mvp.data());
+                glUniform1f(core.faceUseAO, useAO);
+            }
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_BUFFER, tex_triangle_face_);
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_BUFFER, tex_face_colors_);
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_BUFFER, tex_face_triangles_);
+            glActiveTexture(GL_TEXTURE0);
+
+            // Só as faixas de blocos que passaram no descarte (ver ObjectCulling.cpp)
+            GLint triangleBase = singlePass ? core.faceWireTriangleBase : core.faceTriangleBase;
+            glBindVertexArray(core.meshVao);
+            int calls = 0;
+            for (const auto &range: ranges) calls += drawTriangleRange(range.first, range.second, triangleBase);
+            cullingStats_.drawCalls = calls;
+            readBackDepth(projection, modelView); // Profundidade das faces para o Hi-Z
+
+            for (GLenum unit: {GL_TEXTURE3, GL_TEXTURE2, GL_TEXTURE1}) {
+                glActiveTexture(unit);
+                glBindTexture(GL_TEXTURE_BUFFER, 0);
+            }
+            glActiveTexture(GL_TEXTURE0);
+            endPass(PASS_FACES);
+            currentTimings_.triangles += cullingStats_.triangles;
+            currentTimings_.drawCalls += calls;
+        }
+
+        // Camada 2: Arestas (Wireframe). Na passada única, só as que não pertencem a triângulos
+        beginPass(PASS_EDGES);
+        glUseProgram(core.wireProgram);
+        glUniformMatrix4fv(core.wireMvp, 1, GL_FALSE, mvp.data());
+        glUniform4f(core.wireColor, edgeColor[0], edgeColor[1], edgeColor[2], 1.0f);
+        glUniform1i(core.wireUseVertexColor, 0);
+        glUniform1i(core.wireSelectedOnly, 0);
+        glBindVertexArray(core.edgeVao);
+        if (edgeIndexCount_ > 0) {
+            glLineWidth(2.0f);
+            glDrawElements(GL_LINES, static_cast<GLsizei>(edgeIndexCount_), GL_UNSIGNED_INT, nullptr);
+            currentTimings_.lines += static_cast<int>(edgeIndexCount_ / 2);
+            currentTimings_.drawCalls++;
+        }
+        endPass(PASS_EDGES);
+
+        // Camada 3: Vértices (duas passadas, a segunda só com os selecionados e sem Z-Test)
+        if (!faceOnlyMode && !vertices_.empty()) {
+            beginPass(PASS_VERTICES);
+            GLsizei count = static_cast<GLsizei>(vertices_.size());
+            glEnable(GL_PROGRAM_POINT_SIZE);
+            glUniform1f(core.wirePointSize, 5.0f);
+            glUniform1i(core.wireUseVertexColor, 1);
+            glBindVertexArray(core.meshVao);
+            glDrawArrays(GL_POINTS, 0, count);
+            if (!drawnSelectedVertices_.empty()) {
+                GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+                glDisable(GL_DEPTH_TEST);
+                glUniform1i(core.wireSelectedOnly, 1);
+                glDrawArrays(GL_POINTS, 0, count);
+                if (depthTest) glEnable(GL_DEPTH_TEST);
+            }
+            glDisable(GL_PROGRAM_POINT_SIZE);
+            endPass(PASS_VERTICES);
+            currentTimings_.points += count;
+            currentTimings_.drawCalls += drawnSelectedVertices_.empty() ? 1 : 2;
+        }
+
+        // Camada 4: Texturas (Overlay)
+        if (!vertexOnlyMode) drawTexturedFacesCore(mvp);
+
+        glBindVertexArray(0);
+        glUseProgram(0);
+
+        // Buffer de IDs do picking (só renderiza se a câmera ou a geometria mudaram)
+        beginPass(PASS_PICKING);
+        updatePickBuffer(projection, modelView);
+        endPass(PASS_PICKING);
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glActiveTexture(GL_TEXTURE0);
+        return true;
+    }
+
+    // Mesmos lotes de drawTexturedFaces(); a máscara descarta as faces selecionadas no shader.
+    void Object::drawTexturedFacesCore(const math_utils::Mat4 &mvp) {
+        {
+            ScopedCpuTimer timer(currentTimings_.rebuildMs);
+            if (textureBatchesDirty_) rebuildTextureBatches();
+            if (textureBatches_.empty()) return;
+            syncTextureMask();
+            setupCoreVertexArrays(); // O VAO dos lotes só existe depois do primeiro envio
+        }
+        beginPass(PASS_TEXTURES);
+
+        glUseProgram(core_.textureProgram);
+        glUniformMatrix4fv(core_.textureMvp, 1, GL_FALSE, mvp.data());
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthFunc(GL_LEQUAL);
+        glActiveTexture(GL_TEXTURE5);
+        glBindTexture(GL_TEXTURE_BUFFER, tex_packed_positions_);
+        glActiveTexture(GL_TEXTURE0);
+        glBindVertexArray(core_.textureVao);
+        for (const auto &batch: textureBatches_) {
+            glBindTexture(GL_TEXTURE_2D, batch.texture);
+            glDrawArrays(GL_TRIANGLES, batch.first, batch.count);
+            currentTimings_.triangles += batch.count / 3;
+            currentTimings_.drawCalls++;
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE5);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glDisable(GL_BLEND);
+        glDepthFunc(GL_LESS);
+        endPass(PASS_TEXTURES);
     }
 } // namespace object
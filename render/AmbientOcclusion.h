@@ -0,0 +1,122 @@
+#ifndef AMBIENT_OCCLUSION_H
+#define AMBIENT_OCCLUSION_H
+
+/*
+ * ======================================================================================
+ * AMBIENT OCCLUSION - OCLUSÃO AMBIENTE PRÉ-CALCULADA (BAKE) POR VÉRTICE
+ * ======================================================================================
+ *
+ * A visualização OpenGL pinta cada face com uma cor chapada, sem nenhuma pista de
+ * forma; o Path Tracer dá essa pista, mas é lento demais para navegar pela malha.
+ * O bake fica no meio do caminho: para cada vértice, dispara N raios no hemisfério da
+ * normal (distribuição cosseno) contra a BVH e guarda a fração que NÃO encontrou
+ * geometria até um raio máximo. O rasterizador apenas multiplica a cor por esse valor.
+ *
+ * INCREMENTAL: O objeto registra uma caixa envolvendo a geometria editada. Como os
+ * raios têm alcance limitado, só os vértices a menos de 'maxDist' dessa caixa podem
+ * mudar - os demais mantêm o valor do bake anterior.
+ *
+ * ======================================================================================
+ */
+
+#include "PathTracer.h"
+#include "OfflineRender.h"
+#include "../models/object/Object.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+struct AOSettings {
+    int raysPerVertex = 64;
+    float radius = 0.2f; // Alcance dos raios como fração da diagonal da caixa da malha
+};
+
+// Normais por vértice ponderadas pela área das faces (triangulação em leque).
+inline std::vector<Vec3> computeVertexNormals(const SceneData &scene) {
+    std::vector<Vec3> normals(scene.vertices.size(), Vec3(0, 0, 0));
+    for (const auto &f: scene.faces) {
+        const Vec3 &a = scene.vertices[f[0]], &b = scene.vertices[f[1]], &c = scene.vertices[f[2]];
+        Vec3 n = (b - a).cross(c - a); // Comprimento = 2x área
+        for (int k = 0; k < 3; ++k) normals[f[k]] = normals[f[k]] + n;
+    }
+    for (auto &n: normals) {
+        double len = n.length();
+        n = len > 0 ? n * (1.0 / len) : Vec3(0, 0, 0);
+    }
+    return normals;
+}
+
+// Recalcula a AO do objeto. Bake completo na primeira vez (ou se a malha mudou de tamanho
+// sem rastreamento); depois, apenas os vértices próximos da região editada.
+// Retorna quantos vértices foram recalculados.
+inline size_t bakeAmbientOcclusion(object::Object &obj, const AOSettings &settings = AOSettings()) {
+    const auto &vertices = obj.getVertices();
+    if (vertices.empty()) return 0;
+
+    // Mesma triangulação em cache usada pelo rasterizador (sem retriangular a malha)
+    SceneData scene;
+    const auto &tris = obj.getTriangleIndices();
+    for (const auto &v: vertices) scene.vertices.push_back(Vec3(v[0], v[1], v[2]));
+    for (size_t t = 0; t + 2 < tris.size(); t += 3) {
+        scene.faces.push_back({tris[t], tris[t + 1], tris[t + 2]});
+        scene.faceMaterials.push_back(0);
+    }
+
+    AABB bounds;
+    for (const auto &v: scene.vertices) bounds.expand(v);
+    double diag = (bounds.max - bounds.min).length();
+    double maxDist = settings.radius * diag;
+    double eps = 1e-4 * diag;
+
+    // 1. Decide quais vértices recalcular
+    std::vector<float> ao = obj.getVertexAO();
+    bool full = ao.size() != vertices.size();
+    if (full) ao.assign(vertices.size(), -1.0f);
+
+    std::array<float, 3> dirtyMin, dirtyMax;
+    bool dirty = obj.getAODirtyRegion(dirtyMin, dirtyMax);
+    std::vector<int> todo;
+    for (int i = 0; i < (int) vertices.size(); ++i) {
+        bool stale = ao[i] < 0.0f;
+        if (!stale && dirty) {
+            stale = true;
+            for (int k = 0; k < 3; ++k)
+                if (vertices[i][k] < dirtyMin[k] - maxDist || vertices[i][k] > dirtyMax[k] + maxDist) stale = false;
+        }
+        if (stale) todo.push_back(i);
+    }
+    obj.clearAODirtyRegion();
+    if (todo.empty()) return 0;
+
+    // 2. Traça os raios (a BVH é reconstruída: a geometria mudou desde o último bake)
+    buildBVH(scene);
+    std::vector<Vec3> normals = computeVertexNormals(scene);
+    int rays = std::max(1, settings.raysPerVertex);
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int k = 0; k < (int) todo.size(); ++k) {
+        int i = todo[k];
+        const Vec3 &n = normals[i];
+        if (n.length() == 0) {
+            ao[i] = 1.0f; // Vértice solto: sem hemisfério definido
+            continue;
+        }
+        uint32_t seed = pixelSeed(1, 0, (uint32_t) i); // Determinístico: o bake incremental não cintila
+        Vec3 origin = scene.vertices[i] + n * eps;
+        int hits = 0;
+        for (int r = 0; r < rays; ++r) {
+            Vec3 d = (n + randomUnitVector(seed)).norm(); // Distribuição cosseno no hemisfério
+            double t = maxDist, u, v;
+            int face;
+            Vec3 nrm;
+            if (intersectMesh(scene, Ray(origin, d), t, face, nrm, u, v)) hits++;
+        }
+        ao[i] = 1.0f - (float) hits / rays;
+    }
+
+    obj.setVertexAO(ao);
+    return todo.size();
+}
+
+#endif
@@ -0,0 +1,487 @@
+#ifndef BIDIRECTIONAL_H
+#define BIDIRECTIONAL_H
+
+/*
+ * ======================================================================================
+ * BIDIRECTIONAL - PATH TRACING BIDIRECIONAL (BDPT) COM MIS
+ * ======================================================================================
+ *
+ * O integrador padrão (radiance, em PathTracer.h) só encontra a luz de duas formas:
+ * pelo NEE (raio de sombra direto até a esfera) ou acertando a esfera no primeiro raio.
+ * Quando a luz está atrás de vidro (matType == 2), o raio de sombra é bloqueado e os
+ * caminhos difuso -> vidro -> luz nunca são contabilizados: cáusticas e lâmpadas dentro
+ * de vidro simplesmente não convergem.
+ *
+ * O BDPT constrói DOIS subcaminhos por amostra:
+ *
+ * 1. SUBCAMINHO DA CÂMERA: câmera -> superfícies (como o Path Tracing normal).
+ * 2. SUBCAMINHO DA LUZ: ponto na esfera de luz -> superfícies (atravessando o vidro).
+ *
+ * e conecta cada prefixo de um com cada prefixo do outro (estratégias s, t), onde
+ * s = vértices da luz e t = vértices da câmera:
+ *
+ * - s = 0: o subcaminho da câmera acerta a luz sozinho.
+ * - s = 1: conexão direta com um ponto amostrado na luz (equivalente ao NEE).
+ * - t = 1: light tracing. O vértice da luz é conectado à câmera e a contribuição é
+ * "espalhada" (splat) no pixel onde ele se projeta. É esta estratégia que resolve as cáusticas.
+ * - demais: conexão entre dois vértices difusos.
+ *
+ * Cada caminho completo pode ser gerado por várias estratégias; o MIS (heurística do
+ * balanço) pondera cada uma pela razão entre sua densidade e a soma das densidades de
+ * todas as estratégias possíveis, mantendo o estimador não enviesado.
+ *
+ * Vértices de vidro são especulares (delta): não podem ser conectados e ficam fora da soma.
+ *
+ * MODELO DA CENA: o mesmo do getIntersection (malha, chão infinito e esfera de luz de raio
+ * 0.1), com BRDF difusa normalizada (albedo / PI). Raios da câmera que escapam recebem o
+ * céu (backgroundRadiance: environment map ou luz ambiente constante). O céu só é alcançado
+ * pelo subcaminho da câmera, então essa contribuição não entra no MIS.
+ *
+ * ======================================================================================
+ */
+
+#include "PathTracer.h"
+#include "PtCamera.h"
+#include <cmath>
+#include <vector>
+
+// Integradores selecionáveis por renderização.
+static const int INTEGRATOR_PATH = 0; // Path Tracing unidirecional com NEE (radiance)
+static const int INTEGRATOR_BDPT = 1; // Path Tracing bidirecional com MIS
+
+static const int BDPT_MAX_DEPTH = 8; // Número máximo de segmentos (rebatimentos) por caminho
+
+// Esfera de luz da cena, idêntica à testada no getIntersection (id 3).
+inline const Vec3 BDPT_LIGHT_CENTER(0.0, 0.6, 0.0);
+static const double BDPT_LIGHT_RADIUS = 0.1;
+inline const Vec3 BDPT_LIGHT_EMISSION(8.0, 8.0, 8.0);
+
+static const double BDPT_PI = 3.14159265358979323846;
+
+// ==========================================
+// 1. VÉRTICES DOS SUBCAMINHOS
+// ==========================================
+
+enum BdptVertexType { BDPT_CAMERA, BDPT_LIGHT, BDPT_SURFACE };
+
+struct BdptVertex {
+    BdptVertexType type = BDPT_SURFACE;
+    Vec3 p, n; // Posição e normal geométrica (na luz: normal para fora da esfera)
+    Vec3 wo; // Direção unitária para o vértice anterior do mesmo subcaminho
+    Vec3 beta; // Throughput acumulado desde a origem do subcaminho
+    Vec3 albedo;
+    bool delta = false; // Vidro: reflexão/refração especular
+    bool emitter = false; // Superfície da esfera de luz atingida (só emite, não reflete)
+    double pdfFwd = 0.0; // Densidade (por área) de gerar este vértice no sentido do subcaminho
+    double pdfRev = 0.0; // Densidade (por área) de gerá-lo no sentido oposto
+};
+
+// Cor da superfície (mesma regra do radiance: textura, cinza padrão ou xadrez do chão).
+inline Vec3 bdptSurfaceAlbedo(int id, const Vec3 &x, int face, double u, double v) {
+    if (id == 2) {
+        bool grid = (int(std::floor(x.x) + std::floor(x.z)) & 1) == 0;
+        return grid ? Vec3(0.8, 0.8, 0.8) : Vec3(0.2, 0.2, 0.2);
+    }
+
+    Vec3 f(0.7, 0.7, 0.7);
+    if (face >= 0 && face < (int) g_renderMesh->faceTextureID.size()) {
+        int texID = g_renderMesh->faceTextureID[face];
+        if (texID >= 0 && texID < (int) g_renderMesh->textures.size()) {
+            const auto &uvs = g_renderMesh->faceUVs[face];
+            if (uvs.size() >= 3) {
+                float tu = (1.0 - u - v) * uvs[0].u + u * uvs[1].u + v * uvs[2].u;
+                float tv = (1.0 - u - v) * uvs[0].v + u * uvs[1].v + v * uvs[2].v;
+                f = sampleTexture(g_renderMesh->textures[texID], tu, tv);
+            }
+        }
+    }
+    return f;
+}
+
+inline BdptVertex bdptSurfaceVertex(const Ray &r, double t, int id, const Vec3 &n, int face, double u, double v) {
+    BdptVertex vtx;
+    vtx.p = r.o + r.d * t;
+    vtx.n = n;
+    vtx.wo = r.d * -1.0;
+    if (id == 3) {
+        vtx.emitter = true;
+    } else if (id == 1 && face >= 0 && face < (int) g_renderMesh->faceMaterials.size() &&
+               g_renderMesh->faceMaterials[face] == 2) {
+        vtx.delta = true;
+    } else {
+        vtx.albedo = bdptSurfaceAlbedo(id, vtx.p, face, u, v);
+    }
+    return vtx;
+}
+
+// ==========================================
+// 2. BSDF E DENSIDADES
+// ==========================================
+
+// Converte uma densidade por ângulo sólido em 'from' para densidade por área em 'to'.
+inline double bdptPdfToArea(const BdptVertex &from, const BdptVertex &to, double pdfDir) {
+    Vec3 w = to.p - from.p;
+    double dist2 = w.dot(w);
+    if (dist2 == 0.0) return 0.0;
+    double pdf = pdfDir / dist2;
+    if (to.type != BDPT_CAMERA) pdf *= std::abs(to.n.dot(w)) / std::sqrt(dist2); // Pinhole não tem superfície
+    return pdf;
+}
+
+// BRDF difusa (albedo / PI), apenas entre direções do mesmo lado da superfície.
+inline Vec3 bdptBsdf(const BdptVertex &v, const Vec3 &wi) {
+    if (v.type != BDPT_SURFACE || v.delta || v.emitter) return Vec3(0, 0, 0);
+    if (v.n.dot(v.wo) * v.n.dot(wi) <= 0.0) return Vec3(0, 0, 0);
+    return v.albedo * (1.0 / BDPT_PI);
+}
+
+inline double bdptBsdfPdf(const BdptVertex &v, const Vec3 &wo, const Vec3 &wi) {
+    if (v.delta || v.emitter) return 0.0;
+    if (v.n.dot(wo) * v.n.dot(wi) <= 0.0) return 0.0;
+    return std::abs(v.n.dot(wi)) / BDPT_PI;
+}
+
+// Densidade (por área em 'to') de a luz emitir a partir de 'light' na direção de 'to' (cosseno).
+inline double bdptPdfLight(const BdptVertex &light, const BdptVertex &to) {
+    Vec3 w = to.p - light.p;
+    double dist2 = w.dot(w);
+    if (dist2 == 0.0) return 0.0;
+    w = w * (1.0 / std::sqrt(dist2));
+    double cosLight = light.n.dot(w);
+    if (cosLight <= 0.0) return 0.0;
+    double pdf = cosLight / (BDPT_PI * dist2);
+    if (to.type != BDPT_CAMERA) pdf *= std::abs(to.n.dot(w));
+    return pdf;
+}
+
+// Densidade por área de escolher um ponto na esfera de luz (uniforme na superfície).
+inline double bdptPdfLightOrigin() {
+    return 1.0 / (4.0 * BDPT_PI * BDPT_LIGHT_RADIUS * BDPT_LIGHT_RADIUS);
+}
+
+// Densidade por área de, estando em 'cur' (vindo de 'prev'), gerar o vértice 'next'.
+inline double bdptPdf(const PtCamera &cam, const BdptVertex &cur, const BdptVertex *prev, const BdptVertex &next) {
+    if (cur.type == BDPT_LIGHT || cur.emitter) return bdptPdfLight(cur, next);
+
+    Vec3 wn = next.p - cur.p;
+    double len = wn.length();
+    if (len == 0.0) return 0.0;
+    wn = wn * (1.0 / len);
+
+    double pdfDir;
+    if (cur.type == BDPT_CAMERA) {
+        pdfDir = cameraPdfDir(cam, wn);
+    } else {
+        Vec3 wp = (prev->p - cur.p).norm();
+        pdfDir = bdptBsdfPdf(cur, wp, wn);
+    }
+    return bdptPdfToArea(cur, next, pdfDir);
+}
+
+// Amostra o vidro (Fresnel de Schlick, IOR 1.5). 'wo' aponta para o vértice anterior.
+// Em modo radiância a refração escala o throughput por (n1/n2)^2; no subcaminho da luz
+// (importância) não, pois a radiância e a importância não se transformam da mesma forma.
+inline Vec3 bdptSampleDielectric(const BdptVertex &v, bool radianceMode, uint32_t &seed, double &scale) {
+    Vec3 d = v.wo * -1.0; // Direção de propagação
+    Vec3 nl = v.n.dot(d) < 0 ? v.n : v.n * -1.0;
+    bool into = v.n.dot(nl) > 0;
+    double nc = 1.0, nt = 1.5;
+    double nnt = into ? nc / nt : nt / nc;
+    double ddn = d.dot(nl);
+    double cos2t = 1.0 - nnt * nnt * (1.0 - ddn * ddn);
+
+    scale = 1.0;
+    Vec3 reflected = (d - nl * 2.0 * nl.dot(d)).norm();
+    if (cos2t < 0.0) return reflected; // Reflexão interna total
+
+    Vec3 tdir = (d * nnt - v.n * ((into ? 1 : -1) * (ddn * nnt + std::sqrt(cos2t)))).norm();
+    double a = nt - nc, b = nt + nc;
+    double R0 = (a * a) / (b * b);
+    double c = 1.0 - (into ? -ddn : tdir.dot(v.n));
+    double Re = R0 + (1.0 - R0) * std::pow(c, 5.0);
+
+    if (random_float(seed) < Re) return reflected;
+    if (radianceMode) scale = nnt * nnt;
+    return tdir;
+}
+
+// Direção com distribuição cosseno no hemisfério de 'w'.
+inline Vec3 bdptCosineDirection(const Vec3 &w, uint32_t &seed) {
+    double r1 = 2.0 * BDPT_PI * random_float(seed);
+    double r2 = random_float(seed);
+    double r2s = std::sqrt(r2);
+    Vec3 u = ((std::abs(w.x) > 0.1 ? Vec3(0, 1, 0) : Vec3(1, 0, 0)).cross(w)).norm();
+    Vec3 v = w.cross(u);
+    return (u * std::cos(r1) * r2s + v * std::sin(r1) * r2s + w * std::sqrt(1.0 - r2)).norm();
+}
+
+// ==========================================
+// 3. GERAÇÃO DOS SUBCAMINHOS
+// ==========================================
+
+// Estende o subcaminho a partir de path[0] (já preenchido) até 'maxVertices' vértices.
+// 'escaped' (opcional) recebe a radiância do céu vista pelo raio que saiu da cena (já com throughput).
+inline int bdptRandomWalk(Ray ray, Vec3 beta, double pdfDir, bool radianceMode, uint32_t &seed,
+                          BdptVertex *path, int maxVertices, Vec3 *escaped) {
+    int count = 1;
+    double pdfFwd = pdfDir;
+    while (count < maxVertices) {
+        double t, u, v;
+        int id, face;
+        Vec3 n;
+        if (!getIntersection(ray, t, id, n, face, u, v)) {
+            if (escaped) *escaped = beta * backgroundRadiance(ray.d);
+            break;
+        }
+
+        BdptVertex &prev = path[count - 1];
+        BdptVertex &vtx = path[count];
+        vtx = bdptSurfaceVertex(ray, t, id, n, face, u, v);
+        vtx.beta = beta;
+        vtx.pdfFwd = bdptPdfToArea(prev, vtx, pdfFwd);
+        if (++count >= maxVertices || vtx.emitter) break;
+
+        Vec3 wi;
+        double pdfRev;
+        if (vtx.delta) {
+            double scale;
+            wi = bdptSampleDielectric(vtx, radianceMode, seed, scale);
+            beta = beta * scale;
+            pdfFwd = pdfRev = 0.0;
+        } else {
+            Vec3 nl = vtx.n.dot(vtx.wo) > 0 ? vtx.n : vtx.n * -1.0;
+            wi = bdptCosineDirection(nl, seed);
+            pdfFwd = nl.dot(wi) / BDPT_PI;
+            pdfRev = nl.dot(vtx.wo) / BDPT_PI;
+            beta = beta * vtx.albedo; // f * cos / pdf = albedo
+        }
+        prev.pdfRev = bdptPdfToArea(vtx, prev, pdfRev);
+
+        if (beta.x == 0.0 && beta.y == 0.0 && beta.z == 0.0) break;
+        ray = Ray(vtx.p, wi);
+        ray.o = ray.o + ray.d * 1e-4;
+    }
+    return count;
+}
+
+// Subcaminho da câmera pela posição contínua (px, py) do filme.
+inline int bdptCameraSubpath(const PtCamera &cam, double px, double py, uint32_t &seed,
+                             BdptVertex *path, int maxVertices, Vec3 &escaped) {
+    Ray ray = cameraRay(cam, px, py);
+    BdptVertex &c = path[0];
+    c = BdptVertex();
+    c.type = BDPT_CAMERA;
+    c.p = cam.origin;
+    c.n = cam.dir;
+    c.beta = Vec3(1, 1, 1); // We * cos / pdf = 1 para a câmera pinhole
+    return bdptRandomWalk(ray, Vec3(1, 1, 1), cameraPdfDir(cam, ray.d), true, seed, path, maxVertices, &escaped);
+}
+
+// Subcaminho da luz: ponto uniforme na esfera e direção cosseno em torno da normal.
+inline int bdptLightSubpath(uint32_t &seed, BdptVertex *path, int maxVertices) {
+    Vec3 nLight = randomUnitVector(seed);
+    Vec3 w = bdptCosineDirection(nLight, seed);
+    double pdfPos = bdptPdfLightOrigin();
+    double pdfDir = nLight.dot(w) / BDPT_PI;
+
+    BdptVertex &l = path[0];
+    l = BdptVertex();
+    l.type = BDPT_LIGHT;
+    l.p = BDPT_LIGHT_CENTER + nLight * BDPT_LIGHT_RADIUS;
+    l.n = nLight;
+    l.beta = BDPT_LIGHT_EMISSION * (1.0 / pdfPos);
+    l.pdfFwd = pdfPos;
+
+    if (pdfDir <= 0.0) return 1;
+    Vec3 beta = BDPT_LIGHT_EMISSION * (nLight.dot(w) / (pdfPos * pdfDir));
+    Ray ray(l.p + w * 1e-4, w);
+    return bdptRandomWalk(ray, beta, pdfDir, false, seed, path, maxVertices, nullptr);
+}
+
+// ==========================================
+// 4. CONEXÃO E PESOS MIS
+// ==========================================
+
+inline double bdptRemap0(double f) { return f != 0.0 ? f : 1.0; }
+
+inline bool bdptVisible(const Vec3 &a, const Vec3 &b) {
+    Vec3 d = b - a;
+    double dist = d.length();
+    d = d * (1.0 / dist);
+    Ray r(a + d * 1e-4, d);
+    double t, u, v;
+    int id, face;
+    Vec3 n;
+    return !getIntersection(r, t, id, n, face, u, v) || t > dist - 2e-4;
+}
+
+// Heurística do balanço sobre todas as estratégias (s', t') que geram o mesmo caminho.
+// As densidades dos vértices de conexão mudam com a estratégia, então são recalculadas
+// temporariamente e restauradas ao final.
+inline double bdptMisWeight(const PtCamera &cam, BdptVertex *lightV, BdptVertex *cameraV,
+                            const BdptVertex &sampled, int s, int t) {
+    if (s + t == 2) return 1.0;
+
+    BdptVertex *qs = s > 0 ? &lightV[s - 1] : nullptr;
+    BdptVertex *pt = t > 0 ? &cameraV[t - 1] : nullptr;
+    BdptVertex *qsMinus = s > 1 ? &lightV[s - 2] : nullptr;
+    BdptVertex *ptMinus = t > 1 ? &cameraV[t - 2] : nullptr;
+
+    BdptVertex savedQs, savedPt, savedQsMinus, savedPtMinus;
+    if (qs) savedQs = *qs;
+    if (pt) savedPt = *pt;
+    if (qsMinus) savedQsMinus = *qsMinus;
+    if (ptMinus) savedPtMinus = *ptMinus;
+
+    if (s == 1) *qs = sampled;
+    else if (t == 1) *pt = sampled;
+
+    // Vértices de conexão nunca são especulares
+    pt->delta = false;
+    if (qs) qs->delta = false;
+
+    pt->pdfRev = s > 0 ? bdptPdf(cam, *qs, qsMinus, *pt) : bdptPdfLightOrigin();
+    if (ptMinus) ptMinus->pdfRev = s > 0 ? bdptPdf(cam, *pt, qs, *ptMinus) : bdptPdfLight(*pt, *ptMinus);
+    if (qs) qs->pdfRev = bdptPdf(cam, *pt, ptMinus, *qs);
+    if (qsMinus) qsMinus->pdfRev = bdptPdf(cam, *qs, pt, *qsMinus);
+
+    double sumRi = 0.0;
+    double ri = 1.0;
+    for (int i = t - 1; i > 0; --i) {
+        ri *= bdptRemap0(cameraV[i].pdfRev) / bdptRemap0(cameraV[i].pdfFwd);
+        if (!cameraV[i].delta && !cameraV[i - 1].delta) sumRi += ri;
+    }
+    ri = 1.0;
+    for (int i = s - 1; i >= 0; --i) {
+        ri *= bdptRemap0(lightV[i].pdfRev) / bdptRemap0(lightV[i].pdfFwd);
+        bool deltaPrev = i > 0 && lightV[i - 1].delta; // A esfera é luz de área (nunca delta)
+        if (!lightV[i].delta && !deltaPrev) sumRi += ri;
+    }
+
+    if (qs) *qs = savedQs;
+    *pt = savedPt;
+    if (qsMinus) *qsMinus = savedQsMinus;
+    if (ptMinus) *ptMinus = savedPtMinus;
+    return 1.0 / (1.0 + sumRi);
+}
+
+// Contribuição ponderada da estratégia (s, t). Para t == 1, 'splatPixel' recebe o índice
+// do pixel (convenção do g_accumBuffer) onde a contribuição deve ser somada.
+inline Vec3 bdptConnect(const PtCamera &cam, BdptVertex *lightV, BdptVertex *cameraV, int s, int t,
+                        uint32_t &seed, int &splatPixel) {
+    splatPixel = -1;
+    BdptVertex &pt = cameraV[t - 1];
+    BdptVertex sampled;
+    Vec3 L(0, 0, 0);
+
+    if (s == 0) {
+        // O subcaminho da câmera acertou a luz
+        if (!pt.emitter || pt.n.dot(pt.wo) <= 0.0) return L;
+        L = pt.beta * BDPT_LIGHT_EMISSION;
+    } else if (t == 1) {
+        // Light tracing: conecta o vértice da luz à câmera
+        const BdptVertex &qs = lightV[s - 1];
+        if (qs.type != BDPT_SURFACE || qs.delta || qs.emitter) return L;
+
+        Vec3 toCam = cam.origin - qs.p;
+        double dist2 = toCam.dot(toCam);
+        Vec3 wi = toCam * (1.0 / std::sqrt(dist2));
+        double px, py;
+        if (!cameraRaster(cam, wi * -1.0, px, py)) return L;
+
+        // Importância We = 1 / (A cos^4) e densidade do ponto de vista de qs: dist^2 / cos
+        double cosCam = (wi * -1.0).dot(cam.dir);
+        double we = 1.0 / (cameraFilmArea(cam) * cosCam * cosCam * cosCam * cosCam);
+        double pdf = dist2 / cosCam;
+
+        sampled.type = BDPT_CAMERA;
+        sampled.p = cam.origin;
+        sampled.n = cam.dir;
+        sampled.beta = Vec3(1, 1, 1) * (we / pdf);
+
+        L = qs.beta * bdptBsdf(qs, wi) * sampled.beta * std::abs(qs.n.dot(wi));
+        if (L.x + L.y + L.z <= 0.0 || !bdptVisible(qs.p, cam.origin)) return Vec3(0, 0, 0);
+
+        int ix = std::min(cam.width - 1, (int) px);
+        int iy = std::min(cam.height - 1, (int) py);
+        splatPixel = (cam.height - 1 - iy) * cam.width + ix;
+    } else if (s == 1) {
+        // Conexão com um ponto amostrado na luz (NEE)
+        if (pt.delta || pt.emitter) return L;
+        Vec3 nLight = randomUnitVector(seed);
+        Vec3 pLight = BDPT_LIGHT_CENTER + nLight * BDPT_LIGHT_RADIUS;
+        Vec3 wi = pLight - pt.p;
+        double dist2 = wi.dot(wi);
+        wi = wi * (1.0 / std::sqrt(dist2));
+        double cosLight = -nLight.dot(wi);
+        if (cosLight <= 0.0) return L;
+
+        double pdfDir = bdptPdfLightOrigin() * dist2 / cosLight;
+        sampled.type = BDPT_LIGHT;
+        sampled.p = pLight;
+        sampled.n = nLight;
+        sampled.beta = BDPT_LIGHT_EMISSION * (1.0 / pdfDir);
+        sampled.pdfFwd = bdptPdfLightOrigin();
+
+        L = pt.beta * bdptBsdf(pt, wi) * sampled.beta * std::abs(pt.n.dot(wi));
+        if (L.x + L.y + L.z <= 0.0 || !bdptVisible(pt.p, pLight)) return Vec3(0, 0, 0);
+    } else {
+        // Conexão entre dois vértices difusos
+        const BdptVertex &qs = lightV[s - 1];
+        if (qs.delta || qs.emitter || pt.delta || pt.emitter) return L;
+        Vec3 d = pt.p - qs.p;
+        double dist2 = d.dot(d);
+        if (dist2 == 0.0) return L;
+        Vec3 w = d * (1.0 / std::sqrt(dist2));
+
+        double G = std::abs(qs.n.dot(w)) * std::abs(pt.n.dot(w)) / dist2;
+        L = qs.beta * bdptBsdf(qs, w) * bdptBsdf(pt, w * -1.0) * pt.beta * G;
+        if (L.x + L.y + L.z <= 0.0 || !bdptVisible(qs.p, pt.p)) return Vec3(0, 0, 0);
+    }
+
+    if (L.x + L.y + L.z <= 0.0) return L;
+    return L * bdptMisWeight(cam, lightV, cameraV, sampled, s, t);
+}
+
+// ==========================================
+// 5. AMOSTRA POR PIXEL
+// ==========================================
+
+// Uma amostra BDPT na posição (px, py) do filme. Retorna a contribuição do próprio pixel;
+// as contribuições de light tracing (t == 1) são somadas diretamente em 'accum' (atômico,
+// pois podem cair em pixels de outras threads).
+inline Vec3 bdptSample(const PtCamera &cam, double px, double py, uint32_t &seed, std::vector<Vec3> &accum) {
+    BdptVertex cameraV[BDPT_MAX_DEPTH + 2];
+    BdptVertex lightV[BDPT_MAX_DEPTH + 1];
+
+    Vec3 escaped(0, 0, 0);
+    int nCamera = bdptCameraSubpath(cam, px, py, seed, cameraV, BDPT_MAX_DEPTH + 2, escaped);
+    int nLight = bdptLightSubpath(seed, lightV, BDPT_MAX_DEPTH + 1);
+
+    // O céu só é alcançável pelo subcaminho da câmera: peso MIS 1
+    Vec3 L = escaped;
+
+    for (int t = 1; t <= nCamera; ++t) {
+        for (int s = 0; s <= nLight; ++s) {
+            int depth = s + t - 2;
+            if ((s == 1 && t == 1) || depth < 0 || depth > BDPT_MAX_DEPTH) continue;
+
+            int splatPixel;
+            Vec3 c = bdptConnect(cam, lightV, cameraV, s, t, seed, splatPixel);
+            if (t == 1) {
+                if (splatPixel < 0) continue;
+#pragma omp atomic
+                accum[splatPixel].x += c.x;
+#pragma omp atomic
+                accum[splatPixel].y += c.y;
+#pragma omp atomic
+                accum[splatPixel].z += c.z;
+            } else {
+                L = L + c;
+            }
+        }
+    }
+    return L;
+}
+
+#endif
@@ -0,0 +1,231 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+/*
+ * ======================================================================================
+ * CHECKPOINT - PERSISTÊNCIA DO ACUMULADOR HDR DO PATH TRACER
+ * ======================================================================================
+ *
+ * Renderizações offline longas (horas) acumulam amostras apenas em memória. Se o processo
+ * morrer, todo o trabalho é perdido. Este arquivo define um formato binário compacto que
+ * guarda o estado mínimo necessário para continuar uma renderização:
+ *
+ * 1. ACUMULADOR HDR: Soma das radiâncias por pixel (float32 x 3). A média final é
+ * soma / contagem, então somas de execuções independentes podem ser simplesmente somadas.
+ *
+ * 2. CONTAGEM POR PIXEL: Número de amostras acumuladas em cada pixel (uint32). Permite
+ * que partes da imagem tenham números diferentes de amostras (tiles, merges parciais).
+ *
+ * 3. ESTADO DO AMOSTRADOR: Lista de "streams" (semente base, passes concluídos). Como o
+ * gerador PCG é derivado de (semente, passe, pixel), retomar a partir do passe N gera
+ * exatamente as amostras que faltavam, sem repetir nenhuma.
+ *
+ * 4. MERGE: Checkpoints de execuções com sementes disjuntas são estatisticamente
+ * independentes. Somar acumuladores e contagens equivale a uma única renderização
+ * com o total de amostras.
+ *
+ * LAYOUT DO ARQUIVO (little-endian):
+ * "PTCK" | versão u32 | largura u32 | altura u32 | câmera f32[5] | hash da cena u64 |
+ * integrador u32 (a partir da versão 2) | nStreams u32 | (semente u32, passes u32) * nStreams | soma f32[3 * W * H] | contagem u32[W * H]
+ *
+ * ======================================================================================
+ */
+
+#include "PathTracer.h"
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Um fluxo de amostragem independente: semente base + quantos passes já foram acumulados.
+struct SamplerStream {
+    uint32_t seed = 1;
+    uint32_t passes = 0;
+};
+
+// Estado completo de uma renderização em andamento.
+struct RenderCheckpoint {
+    int width = 0, height = 0;
+    std::array<float, 5> camera{}; // rot_x, rot_y, zoom, offset_x, offset_y
+    uint64_t sceneHash = 0; // Impressão digital da geometria (evita retomar com outra cena)
+    uint32_t integrator = 0; // Integrador que gerou as amostras (0 = Path Tracing, 1 = BDPT)
+    std::vector<SamplerStream> streams;
+    std::vector<Vec3> accum; // Soma HDR por pixel (mesma ordem de g_accumBuffer)
+    std::vector<uint32_t> counts; // Amostras por pixel
+
+    void reset(int w, int h) {
+        width = w;
+        height = h;
+        accum.assign(static_cast<size_t>(w) * h, Vec3(0, 0, 0));
+        counts.assign(static_cast<size_t>(w) * h, 0);
+    }
+};
+
+static const char CHECKPOINT_MAGIC[4] = {'P', 'T', 'C', 'K'};
+static const uint32_t CHECKPOINT_VERSION = 2; // Versão 1 (sem integrador) ainda é lida
+
+// Hash FNV-1a sobre vértices, índices, materiais e céu HDR da cena. Barato e suficiente para detectar
+// tentativas de retomar/mesclar checkpoints de cenas diferentes.
+inline uint64_t hashScene(const SceneData &scene) {
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void *data, size_t bytes) {
+        const unsigned char *p = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    };
+    for (const auto &v: scene.vertices) {
+        float xyz[3] = {(float) v.x, (float) v.y, (float) v.z};
+        mix(xyz, sizeof(xyz));
+    }
+    for (const auto &f: scene.faces) mix(f.data(), f.size() * sizeof(unsigned int));
+    mix(scene.faceMaterials.data(), scene.faceMaterials.size() * sizeof(int));
+    mix(scene.environment.image.pixels.data(), scene.environment.image.pixels.size() * sizeof(float));
+    return h;
+}
+
+// Grava o checkpoint de forma atômica: escreve em "<path>.tmp" e só então substitui
+// o arquivo final. Se o processo morrer no meio da escrita, o checkpoint anterior sobrevive.
+inline bool saveCheckpoint(const std::string &path, const RenderCheckpoint &ck) {
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Erro ao criar checkpoint: " << tmpPath << std::endl;
+            return false;
+        }
+
+        uint32_t w = ck.width, h = ck.height, n = (uint32_t) ck.streams.size();
+        out.write(CHECKPOINT_MAGIC, 4);
+        out.write(reinterpret_cast<const char *>(&CHECKPOINT_VERSION), sizeof(uint32_t));
+        out.write(reinterpret_cast<const char *>(&w), sizeof(w));
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char *>(ck.camera.data()), sizeof(float) * 5);
+        out.write(reinterpret_cast<const char *>(&ck.sceneHash), sizeof(ck.sceneHash));
+        out.write(reinterpret_cast<const char *>(&ck.integrator), sizeof(ck.integrator));
+        out.write(reinterpret_cast<const char *>(&n), sizeof(n));
+        for (const auto &s: ck.streams) {
+            out.write(reinterpret_cast<const char *>(&s.seed), sizeof(s.seed));
+            out.write(reinterpret_cast<const char *>(&s.passes), sizeof(s.passes));
+        }
+
+        // O acumulador em memória é double; em disco float32 basta (metade do tamanho).
+        std::vector<float> packed(ck.accum.size() * 3);
+        for (size_t i = 0; i < ck.accum.size(); ++i) {
+            packed[i * 3 + 0] = (float) ck.accum[i].x;
+            packed[i * 3 + 1] = (float) ck.accum[i].y;
+            packed[i * 3 + 2] = (float) ck.accum[i].z;
+        }
+        out.write(reinterpret_cast<const char *>(packed.data()), packed.size() * sizeof(float));
+        out.write(reinterpret_cast<const char *>(ck.counts.data()), ck.counts.size() * sizeof(uint32_t));
+
+        if (!out.good()) {
+            std::cerr << "Erro ao escrever checkpoint: " << tmpPath << std::endl;
+            return false;
+        }
+    }
+
+    // std::rename não sobrescreve arquivos existentes no Windows.
+    std::remove(path.c_str());
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Erro ao substituir checkpoint: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+inline bool loadCheckpoint(const std::string &path, RenderCheckpoint &ck) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    char magic[4];
+    uint32_t version = 0, w = 0, h = 0, n = 0;
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    if (!in.good() || std::string(magic, 4) != std::string(CHECKPOINT_MAGIC, 4) || version < 1 || version > CHECKPOINT_VERSION) {
+        std::cerr << "Checkpoint invalido ou de versao incompativel: " << path << std::endl;
+        return false;
+    }
+
+    in.read(reinterpret_cast<char *>(&w), sizeof(w));
+    in.read(reinterpret_cast<char *>(&h), sizeof(h));
+    in.read(reinterpret_cast<char *>(ck.camera.data()), sizeof(float) * 5);
+    in.read(reinterpret_cast<char *>(&ck.sceneHash), sizeof(ck.sceneHash));
+    ck.integrator = 0;
+    if (version >= 2) in.read(reinterpret_cast<char *>(&ck.integrator), sizeof(ck.integrator));
+    in.read(reinterpret_cast<char *>(&n), sizeof(n));
+    if (!in.good() || w == 0 || h == 0 || w > 65536 || h > 65536) {
+        std::cerr << "Cabecalho de checkpoint corrompido: " << path << std::endl;
+        return false;
+    }
+
+    // O restante do arquivo tem de conter as n sementes e os pixels: um contador corrompido
+    // não pode virar uma alocação gigante.
+    std::streamoff start = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streamoff end = in.tellg();
+    in.seekg(start);
+    uint64_t remaining = start >= 0 && end >= start ? (uint64_t) (end - start) : 0;
+    uint64_t pixelBytes = (uint64_t) w * h * (3 * sizeof(float) + sizeof(uint32_t));
+    uint64_t streamBytes = sizeof(SamplerStream::seed) + sizeof(SamplerStream::passes);
+    if (!in.good() || remaining < pixelBytes || (remaining - pixelBytes) / streamBytes < n) {
+        std::cerr << "Checkpoint truncado ou corrompido (" << n << " sementes, " << w << "x" << h << "): "
+                << path << std::endl;
+        return false;
+    }
+
+    ck.streams.resize(n);
+    for (auto &s: ck.streams) {
+        in.read(reinterpret_cast<char *>(&s.seed), sizeof(s.seed));
+        in.read(reinterpret_cast<char *>(&s.passes), sizeof(s.passes));
+    }
+
+    ck.reset((int) w, (int) h);
+    std::vector<float> packed(ck.accum.size() * 3);
+    in.read(reinterpret_cast<char *>(packed.data()), packed.size() * sizeof(float));
+    in.read(reinterpret_cast<char *>(ck.counts.data()), ck.counts.size() * sizeof(uint32_t));
+    if (!in.good()) {
+        std::cerr << "Checkpoint truncado: " << path << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < ck.accum.size(); ++i)
+        ck.accum[i] = Vec3(packed[i * 3 + 0], packed[i * 3 + 1], packed[i * 3 + 2]);
+    return true;
+}
+
+// Soma 'src' em 'dst'. Só é válido para a mesma cena, resolução, câmera e integrador, e com
+// sementes disjuntas (caso contrário as amostras seriam correlacionadas/duplicadas).
+inline bool mergeCheckpoint(RenderCheckpoint &dst, const RenderCheckpoint &src) {
+    if (dst.width != src.width || dst.height != src.height) {
+        std::cerr << "Merge recusado: resolucoes diferentes." << std::endl;
+        return false;
+    }
+    if (dst.sceneHash != src.sceneHash || dst.camera != src.camera) {
+        std::cerr << "Merge recusado: cena ou camera diferentes." << std::endl;
+        return false;
+    }
+    if (dst.integrator != src.integrator) {
+        std::cerr << "Merge recusado: integradores diferentes." << std::endl;
+        return false;
+    }
+    for (const auto &a: dst.streams) {
+        for (const auto &b: src.streams) {
+            if (a.seed == b.seed) {
+                std::cerr << "Merge recusado: semente " << a.seed << " presente nos dois checkpoints." << std::endl;
+                return false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < dst.accum.size(); ++i) {
+        dst.accum[i] = dst.accum[i] + src.accum[i];
+        dst.counts[i] += src.counts[i];
+    }
+    dst.streams.insert(dst.streams.end(), src.streams.begin(), src.streams.end());
+    return true;
+}
+
+#endif
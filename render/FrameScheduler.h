@@ -0,0 +1,171 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+/*
+ * ======================================================================================
+ * FRAME SCHEDULER - REDESENHO SOB DEMANDA E ORÇAMENTO DE TEMPO POR QUADRO
+ * ======================================================================================
+ *
+ * O visualizador raster não precisa redesenhar sem motivo: a imagem só muda quando há
+ * entrada do usuário, animação (teclas de câmera seguradas) ou quando um trabalho em
+ * segundo plano termina. O agendador guarda esses pedidos e o idle do GLUT consulta:
+ *
+ * 1. REDESENHO: requestRedraw() marca o próximo quadro como necessário; o idle só chama
+ * glutPostRedisplay quando há pedido ou animação ativa.
+ *
+ * 2. TRABALHO ADIADO: tarefas não urgentes (bake de AO, BVH do picking por raio) entram
+ * numa fila com nome - pedidos repetidos da mesma tarefa se fundem num só. O idle as
+ * executa em fatias: com a cena parada, uma por fatia; durante animação, só se o custo
+ * medido da última execução couber no que sobra do orçamento do quadro, ou se a tarefa
+ * já esperou demais.
+ *
+ * 3. ESTATÍSTICAS: duração de cada quadro (CPU, de beginFrame a endFrame), média móvel,
+ * pico e quantos quadros estouraram o orçamento.
+ *
+ * Não usa OpenGL nem GLUT: o relógio é std::chrono e quem decide o que fazer com as
+ * respostas é o idleCallback (main.cpp).
+ *
+ * ======================================================================================
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// ==========================================
+// 1. ESTATÍSTICAS DE QUADRO
+// ==========================================
+
+struct FrameStats {
+    unsigned long frames = 0; // Quadros desenhados desde o início
+    double lastMs = 0.0; // Duração do último quadro
+    double averageMs = 0.0; // Média móvel exponencial
+    double peakMs = 0.0; // Maior duração observada
+    unsigned long overBudget = 0; // Quadros acima do orçamento
+    unsigned long deferredTasksRun = 0; // Tarefas adiadas executadas no idle
+    double deferredMs = 0.0; // Tempo total gasto nessas tarefas
+};
+
+// ==========================================
+// 2. AGENDADOR
+// ==========================================
+
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    double budgetMs = 1000.0 / 60.0; // Orçamento de um quadro (60 FPS)
+    double maxDeferMs = 500.0; // Tarefa adiada além disso roda mesmo durante animação
+
+    void requestRedraw() { redrawPending_ = true; }
+    bool redrawPending() const { return redrawPending_; }
+
+    // Enfileira (ou funde com o pedido pendente de mesmo nome) uma tarefa não urgente.
+    // A ordem de chegada é mantida; o pedido mais recente substitui a função anterior.
+    void defer(const std::string &name, std::function<void()> task) {
+        for (auto &pending: tasks_)
+            if (pending.name == name) {
+                pending.run = std::move(task);
+                return;
+            }
+        tasks_.push_back({name, std::move(task), Clock::now()});
+    }
+
+    bool hasDeferredWork() const { return !tasks_.empty(); }
+
+    // Marca o início/fim do trabalho de um quadro (chamados pelo display).
+    void beginFrame() {
+        frameStart_ = Clock::now();
+        redrawPending_ = false;
+    }
+
+    void endFrame() {
+        double ms = elapsedMs(frameStart_, Clock::now());
+        stats_.lastMs = ms;
+        stats_.averageMs = stats_.frames ? stats_.averageMs * 0.9 + ms * 0.1 : ms;
+        stats_.peakMs = std::max(stats_.peakMs, ms);
+        if (ms > budgetMs) ++stats_.overBudget;
+        ++stats_.frames;
+    }
+
+    // Tempo desde o beginFrame do quadro em andamento.
+    double frameElapsedMs() const { return elapsedMs(frameStart_, Clock::now()); }
+
+    // Tempo até o próximo quadro caber no orçamento (0 = já pode desenhar). Usado para
+    // espaçar os quadros de animação em vez de desenhar o mais rápido possível.
+    double msUntilNextFrame() const {
+        if (!stats_.frames) return 0.0;
+        return std::max(0.0, budgetMs - elapsedMs(frameStart_, Clock::now()));
+    }
+
+    // Executa no máximo uma tarefa adiada. 'animating' indica que o próximo quadro já está
+    // com pressa: nesse caso a tarefa precisa caber no que sobra do orçamento.
+    // Retorna true se alguma tarefa rodou (a imagem pode ter mudado).
+    bool runDeferredSlice(bool animating) {
+        if (tasks_.empty()) return false;
+        Clock::time_point now = Clock::now();
+        double remaining = msUntilNextFrame();
+        for (size_t i = 0; i < tasks_.size(); ++i) {
+            DeferredTask &task = tasks_[i];
+            bool starved = elapsedMs(task.queuedAt, now) > maxDeferMs;
+            if (animating && !starved && estimatedMs(task.name) > remaining) continue;
+
+            DeferredTask current = std::move(task);
+            tasks_.erase(tasks_.begin() + i);
+            Clock::time_point start = Clock::now();
+            current.run();
+            double ms = elapsedMs(start, Clock::now());
+            recordCost(current.name, ms);
+            stats_.deferredMs += ms;
+            ++stats_.deferredTasksRun;
+            requestRedraw();
+            return true;
+        }
+        return false;
+    }
+
+    const FrameStats &stats() const { return stats_; }
+    void resetStats() { stats_ = FrameStats(); }
+
+private:
+    struct DeferredTask {
+        std::string name;
+        std::function<void()> run;
+        Clock::time_point queuedAt;
+    };
+
+    struct TaskCost {
+        std::string name;
+        double ms;
+    };
+
+    static double elapsedMs(Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    }
+
+    // Sem histórico, a tarefa é tratada como cara (espera a cena parar).
+    double estimatedMs(const std::string &name) const {
+        for (const auto &cost: costs_)
+            if (cost.name == name) return cost.ms;
+        return budgetMs;
+    }
+
+    void recordCost(const std::string &name, double ms) {
+        for (auto &cost: costs_)
+            if (cost.name == name) {
+                cost.ms = ms;
+                return;
+            }
+        costs_.push_back({name, ms});
+    }
+
+    bool redrawPending_ = true; // O primeiro quadro sempre é desenhado
+    std::vector<DeferredTask> tasks_;
+    std::vector<TaskCost> costs_;
+    Clock::time_point frameStart_;
+    FrameStats stats_;
+};
+
+#endif // FRAME_SCHEDULER_H
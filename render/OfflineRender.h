@@ -0,0 +1,244 @@
+#ifndef OFFLINE_RENDER_H
+#define OFFLINE_RENDER_H
+
+/*
+ * ======================================================================================
+ * OFFLINE RENDER - RENDERIZAÇÃO PROGRESSIVA EM LOTE (SEM JANELA)
+ * ======================================================================================
+ *
+ * Complementa o PathTracer.h com tudo o que é necessário para renderizar uma imagem
+ * final fora do visualizador interativo:
+ *
+ * 1. PASSE DE RENDERIZAÇÃO (renderPass / renderPassBidirectional): Acumula UMA amostra
+ * por pixel, com o integrador padrão ou com o BDPT (Bidirectional.h). A semente de cada pixel é derivada de (semente do fluxo, passe, pixel),
+ * tornando o resultado determinístico e retomável.
+ *
+ * 2. LOOP OFFLINE (renderPathTracing): Renderiza até atingir o número de amostras
+ * desejado, gravando checkpoints periódicos (ver Checkpoint.h). Se um checkpoint
+ * compatível já existir, a renderização é retomada/estendida a partir dele. Um arquivo
+ * que existe mas não pode ser retomado (corrompido, de outra versão, cena, resolução ou
+ * integrador) nunca é sobrescrito: a renderização nem começa.
+ *
+ * ======================================================================================
+ */
+
+#include "PathTracer.h"
+#include "Checkpoint.h"
+#include "PtCamera.h"
+#include "Bidirectional.h"
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+extern SceneData *g_renderMesh;
+
+// ==========================================
+// 1. PASSE DE RENDERIZAÇÃO
+// ==========================================
+
+// Semente por pixel: mistura (semente do fluxo, passe, pixel) e "aquece" o PCG para
+// descorrelacionar pixels vizinhos. Fluxos com sementes diferentes geram sequências disjuntas.
+inline uint32_t pixelSeed(uint32_t streamSeed, uint32_t pass, uint32_t pixel) {
+    uint32_t state = streamSeed * 0x9E3779B9u;
+    state ^= pixel * 0x85EBCA6Bu;
+    hash_pcg(state);
+    state ^= pass * 0xC2B2AE35u;
+    hash_pcg(state);
+    return state;
+}
+
+// Acumula uma amostra por pixel na região [x0, x1) x [y0, y1).
+// O índice do pixel segue a convenção do g_accumBuffer (linha 0 = base da imagem, como no OpenGL).
+inline void renderPass(const PtCamera &cam, const SamplerStream &stream,
+                       int x0, int y0, int x1, int y1,
+                       std::vector<Vec3> &accum, std::vector<uint32_t> &counts) {
+#pragma omp parallel for schedule(dynamic, 2)
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            int i = (cam.height - 1 - y) * cam.width + x;
+            uint32_t seed = pixelSeed(stream.seed, stream.passes, (uint32_t) i);
+
+            // Filtro tenda (mesmo jitter do modo interativo)
+            float r1 = 2.0f * random_float(seed);
+            float r2 = 2.0f * random_float(seed);
+            float dx = (r1 < 1.0f) ? std::sqrt(r1) - 1.0f : 1.0f - std::sqrt(2.0f - r1);
+            float dy = (r2 < 1.0f) ? std::sqrt(r2) - 1.0f : 1.0f - std::sqrt(2.0f - r2);
+
+            Vec3 c = radiance(cameraRay(cam, x + dx, y + dy), seed);
+            accum[i] = accum[i] + c;
+            counts[i]++;
+        }
+    }
+}
+
+// Acumula uma amostra BDPT por pixel na imagem inteira (ver Bidirectional.h).
+// Sempre quadro inteiro: as contribuições de light tracing caem em qualquer pixel, e a
+// normalização da importância da câmera supõe um subcaminho de luz por pixel da imagem.
+// As contagens por pixel ficam a cargo de quem chama (uma amostra por pixel por passe).
+inline void renderPassBidirectional(const PtCamera &cam, const SamplerStream &stream, std::vector<Vec3> &accum) {
+#pragma omp parallel for schedule(dynamic, 2)
+    for (int y = 0; y < cam.height; ++y) {
+        for (int x = 0; x < cam.width; ++x) {
+            int i = (cam.height - 1 - y) * cam.width + x;
+            uint32_t seed = pixelSeed(stream.seed, stream.passes, (uint32_t) i);
+
+            // Filtro caixa: o light tracing projeta pontos no pixel inteiro [x, x+1)
+            double px = x + random_float(seed);
+            double py = y + random_float(seed);
+            Vec3 c = bdptSample(cam, px, py, seed, accum);
+#pragma omp atomic
+            accum[i].x += c.x;
+#pragma omp atomic
+            accum[i].y += c.y;
+#pragma omp atomic
+            accum[i].z += c.z;
+        }
+    }
+}
+
+// ==========================================
+// 2. PREPARAÇÃO DA CENA E SAÍDA
+// ==========================================
+
+// Copia a malha (já normalizada) para o formato do Path Tracer, triangulando em leque.
+inline void buildSceneFromMesh(SceneData &scene,
+                               const std::vector<std::array<float, 3> > &vertices,
+                               const std::vector<std::vector<unsigned int> > &faces) {
+    scene.vertices.clear();
+    scene.faces.clear();
+    scene.faceMaterials.clear();
+    for (const auto &v: vertices) scene.vertices.push_back(Vec3(v[0], v[1], v[2]));
+    for (const auto &f: faces) {
+        for (size_t k = 1; k + 1 < f.size(); ++k) {
+            scene.faces.push_back({f[0], f[k], f[k + 1]});
+            scene.faceMaterials.push_back(0);
+        }
+    }
+}
+
+// Grava a média (soma / contagem) do checkpoint como PPM binário (P6), de cima para baixo.
+inline bool writePPM(const std::string &path, const RenderCheckpoint &ck) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Erro ao abrir imagem para escrita: " << path << std::endl;
+        return false;
+    }
+    out << "P6\n" << ck.width << " " << ck.height << "\n255\n";
+    std::vector<unsigned char> row(ck.width * 3);
+    for (int y = 0; y < ck.height; ++y) {
+        for (int x = 0; x < ck.width; ++x) {
+            int i = (ck.height - 1 - y) * ck.width + x;
+            Vec3 c = ck.counts[i] ? ck.accum[i] * (1.0 / ck.counts[i]) : Vec3(0, 0, 0);
+            row[x * 3 + 0] = (unsigned char) toInt(c.x);
+            row[x * 3 + 1] = (unsigned char) toInt(c.y);
+            row[x * 3 + 2] = (unsigned char) toInt(c.z);
+        }
+        out.write(reinterpret_cast<const char *>(row.data()), row.size());
+    }
+    return out.good();
+}
+
+inline uint32_t minSampleCount(const RenderCheckpoint &ck) {
+    uint32_t m = 0xFFFFFFFFu;
+    for (uint32_t c: ck.counts) m = std::min(m, c);
+    return ck.counts.empty() ? 0 : m;
+}
+
+// ==========================================
+// 3. LOOP OFFLINE COM CHECKPOINTS
+// ==========================================
+
+struct OfflineRenderSettings {
+    int width = 800;
+    int height = 600;
+    int samplesPerPixel = 64; // Alvo total (inclui amostras de checkpoints retomados)
+    uint32_t seed = 1; // Semente do fluxo (use sementes diferentes em máquinas diferentes)
+    std::string checkpointPath; // Vazio = sem checkpoint
+    int checkpointIntervalSeconds = 300;
+    std::array<float, 5> camera = {0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+    int integrator = INTEGRATOR_PATH; // INTEGRATOR_PATH ou INTEGRATOR_BDPT (cenas com vidro)
+    std::string environmentPath; // Céu HDR equiretangular (.hdr); vazio = luz ambiente constante
+};
+
+// Retorna false (sem renderizar) se o checkpoint existe mas não pode ser retomado.
+inline bool renderPathTracing(const std::vector<std::array<float, 3> > &vertices_in,
+                              const std::vector<std::vector<unsigned int> > &faces_in, const std::string &outputName,
+                              const OfflineRenderSettings &settings = OfflineRenderSettings()) {
+    SceneData scene;
+    buildSceneFromMesh(scene, vertices_in, faces_in);
+    if (!settings.environmentPath.empty()) loadEnvironmentMap(settings.environmentPath, scene.environment);
+
+    // 1. Retoma um checkpoint compatível ou começa do zero. Um arquivo existente que não serve
+    // interrompe tudo (antes da BVH): gravar por cima dele destruiria horas de amostras.
+    RenderCheckpoint ck;
+    uint64_t sceneHash = hashScene(scene);
+    bool resumed = false;
+    if (!settings.checkpointPath.empty() && std::ifstream(settings.checkpointPath, std::ios::binary).is_open()) {
+        if (!loadCheckpoint(settings.checkpointPath, ck)) {
+            std::cerr << "Checkpoint existente nao pode ser lido: " << settings.checkpointPath
+                    << ". Nada foi renderizado; use outro arquivo de checkpoint ou remova este." << std::endl;
+            return false;
+        }
+        if (ck.sceneHash != sceneHash || ck.width != settings.width || ck.height != settings.height ||
+            ck.integrator != (uint32_t) settings.integrator || ck.streams.empty()) {
+            std::cerr << "Checkpoint " << settings.checkpointPath << " incompativel com a cena/resolucao/integrador"
+                    << " atual (" << ck.width << "x" << ck.height << ", integrador "
+                    << (ck.integrator == INTEGRATOR_BDPT ? "bdpt" : "pt")
+                    << "). Nada foi renderizado; use outro arquivo de checkpoint ou remova este." << std::endl;
+            return false;
+        }
+        resumed = true;
+        std::cout << "Retomando checkpoint " << settings.checkpointPath << " com " << minSampleCount(ck)
+                << " amostras por pixel." << std::endl;
+    }
+    if (!resumed) {
+        ck.reset(settings.width, settings.height);
+        ck.camera = settings.camera;
+        ck.sceneHash = sceneHash;
+        ck.integrator = (uint32_t) settings.integrator;
+        ck.streams = {SamplerStream{settings.seed, 0}};
+    }
+
+    std::cout << "Construindo BVH (" << scene.faces.size() << " triangulos)..." << std::endl;
+    buildBVH(scene);
+    g_renderMesh = &scene;
+
+    // A câmera sempre vem do checkpoint ao retomar, para que as amostras sejam somáveis.
+    PtCamera cam = makeCamera(ck.camera, ck.width, ck.height);
+    SamplerStream &stream = ck.streams.front();
+
+    // 2. Passes progressivos
+    using Clock = std::chrono::steady_clock;
+    auto lastSave = Clock::now();
+    auto start = Clock::now();
+    while ((int) minSampleCount(ck) < settings.samplesPerPixel) {
+        if (ck.integrator == INTEGRATOR_BDPT) {
+            renderPassBidirectional(cam, stream, ck.accum);
+            for (auto &c: ck.counts) c++;
+        } else {
+            renderPass(cam, stream, 0, 0, ck.width, ck.height, ck.accum, ck.counts);
+        }
+        stream.passes++;
+
+        double sinceSave = std::chrono::duration<double>(Clock::now() - lastSave).count();
+        if (!settings.checkpointPath.empty() && sinceSave >= settings.checkpointIntervalSeconds) {
+            if (saveCheckpoint(settings.checkpointPath, ck))
+                std::cout << "Checkpoint salvo (" << minSampleCount(ck) << " spp)." << std::endl;
+            lastSave = Clock::now();
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "Renderizacao concluida: " << minSampleCount(ck) << " spp em " << elapsed << " s." << std::endl;
+
+    // 3. Checkpoint final (permite estender para mais spp depois) e imagem
+    if (!settings.checkpointPath.empty()) saveCheckpoint(settings.checkpointPath, ck);
+    if (writePPM(outputName, ck)) std::cout << "Imagem salva em " << outputName << std::endl;
+
+    g_renderMesh = nullptr;
+    return true;
+}
+
+#endif
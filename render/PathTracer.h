@@ -53,6 +53,13 @@
  * - Por que usar: O `rand()` do C++  lento e tem estado global (ruim para paralelismo).
  * O PCG Hash  "stateless" e extremamente rpido, ideal para gerar rudo branco em GPU/CPU paralela.
  *
+ * 7.1 ENVIRONMENT MAP HDR (Iluminao de Ambiente):
+ * - O que : Uma imagem equiretangular HDR (.hdr) que define a radincia vinda de cada direo do cu.
+ * - Problema: Amostrar o cu uniformemente  muito ruidoso (o sol ocupa poucos texels).
+ * - Soluo: Tabelas alias 2D (marginal por linha + condicional por coluna) sorteiam texels em O(1)
+ * proporcionalmente  sua energia, e o MIS (heurstica da potncia) combina essa amostragem com a
+ * amostragem da BSDF, escolhendo automaticamente a estratgia menos ruidosa para cada direo.
+ *
  * ======================================================================================
  * 8. FLUXO DE EXECUO E JUSTIFICATIVA ARQUITETURAL (PIPELINE)
  * ======================================================================================
@@ -97,6 +104,9 @@
 #include <limits>
 #include <fstream>
 #include <cstdint>
+#include <string>
+
+#include "../libs/stb_image.h"
 
 // ==========================================
 // 1. MATEMTICA E GERADOR DE NMEROS (PRNG)
@@ -182,6 +192,22 @@ struct TextureData {
     std::vector<float> pixels;
 };
 
+// Tabela alias (Walker/Vose): sorteia um ndice de uma distribuio discreta em O(1).
+struct AliasTable {
+    std::vector<float> prob; // Probabilidade de ficar com o prprio ndice
+    std::vector<int> alias; // ndice alternativo
+    std::vector<float> pdf; // Probabilidade normalizada de cada ndice
+};
+
+// Mapa de ambiente equiretangular HDR (linha 0 = topo do cu) com as tabelas de amostragem.
+struct EnvironmentMap {
+    TextureData image{0, 0, {}}; // Radincia linear RGB (j multiplicada pela intensidade)
+    AliasTable marginal; // Distribuio das linhas
+    std::vector<AliasTable> conditional; // Distribuio das colunas em cada linha
+
+    bool loaded() const { return !image.pixels.empty(); }
+};
+
 // ==========================================
 // 2. ESTRUTURAS DE ACELERAO (BVH)
 // ==========================================
@@ -230,6 +256,9 @@ struct AABB {
     }
 };
 
+// Tamanho da pilha fixa usada na travessia (getIntersection).
+static const int BVH_STACK_SIZE = 64;
+
 // N da rvore BVH.
 struct BVHNode {
     AABB box;
@@ -249,6 +278,8 @@ struct SceneData {
     std::vector<int> faceTextureID;
     std::vector<std::vector<PtVec2> > faceUVs;
 
+    EnvironmentMap environment; // Cu HDR opcional (vazio = luz ambiente constante)
+
     BVHNode *bvhRoot = nullptr; // Raiz da rvore de acelerao
     ~SceneData() { clearTree(bvhRoot); } // Destrutor limpa a rvore
     void clearTree(BVHNode *node) {
@@ -310,12 +341,127 @@ inline BVHNode *buildBVHRecursive(SceneData &scene, int left, int right) {
     return node;
 }
 
+// ==========================================
+// 3. QUALIDADE DA BVH (RELATRIO)
+// ==========================================
+// A construo por ponto mdio  rpida, mas pode gerar rvores ruins (caixas irms
+// muito sobrepostas, rvores profundas). Este relatrio mede a rvore produzida.
+//
+// - Custo SAH (Surface Area Heuristic): custo esperado de um raio aleatrio, assumindo que
+// a chance de atingir uma caixa  proporcional  sua rea. Com C_trav = C_isect = 1:
+// SAH = soma(A(interno)) / A(raiz) + soma(A(folha) * tris) / A(raiz).
+// - Profundidade: a travessia usa uma pilha fixa de BVH_STACK_SIZE entradas; uma rvore
+// mais profunda que isso estoura a pilha.
+// - Sobreposio entre irmos: A(esq inter dir) / A(pai). Prximo de 0 = boa separao.
+
+struct BVHReport {
+    int nodeCount = 0;
+    int leafCount = 0;
+    int maxDepth = 0;
+    double avgLeafDepth = 0.0;
+    double sahCost = 0.0;
+    std::vector<int> leafSizeHistogram; // ndice = nmero de tringulos na folha
+    size_t memoryBytes = 0;
+    double meanSiblingOverlap = 0.0;
+    double maxSiblingOverlap = 0.0;
+};
+
+// Habilitado por padro em builds de debug; modos de benchmark ligam explicitamente.
+#ifndef NDEBUG
+inline bool g_bvhReportEnabled = true;
+#else
+inline bool g_bvhReportEnabled = false;
+#endif
+
+inline double surfaceArea(const AABB &b) {
+    Vec3 d = b.max - b.min;
+    if (d.x < 0 || d.y < 0 || d.z < 0) return 0.0;
+    return 2.0 * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+inline BVHReport analyzeBVH(const SceneData &scene) {
+    BVHReport report;
+    if (!scene.bvhRoot) return report;
+
+    double rootArea = std::max(surfaceArea(scene.bvhRoot->box), 1e-12);
+    double depthSum = 0.0, overlapSum = 0.0;
+    int internalCount = 0;
+
+    // Travessia iterativa com pilha dinmica (a rvore pode ser mais profunda que 64)
+    std::vector<std::pair<const BVHNode *, int> > stack = {{scene.bvhRoot, 0}};
+    while (!stack.empty()) {
+        const BVHNode *node = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+
+        report.nodeCount++;
+        report.maxDepth = std::max(report.maxDepth, depth);
+        double area = surfaceArea(node->box);
+
+        if (node->triCount > 0 || (!node->left && !node->right)) {
+            report.leafCount++;
+            depthSum += depth;
+            report.sahCost += area / rootArea * node->triCount;
+            if ((int) report.leafSizeHistogram.size() <= node->triCount)
+                report.leafSizeHistogram.resize(node->triCount + 1, 0);
+            report.leafSizeHistogram[node->triCount]++;
+            continue;
+        }
+
+        report.sahCost += area / rootArea;
+        if (node->left && node->right) {
+            AABB inter;
+            inter.min = Vec3(std::max(node->left->box.min.x, node->right->box.min.x),
+                             std::max(node->left->box.min.y, node->right->box.min.y),
+                             std::max(node->left->box.min.z, node->right->box.min.z));
+            inter.max = Vec3(std::min(node->left->box.max.x, node->right->box.max.x),
+                             std::min(node->left->box.max.y, node->right->box.max.y),
+                             std::min(node->left->box.max.z, node->right->box.max.z));
+            double overlap = area > 0 ? surfaceArea(inter) / area : 0.0;
+            overlapSum += overlap;
+            report.maxSiblingOverlap = std::max(report.maxSiblingOverlap, overlap);
+            internalCount++;
+        }
+        if (node->left) stack.push_back({node->left, depth + 1});
+        if (node->right) stack.push_back({node->right, depth + 1});
+    }
+
+    report.avgLeafDepth = report.leafCount ? depthSum / report.leafCount : 0.0;
+    report.meanSiblingOverlap = internalCount ? overlapSum / internalCount : 0.0;
+    report.memoryBytes = report.nodeCount * sizeof(BVHNode) + scene.triIndices.size() * sizeof(int);
+    return report;
+}
+
+inline void printBVHReport(const BVHReport &report, std::ostream &out) {
+    out << "=== BVH: " << report.nodeCount << " nos (" << report.leafCount << " folhas), "
+            << report.memoryBytes / 1024.0 << " KB ===\n";
+    out << "Custo SAH: " << report.sahCost << "\n";
+    out << "Profundidade: max=" << report.maxDepth << ", media das folhas=" << report.avgLeafDepth
+            << " (limite da pilha: " << BVH_STACK_SIZE << ")\n";
+    out << "Sobreposicao entre irmaos: media=" << report.meanSiblingOverlap << ", max="
+            << report.maxSiblingOverlap << "\n";
+    out << "Folhas por tamanho:";
+    for (size_t k = 0; k < report.leafSizeHistogram.size(); ++k)
+        if (report.leafSizeHistogram[k]) out << " [" << k << " tris]=" << report.leafSizeHistogram[k];
+    out << std::endl;
+
+    // A pilha da travessia precisa de at (profundidade + 1) entradas
+    if (report.maxDepth + 1 >= BVH_STACK_SIZE) {
+        std::cerr << "ERRO: profundidade da BVH (" << report.maxDepth << ") estoura a pilha de travessia ("
+                << BVH_STACK_SIZE << " entradas)!" << std::endl;
+    } else if (report.maxDepth + 1 >= BVH_STACK_SIZE - 8) {
+        std::cerr << "AVISO: profundidade da BVH (" << report.maxDepth << ") se aproxima do limite da pilha ("
+                << BVH_STACK_SIZE << ")." << std::endl;
+    }
+}
+
 // Funo de entrada para construir a BVH
 inline void buildBVH(SceneData &scene) {
     if (scene.faces.empty()) return;
     scene.triIndices.resize(scene.faces.size());
     for (size_t i = 0; i < scene.faces.size(); ++i) scene.triIndices[i] = i;
     scene.bvhRoot = buildBVHRecursive(scene, 0, scene.faces.size());
+    if (g_bvhReportEnabled) printBVHReport(analyzeBVH(scene), std::cout);
 }
 
 // ==========================================
@@ -387,6 +533,75 @@ inline Vec3 sampleTexture(const TextureData &tex, double u, double v) {
     return top * (1.0 - dy) + bot * dy;
 }
 
+// Contadores de custo da travessia (instrumentao do modo heatmap).
+// S so acumulados quando t_traversalStats aponta para uma estrutura; no render normal
+// o ponteiro  nulo e o custo se resume a um teste por chamada de getIntersection.
+struct TraversalStats {
+    uint32_t nodesVisited = 0; // Ns cuja caixa foi atingida (entramos no n)
+    uint32_t aabbTests = 0; // Testes Raio vs AABB
+    uint32_t triTests = 0; // Testes Raio vs Tringulo
+};
+
+inline thread_local TraversalStats *t_traversalStats = nullptr;
+
+// Interseo apenas com a malha de uma cena (travessia da BVH), sem cho nem luz.
+// Retorna o tringulo mais prximo em (0, t) - 't' entra como limite mximo da busca.
+inline bool intersectMesh(const SceneData &scene, const Ray &r, double &t, int &hitFaceIndex, Vec3 &normalHit,
+                          double &hitU, double &hitV) {
+    if (!scene.bvhRoot) return false;
+    bool hit = false;
+
+    const BVHNode *stack[BVH_STACK_SIZE]; // Pilha para evitar recurso lenta
+    int stackPtr = 0;
+    stack[stackPtr++] = scene.bvhRoot;
+    uint32_t aabbTests = 0, nodesVisited = 0, triTests = 0;
+
+    while (stackPtr > 0) {
+        const BVHNode *node = stack[--stackPtr];
+
+        //Se raio no toca a caixa, ignora tudo dentro
+        aabbTests++;
+        if (!node->box.intersect(r, t)) continue;
+        nodesVisited++;
+
+        if (node->triCount > 0) {
+            // N Folha
+            triTests += node->triCount;
+            for (int i = 0; i < node->triCount; ++i) {
+                int realIdx = scene.triIndices[node->firstTriIndex + i];
+                const auto &face = scene.faces[realIdx];
+                double u, v;
+                // Teste exato com tringulo
+                double d = intersectTriangle(r, scene.vertices[face[0]], scene.vertices[face[1]],
+                                             scene.vertices[face[2]], u, v);
+
+                if (d > 0 && d < t) {
+                    // Se achou coliso mais prxima
+                    t = d;
+                    hit = true;
+                    hitFaceIndex = realIdx;
+                    hitU = u;
+                    hitV = v;
+                    // Calcula normal geomtrica (Cross product das arestas)
+                    normalHit = (scene.vertices[face[1]] - scene.vertices[face[0]]).cross(
+                        scene.vertices[face[2]] - scene.vertices[face[0]]).norm();
+                }
+            }
+        } else {
+            // N Interno: Continua descendo na rvore
+            if (node->right) stack[stackPtr++] = node->right;
+            if (node->left) stack[stackPtr++] = node->left;
+        }
+    }
+
+    if (t_traversalStats) {
+        t_traversalStats->aabbTests += aabbTests;
+        t_traversalStats->nodesVisited += nodesVisited;
+        t_traversalStats->triTests += triTests;
+    }
+    return hit;
+}
+
 // Funo Principal de Interseco (Scene Traversal).
 // Percorre a BVH e testa objetos da cena para encontrar a coliso mais prxima.
 inline bool getIntersection(const Ray &r, double &t, int &id, Vec3 &normalHit, int &hitFaceIndex, double &hitU,
@@ -397,46 +612,9 @@ inline bool getIntersection(const Ray &r, double &t, int &id, Vec3 &normalHit, i
     hitFaceIndex = -1;
 
     // 1. Testa Malha (BVH)
-    if (g_renderMesh && g_renderMesh->bvhRoot) {
-        const BVHNode *stack[64]; // Pilha para evitar recurso lenta
-        int stackPtr = 0;
-        stack[stackPtr++] = g_renderMesh->bvhRoot;
-
-        while (stackPtr > 0) {
-            const BVHNode *node = stack[--stackPtr];
-
-            //Se raio no toca a caixa, ignora tudo dentro
-            if (!node->box.intersect(r, t)) continue;
-
-            if (node->triCount > 0) {
-                // N Folha
-                for (int i = 0; i < node->triCount; ++i) {
-                    int realIdx = g_renderMesh->triIndices[node->firstTriIndex + i];
-                    const auto &face = g_renderMesh->faces[realIdx];
-                    double u, v;
-                    // Teste exato com tringulo
-                    double d = intersectTriangle(r, g_renderMesh->vertices[face[0]], g_renderMesh->vertices[face[1]],
-                                                 g_renderMesh->vertices[face[2]], u, v);
-
-                    if (d > 0 && d < t) {
-                        // Se achou coliso mais prxima
-                        t = d;
-                        id = 1;
-                        hit = true;
-                        hitFaceIndex = realIdx;
-                        hitU = u;
-                        hitV = v;
-                        // Calcula normal geomtrica (Cross product das arestas)
-                        normalHit = (g_renderMesh->vertices[face[1]] - g_renderMesh->vertices[face[0]]).cross(
-                            g_renderMesh->vertices[face[2]] - g_renderMesh->vertices[face[0]]).norm();
-                    }
-                }
-            } else {
-                // N Interno: Continua descendo na rvore
-                if (node->right) stack[stackPtr++] = node->right;
-                if (node->left) stack[stackPtr++] = node->left;
-            }
-        }
+    if (g_renderMesh && intersectMesh(*g_renderMesh, r, t, hitFaceIndex, normalHit, hitU, hitV)) {
+        id = 1;
+        hit = true;
     }
 
     // 2. Testa Cho Infinito (Procedural)
@@ -468,7 +646,137 @@ inline bool getIntersection(const Ray &r, double &t, int &id, Vec3 &normalHit, i
 }
 
 // ==========================================
-// 6. FUNO RADIANCE (Clculo de Luz)
+// 6. ILUMINAO AMBIENTE (ENVIRONMENT MAP HDR)
+// ==========================================
+
+// Constri a tabela alias para os pesos 'w' (no negativos). Pesos todos nulos viram uniforme.
+inline void buildAliasTable(AliasTable &table, const std::vector<double> &w) {
+    int n = (int) w.size();
+    table.prob.assign(n, 1.0f);
+    table.alias.assign(n, 0);
+    table.pdf.assign(n, n > 0 ? 1.0f / n : 0.0f);
+
+    double total = 0.0;
+    for (double x: w) total += x;
+    if (n == 0 || total <= 0.0) return;
+
+    // Divide os ndices em "pequenos" (abaixo da mdia) e "grandes" e emparelha-os
+    std::vector<double> scaled(n);
+    std::vector<int> small, large;
+    for (int i = 0; i < n; ++i) {
+        table.pdf[i] = (float) (w[i] / total);
+        scaled[i] = w[i] / total * n;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        int s = small.back(), l = large.back();
+        small.pop_back();
+        table.prob[s] = (float) scaled[s];
+        table.alias[s] = l;
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // Sobras (erro de arredondamento) ficam com probabilidade 1
+    for (int i: large) table.prob[i] = 1.0f;
+    for (int i: small) table.prob[i] = 1.0f;
+}
+
+inline int sampleAliasTable(const AliasTable &table, float r) {
+    int n = (int) table.prob.size();
+    int i = std::min(n - 1, (int) (r * n));
+    float frac = r * n - i;
+    return frac < table.prob[i] ? i : table.alias[i];
+}
+
+// Converte direo unitria <-> coordenadas (u, v) do mapa equiretangular.
+inline void directionToEquirect(const Vec3 &d, double &u, double &v) {
+    u = (std::atan2(d.z, d.x) + 3.14159265358979) / (2.0 * 3.14159265358979);
+    v = std::acos(std::max(-1.0, std::min(1.0, d.y))) / 3.14159265358979;
+}
+
+inline Vec3 equirectToDirection(double u, double v) {
+    double phi = u * 2.0 * 3.14159265358979 - 3.14159265358979;
+    double theta = v * 3.14159265358979;
+    return Vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+}
+
+// Carrega um .hdr (ou qualquer formato do stb, convertido para linear) e monta as tabelas.
+// Cada texel pesa luminncia * sen(theta): as linhas perto dos polos cobrem menos ngulo slido.
+inline bool loadEnvironmentMap(const std::string &path, EnvironmentMap &env, float intensity = 1.0f) {
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(false); // Linha 0 = topo (as texturas da malha usam o contrrio)
+    float *data = stbi_loadf(path.c_str(), &width, &height, &channels, 3);
+    if (!data) {
+        std::cerr << "Erro ao carregar environment map: " << path << " (" << stbi_failure_reason() << ")" << std::endl;
+        return false;
+    }
+
+    env.image.width = width;
+    env.image.height = height;
+    env.image.pixels.assign(data, data + (size_t) width * height * 3);
+    stbi_image_free(data);
+    for (auto &p: env.image.pixels) p *= intensity;
+
+    std::vector<double> rowWeights(height), colWeights(width);
+    env.conditional.assign(height, AliasTable());
+    for (int y = 0; y < height; ++y) {
+        double sinTheta = std::sin((y + 0.5) / height * 3.14159265358979);
+        double rowSum = 0.0;
+        for (int x = 0; x < width; ++x) {
+            const float *px = &env.image.pixels[((size_t) y * width + x) * 3];
+            colWeights[x] = (0.2126 * px[0] + 0.7152 * px[1] + 0.0722 * px[2]) * sinTheta;
+            rowSum += colWeights[x];
+        }
+        buildAliasTable(env.conditional[y], colWeights);
+        rowWeights[y] = rowSum;
+    }
+    buildAliasTable(env.marginal, rowWeights);
+
+    std::cout << "Environment map carregado: " << path << " (" << width << "x" << height << ")" << std::endl;
+    return true;
+}
+
+// Radincia do cu na direo unitria d.
+inline Vec3 environmentRadiance(const EnvironmentMap &env, const Vec3 &d) {
+    double u, v;
+    directionToEquirect(d, u, v);
+    return sampleTexture(env.image, u, v);
+}
+
+// Densidade (ngulo slido) de sampleEnvironment gerar a direo d.
+inline double environmentPdf(const EnvironmentMap &env, const Vec3 &d) {
+    double u, v;
+    directionToEquirect(d, u, v);
+    double sinTheta = std::sin(v * 3.14159265358979);
+    if (sinTheta <= 0.0) return 0.0;
+    int x = std::min(env.image.width - 1, (int) (u * env.image.width));
+    int y = std::min(env.image.height - 1, (int) (v * env.image.height));
+    double pdfUV = env.marginal.pdf[y] * env.conditional[y].pdf[x] * env.image.width * env.image.height;
+    return pdfUV / (2.0 * 3.14159265358979 * 3.14159265358979 * sinTheta);
+}
+
+// Sorteia uma direo proporcional  energia do cu (linha pela marginal, coluna pela condicional).
+inline Vec3 sampleEnvironment(const EnvironmentMap &env, uint32_t &seed, double &pdf) {
+    int y = sampleAliasTable(env.marginal, random_float(seed));
+    int x = sampleAliasTable(env.conditional[y], random_float(seed));
+    double u = (x + random_float(seed)) / env.image.width;
+    double v = (y + random_float(seed)) / env.image.height;
+    Vec3 d = equirectToDirection(u, v);
+    pdf = environmentPdf(env, d);
+    return d;
+}
+
+// Radincia de um raio que escapa da cena: cu HDR se houver, seno a luz ambiente constante.
+inline Vec3 backgroundRadiance(const Vec3 &d) {
+    if (g_renderMesh && g_renderMesh->environment.loaded()) return environmentRadiance(g_renderMesh->environment, d);
+    return Vec3(0.05, 0.05, 0.05);
+}
+
+// ==========================================
+// 7. FUNO RADIANCE (Clculo de Luz)
 // ==========================================
 inline Vec3 radiance(Ray r, uint32_t &seed) {
     Vec3 throughput(1.0, 1.0, 1.0); // Acumulador de cor do caminho (multiplicativo)
@@ -479,6 +787,11 @@ inline Vec3 radiance(Ray r, uint32_t &seed) {
     double lightRadius = 0.04;
     Vec3 lightEmission(8.0, 8.0, 8.0);
 
+    // --- CU HDR (opcional) ---
+    const EnvironmentMap *env = (g_renderMesh && g_renderMesh->environment.loaded()) ? &g_renderMesh->environment : nullptr;
+    double lastPdf = 0.0; // Densidade (ngulo slido) da BSDF que gerou o raio atual
+    bool lastSpecular = true; // Raio da cmera ou do vidro: o cu no pode ser amostrado explicitamente
+
     // Loop de Rebatimento (Bounces)
     for (int depth = 0; depth < 8; ++depth) {
         double t;
@@ -488,9 +801,17 @@ inline Vec3 radiance(Ray r, uint32_t &seed) {
         double u_bar, v_bar;
 
         // 1. Interseo com a Cena
-        // Se o raio no bater em nada, retorna a cor do cu (luz ambiente)
+        // Se o raio no bater em nada, retorna a cor do cu (luz ambiente ou environment map)
         if (!getIntersection(r, t, id, n, hitFaceIdx, u_bar, v_bar)) {
-            return finalColor + throughput * Vec3(0.05, 0.05, 0.05);
+            if (!env) return finalColor + throughput * Vec3(0.05, 0.05, 0.05);
+
+            // MIS: aps um rebatimento difuso, esta direo tambm poderia ter vindo do NEE do cu
+            double weight = 1.0;
+            if (!lastSpecular) {
+                double pdfEnv = environmentPdf(*env, r.d);
+                weight = (lastPdf * lastPdf) / (lastPdf * lastPdf + pdfEnv * pdfEnv);
+            }
+            return finalColor + throughput * environmentRadiance(*env, r.d) * weight;
         }
 
         // 2. Se bater na Fonte de Luz (ID 3)
@@ -523,6 +844,7 @@ inline Vec3 radiance(Ray r, uint32_t &seed) {
             // TIPO 2: VIDRO / DIELTRICO (Refrao & Reflexo)
             // ------------------------------------------------------
             if (matType == 2) {
+                lastSpecular = true;
 
                 bool into = n.dot(nl) > 0; // Verificar se o raio est entrando no objeto
                 double nc = 1.0; // ndice de refrao do Ar
@@ -638,6 +960,26 @@ inline Vec3 radiance(Ray r, uint32_t &seed) {
             finalColor = finalColor + throughput * directLightSum;
         }
 
+        // --- 1b. NEE do Cu HDR (amostragem por importncia + MIS) ---
+        if (env) {
+            double pdfEnv;
+            Vec3 L_dir = sampleEnvironment(*env, seed, pdfEnv);
+            double cosTheta = nl.dot(L_dir);
+            if (pdfEnv > 0.0 && cosTheta > 0.0) {
+                Ray shadowRay(x + nl * 1e-4, L_dir);
+                double t_s, u_s, v_s;
+                int id_s, fh_s;
+                Vec3 n_s;
+                if (!getIntersection(shadowRay, t_s, id_s, n_s, fh_s, u_s, v_s)) {
+                    // BRDF difusa (f / PI) e heurstica da potncia contra a amostragem por cosseno
+                    double pdfBsdf = cosTheta / 3.14159265358979;
+                    double weight = (pdfEnv * pdfEnv) / (pdfEnv * pdfEnv + pdfBsdf * pdfBsdf);
+                    Vec3 Le = environmentRadiance(*env, L_dir);
+                    finalColor = finalColor + throughput * f * Le * (pdfBsdf / pdfEnv * weight);
+                }
+            }
+        }
+
         // --- 2. Roleta Russa (Russian Roulette) ---
         // Termina caminhos aleatoriamente para evitar loop infinito
         double p = std::max({f.x, f.y, f.z});
@@ -663,6 +1005,9 @@ inline Vec3 radiance(Ray r, uint32_t &seed) {
         // Direo ponderada pelo cosseno
         Vec3 d = (u * std::cos(r1) * r2s + v * std::sin(r1) * r2s + w * std::sqrt(1 - r2)).norm();
 
+        lastPdf = nl.dot(d) / 3.14159265358979;
+        lastSpecular = false;
+
         // Prepara raio para a prxima iterao do loop
         r = Ray(x, d);
         r.o = r.o + r.d * 1e-4;
@@ -672,7 +1017,7 @@ inline Vec3 radiance(Ray r, uint32_t &seed) {
 }
 
 // ==========================================
-// 7. TONE MAPPING (ACES FILMIC)
+// 8. TONE MAPPING (ACES FILMIC)
 // ==========================================
 // Curva de resposta de filme para converter HDR (0 a infinito) para LDR (0 a 1)
 // Preserva contraste e saturao melhor que mtodos lineares.
@@ -701,8 +1046,4 @@ inline int toInt(double x) {
     return int(std::pow(clamp(x), 1.0 / 2.2) * 255.0 + 0.5);
 }
 
-inline void renderPathTracing(const std::vector<std::array<float, 3> > &vertices_in,
-                              const std::vector<std::vector<unsigned int> > &faces_in, const std::string &outputName) {
-}
-
 #endif
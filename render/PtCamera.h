@@ -0,0 +1,103 @@
+#ifndef PT_CAMERA_H
+#define PT_CAMERA_H
+
+/*
+ * ======================================================================================
+ * PT CAMERA - CÂMERA PINHOLE DO PATH TRACER
+ * ======================================================================================
+ *
+ * Mesma câmera orbital do modo interativo (rotação, zoom, pan), encapsulada para ser
+ * usada pelo main.cpp, pelo modo offline e pelos integradores.
+ *
+ * O plano de imagem fica a distância 1 da origem, com meia-largura |cx| e meia-altura |cy|.
+ * Além de gerar raios, a câmera sabe fazer o caminho inverso (ponto -> pixel), necessário
+ * para o light tracing do BDPT (ver Bidirectional.h).
+ *
+ * ======================================================================================
+ */
+
+#include "PathTracer.h"
+#include <array>
+#include <cmath>
+
+// ==========================================
+// 1. GERAÇÃO DE RAIOS
+// ==========================================
+
+struct PtCamera {
+    Vec3 origin, dir, cx, cy;
+    int width = 0, height = 0;
+};
+
+// Reproduz a câmera orbital do visualizador: a câmera gira em torno do alvo (pan)
+// a uma distância inversamente proporcional ao zoom.
+inline PtCamera makeCamera(float rotX, float rotY, float zoom, float offX, float offY, int width, int height) {
+    float radX = rotX * 0.0174533f;
+    float radY = rotY * 0.0174533f;
+    float dist = 4.0f / (zoom > 0.1f ? zoom : 0.1f);
+
+    float camX = std::sin(radY) * std::cos(radX) * dist;
+    float camY = -std::sin(radX) * dist;
+    float camZ = std::cos(radY) * std::cos(radX) * dist;
+    camX -= offX;
+    camY -= offY;
+
+    PtCamera cam;
+    cam.width = width;
+    cam.height = height;
+    cam.origin = Vec3(camX, camY, camZ);
+    Vec3 target(-offX, -offY, 0);
+    cam.dir = (target - cam.origin).norm();
+
+    Vec3 worldUp(0, 1, 0);
+    Vec3 right = cam.dir.cross(worldUp).norm();
+    Vec3 up = right.cross(cam.dir).norm();
+
+    double aspect = (double) width / (double) height;
+    cam.cx = right * 0.5135 * aspect;
+    cam.cy = up * -0.5135;
+    return cam;
+}
+
+inline PtCamera makeCamera(const std::array<float, 5> &params, int width, int height) {
+    return makeCamera(params[0], params[1], params[2], params[3], params[4], width, height);
+}
+
+// Raio primário para uma posição contínua do pixel (x, y), y crescendo para baixo.
+inline Ray cameraRay(const PtCamera &cam, double x, double y) {
+    Vec3 d = cam.cx * ((x / cam.width) - 0.5) * 2.0 +
+             cam.cy * ((y / cam.height) - 0.5) * 2.0 + cam.dir;
+    return Ray(cam.origin, d.norm());
+}
+
+// ==========================================
+// 2. IMPORTÂNCIA (CAMINHO INVERSO)
+// ==========================================
+
+// Área do plano de imagem (a distância 1 da câmera).
+inline double cameraFilmArea(const PtCamera &cam) {
+    return 4.0 * cam.cx.length() * cam.cy.length();
+}
+
+// Densidade (ângulo sólido) de a câmera gerar a direção unitária w ao amostrar o filme inteiro
+// uniformemente: 1 / (A * cos^3). Zero para direções atrás da câmera.
+inline double cameraPdfDir(const PtCamera &cam, const Vec3 &w) {
+    double cosTheta = w.dot(cam.dir);
+    if (cosTheta <= 0.0) return 0.0;
+    return 1.0 / (cameraFilmArea(cam) * cosTheta * cosTheta * cosTheta);
+}
+
+// Projeta a direção unitária w (saindo da câmera) no filme. Retorna false se cair fora da imagem.
+// (px, py) segue a mesma convenção do cameraRay: y cresce para baixo.
+inline bool cameraRaster(const PtCamera &cam, const Vec3 &w, double &px, double &py) {
+    double cosTheta = w.dot(cam.dir);
+    if (cosTheta <= 0.0) return false;
+    Vec3 onPlane = w * (1.0 / cosTheta) - cam.dir; // cx e cy são ortogonais a dir
+    double a = onPlane.dot(cam.cx) / cam.cx.dot(cam.cx);
+    double b = onPlane.dot(cam.cy) / cam.cy.dot(cam.cy);
+    px = (a + 1.0) * 0.5 * cam.width;
+    py = (b + 1.0) * 0.5 * cam.height;
+    return a >= -1.0 && a < 1.0 && b >= -1.0 && b < 1.0;
+}
+
+#endif
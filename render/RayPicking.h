@@ -0,0 +1,275 @@
+#ifndef RAY_PICKING_H
+#define RAY_PICKING_H
+
+/*
+ * ======================================================================================
+ * RAY PICKING - SELEÇÃO POR RAIO NA CPU (BVH PERSISTENTE DA MALHA EDITADA)
+ * ======================================================================================
+ *
+ * Alternativa ao color picking (ObjectPicking.cpp), que depende do contexto OpenGL e
+ * redesenha a malha a cada clique. Aqui o clique vira um raio da câmera do visualizador,
+ * lançado contra uma BVH (a mesma do Path Tracer) construída sobre a triangulação em
+ * cache do objeto. A BVH só é refeita quando a versão da geometria do objeto muda.
+ *
+ * 1. FACE: o triângulo mais próximo atingido pelo raio, mapeado para a face original.
+ * 2. VÉRTICE: entre os vértices da face atingida (e os vértices soltos, sem face), o mais
+ * próximo do cursor na tela, dentro de uma tolerância em pixels.
+ *
+ * 3. REGIÃO (retângulo/laço): percorre a BVH descartando nós cuja caixa projetada não toca
+ * o polígono. Seleciona "através" da malha (inclui o que está encoberto): a face entra se
+ * seu centroide projetado cai dentro do polígono; o vértice, se sua projeção cai.
+ *
+ * Não usa OpenGL: funciona em modos sem janela e é barato o bastante para hover.
+ *
+ * ======================================================================================
+ */
+
+#include "PathTracer.h"
+#include "../models/object/Object.h"
+#include "../utils/math_utils.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ==========================================
+// 1. CÂMERA DO VISUALIZADOR (SEM OPENGL)
+// ==========================================
+
+// Mesmos valores de render::setup_opengl (gluPerspective e recuo da câmera).
+static const double PICK_FOV_Y_DEGREES = 45.0;
+static const double PICK_CAMERA_DISTANCE = 10.0;
+
+// Reproduz a pilha de matrizes do modo raster: Recuo * Pan * Zoom * RotX * RotY * Objeto.
+struct PickCamera {
+    float rotX = 0.0f, rotY = 0.0f, zoom = 1.0f, offX = 0.0f, offY = 0.0f;
+    std::array<float, 3> position = {0.0f, 0.0f, 0.0f}; // Posição e escala do objeto
+    float scale = 1.0f;
+    int width = 1, height = 1;
+};
+
+inline PickCamera makePickCamera(float rotX, float rotY, float zoom, float offX, float offY,
+                                 const object::Object &obj, int width, int height) {
+    PickCamera cam;
+    cam.rotX = rotX;
+    cam.rotY = rotY;
+    cam.zoom = zoom;
+    cam.offX = offX;
+    cam.offY = offY;
+    cam.position = obj.getPosition();
+    cam.scale = obj.getScale();
+    cam.width = width > 0 ? width : 1;
+    cam.height = height > 0 ? height : 1;
+    return cam;
+}
+
+// Ponto em coordenadas do objeto -> coordenadas do olho (mesma ordem do glRotatef/glScalef).
+inline Vec3 pickObjectToEye(const PickCamera &cam, const Vec3 &p) {
+    double ax = cam.rotX * M_PI / 180.0, ay = cam.rotY * M_PI / 180.0;
+    Vec3 v(p.x * cam.scale + cam.position[0], p.y * cam.scale + cam.position[1], p.z * cam.scale + cam.position[2]);
+    v = Vec3(v.x * std::cos(ay) + v.z * std::sin(ay), v.y, -v.x * std::sin(ay) + v.z * std::cos(ay)); // RotY
+    v = Vec3(v.x, v.y * std::cos(ax) - v.z * std::sin(ax), v.y * std::sin(ax) + v.z * std::cos(ax)); // RotX
+    v = v * cam.zoom;
+    return Vec3(v.x + cam.offX, v.y + cam.offY, v.z - PICK_CAMERA_DISTANCE);
+}
+
+// Inverso de pickObjectToEye. 'point' = false ignora as translações (direções).
+inline Vec3 pickEyeToObject(const PickCamera &cam, const Vec3 &e, bool point) {
+    double ax = cam.rotX * M_PI / 180.0, ay = cam.rotY * M_PI / 180.0;
+    Vec3 v = point ? Vec3(e.x - cam.offX, e.y - cam.offY, e.z + PICK_CAMERA_DISTANCE) : e;
+    v = v * (1.0 / cam.zoom);
+    v = Vec3(v.x, v.y * std::cos(ax) + v.z * std::sin(ax), -v.y * std::sin(ax) + v.z * std::cos(ax)); // RotX^-1
+    v = Vec3(v.x * std::cos(ay) - v.z * std::sin(ay), v.y, v.x * std::sin(ay) + v.z * std::cos(ay)); // RotY^-1
+    if (point) v = Vec3(v.x - cam.position[0], v.y - cam.position[1], v.z - cam.position[2]);
+    return v * (1.0 / cam.scale);
+}
+
+// Projeta um ponto do objeto na janela (pixels, Y de cima para baixo, como no GLUT).
+inline bool pickProject(const PickCamera &cam, const Vec3 &p, double &sx, double &sy) {
+    Vec3 e = pickObjectToEye(cam, p);
+    if (e.z >= 0.0) return false; // Atrás da câmera
+    double tanY = std::tan(PICK_FOV_Y_DEGREES * M_PI / 360.0);
+    double aspect = (double) cam.width / (double) cam.height;
+    double ndcX = e.x / (-e.z * tanY * aspect);
+    double ndcY = e.y / (-e.z * tanY);
+    sx = (ndcX + 1.0) * 0.5 * cam.width;
+    sy = (1.0 - ndcY) * 0.5 * cam.height;
+    return true;
+}
+
+// Raio (em coordenadas do objeto) que passa pelo centro do pixel (mouseX, mouseY).
+inline Ray pickRay(const PickCamera &cam, double mouseX, double mouseY) {
+    double tanY = std::tan(PICK_FOV_Y_DEGREES * M_PI / 360.0);
+    double aspect = (double) cam.width / (double) cam.height;
+    Vec3 dirEye(((mouseX + 0.5) / cam.width * 2.0 - 1.0) * tanY * aspect,
+                (1.0 - (mouseY + 0.5) / cam.height * 2.0) * tanY, -1.0);
+    Vec3 origin = pickEyeToObject(cam, Vec3(0, 0, 0), true);
+    return Ray(origin, pickEyeToObject(cam, dirEye, false).norm());
+}
+
+// ==========================================
+// 2. BVH PERSISTENTE DA MALHA EDITADA
+// ==========================================
+
+struct RayPicker {
+    SceneData scene; // Triângulos do objeto (coordenadas locais) + BVH
+    unsigned int geometryVersion = 0; // Versão do objeto usada na última construção
+    std::vector<int> looseVertices; // Vértices sem face (não há triângulo para atingi-los)
+};
+
+// Reconstrói a BVH apenas se a geometria do objeto mudou desde a última chamada.
+inline void syncRayPicker(RayPicker &picker, const object::Object &obj) {
+    if (picker.geometryVersion == obj.getGeometryVersion()) return;
+    picker.geometryVersion = obj.getGeometryVersion();
+
+    SceneData &scene = picker.scene;
+    scene.clearTree(scene.bvhRoot);
+    scene.bvhRoot = nullptr;
+    scene.vertices.clear();
+    scene.faces.clear();
+    scene.faceMaterials.clear();
+
+    const auto &vertices = obj.getVertices();
+    const auto &tris = obj.getTriangleIndices();
+    std::vector<unsigned char> used(vertices.size(), 0);
+    for (const auto &v: vertices) scene.vertices.push_back(Vec3(v[0], v[1], v[2]));
+    for (size_t t = 0; t + 2 < tris.size(); t += 3) {
+        scene.faces.push_back({tris[t], tris[t + 1], tris[t + 2]});
+        scene.faceMaterials.push_back(0);
+        used[tris[t]] = used[tris[t + 1]] = used[tris[t + 2]] = 1;
+    }
+    picker.looseVertices.clear();
+    for (size_t i = 0; i < used.size(); ++i)
+        if (!used[i]) picker.looseVertices.push_back((int) i);
+
+    buildBVH(scene);
+}
+
+// ==========================================
+// 3. CONSULTA
+// ==========================================
+
+struct RayPickResult {
+    int face = -1; // Face original (N-Gono) atingida; -1 = nenhuma
+    int vertex = -1; // Vértice dentro da tolerância; -1 = nenhum
+    double distance = 0.0; // Distância ao longo do raio (coordenadas do objeto)
+};
+
+inline RayPickResult rayPick(RayPicker &picker, const object::Object &obj, const PickCamera &cam,
+                             double mouseX, double mouseY, double tolerancePx = 5.0) {
+    syncRayPicker(picker, obj);
+    RayPickResult result;
+
+    // 1. Face mais próxima
+    Ray ray = pickRay(cam, mouseX, mouseY);
+    double t = 1e20, u, v;
+    int tri = -1;
+    Vec3 nrm;
+    const auto &triToFace = obj.getTriangleToFace();
+    if (intersectMesh(picker.scene, ray, t, tri, nrm, u, v) && tri >= 0 && tri < (int) triToFace.size()) {
+        result.face = triToFace[tri];
+        result.distance = t;
+    }
+
+    // 2. Vértice mais próximo do cursor (na tela) entre os candidatos
+    double best = tolerancePx * tolerancePx;
+    auto consider = [&](int vi) {
+        double sx, sy;
+        if (!pickProject(cam, picker.scene.vertices[vi], sx, sy)) return;
+        double dx = sx - (mouseX + 0.5), dy = sy - (mouseY + 0.5); // Centro do pixel
+        double d2 = dx * dx + dy * dy;
+        if (d2 <= best) {
+            best = d2;
+            result.vertex = vi;
+        }
+    };
+    if (result.face >= 0)
+        for (unsigned int vi: obj.getFaces()[result.face]) consider((int) vi);
+    for (int vi: picker.looseVertices) consider(vi);
+    return result;
+}
+
+// Faces (vertices = false) ou vértices dentro de um polígono na tela (pixels da janela, Y para baixo).
+inline std::vector<int> rayPickRegion(RayPicker &picker, const object::Object &obj, const PickCamera &cam,
+                                      const std::vector<std::array<float, 2> > &polygon, bool vertices) {
+    syncRayPicker(picker, obj);
+    std::vector<int> ids;
+    const SceneData &scene = picker.scene;
+    if (polygon.size() < 3) return ids;
+
+    double minX = polygon[0][0], maxX = minX, minY = polygon[0][1], maxY = minY;
+    for (const auto &p: polygon) {
+        minX = std::min(minX, (double) p[0]);
+        maxX = std::max(maxX, (double) p[0]);
+        minY = std::min(minY, (double) p[1]);
+        maxY = std::max(maxY, (double) p[1]);
+    }
+    auto inside = [&](const Vec3 &p) {
+        double sx, sy;
+        return pickProject(cam, p, sx, sy) && sx >= minX && sx <= maxX && sy >= minY && sy <= maxY &&
+               math_utils::point_in_polygon((float) sx, (float) sy, polygon);
+    };
+
+    const auto &faces = obj.getFaces();
+    const auto &triToFace = obj.getTriangleToFace();
+    std::vector<unsigned char> seen(vertices ? scene.vertices.size() : faces.size(), 0);
+    auto visit = [&](int id, const Vec3 &p) {
+        if (seen[id]) return;
+        seen[id] = 1;
+        if (inside(p)) ids.push_back(id);
+    };
+
+    if (scene.bvhRoot) {
+        const BVHNode *stack[BVH_STACK_SIZE];
+        int stackPtr = 0;
+        stack[stackPtr++] = scene.bvhRoot;
+        while (stackPtr > 0) {
+            const BVHNode *node = stack[--stackPtr];
+
+            // Caixa projetada: se todos os cantos estão à frente da câmera e fora do retângulo
+            // envolvente do polígono, nada dentro do nó pode ser selecionado.
+            double bx0 = 1e30, bx1 = -1e30, by0 = 1e30, by1 = -1e30;
+            bool behind = false;
+            for (int c = 0; c < 8; ++c) {
+                Vec3 corner(c & 1 ? node->box.max.x : node->box.min.x, c & 2 ? node->box.max.y : node->box.min.y,
+                            c & 4 ? node->box.max.z : node->box.min.z);
+                double sx, sy;
+                if (!pickProject(cam, corner, sx, sy)) {
+                    behind = true; // Projeção não é limitada: desce sem descartar
+                    break;
+                }
+                bx0 = std::min(bx0, sx);
+                bx1 = std::max(bx1, sx);
+                by0 = std::min(by0, sy);
+                by1 = std::max(by1, sy);
+            }
+            if (!behind && (bx1 < minX || bx0 > maxX || by1 < minY || by0 > maxY)) continue;
+
+            if (node->triCount > 0) {
+                for (int i = 0; i < node->triCount; ++i) {
+                    int tri = scene.triIndices[node->firstTriIndex + i];
+                    if (vertices) {
+                        for (unsigned int vi: scene.faces[tri]) visit((int) vi, scene.vertices[vi]);
+                    } else if (tri < (int) triToFace.size()) {
+                        int f = triToFace[tri];
+                        Vec3 centroid(0, 0, 0);
+                        for (unsigned int vi: faces[f]) centroid = centroid + scene.vertices[vi];
+                        visit(f, centroid * (1.0 / faces[f].size()));
+                    }
+                }
+            } else {
+                if (node->right) stack[stackPtr++] = node->right;
+                if (node->left) stack[stackPtr++] = node->left;
+            }
+        }
+    }
+    if (vertices)
+        for (int vi: picker.looseVertices) visit(vi, scene.vertices[vi]);
+    return ids;
+}
+
+#endif
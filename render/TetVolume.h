@@ -0,0 +1,309 @@
+#ifndef TET_VOLUME_H
+#define TET_VOLUME_H
+
+/*
+ * ======================================================================================
+ * TET VOLUME - RENDERIZAÇÃO VOLUMÉTRICA DE MALHAS TETRAÉDRICAS (TET WALKING)
+ * ======================================================================================
+ *
+ * Malhas tetraédricas (coração, dragão) normalmente só aparecem como superfície: para a
+ * BVH do Path Tracer elas são apenas uma sopa de faces. Este modo usa a ADJACÊNCIA entre
+ * tetraedros para caminhar com o raio de célula em célula, acumulando a densidade ou o
+ * escalar de cada uma (modelo emissão-absorção).
+ *
+ * 1. ADJACÊNCIA: Cada face de tetraedro (a face i é a oposta ao vértice i) é ligada à
+ * face idêntica do vizinho. Faces sem par formam a FRONTEIRA do volume.
+ *
+ * 2. ENTRADA: Só as faces de fronteira vão para a BVH (uma SceneData própria). Ela é
+ * consultada apenas para achar a célula de entrada - e de reentrada, em volumes não
+ * convexos - nunca durante a caminhada.
+ *
+ * 3. CAMINHADA: Dentro da célula, a saída é o menor 't' entre os planos das outras três
+ * faces que o raio atravessa "para fora". O vizinho daquela face é a próxima célula.
+ * O laço termina quando a transmitância fica desprezível (saída antecipada).
+ *
+ * ======================================================================================
+ */
+
+#include "PathTracer.h"
+#include "OfflineRender.h"
+#include "TraversalHeatmap.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Tipo VTK do tetraedro (CELL_TYPES)
+const int VTK_TETRA = 10;
+
+// Vértices locais de cada face; a face i é a oposta ao vértice i.
+const int TET_FACE_VERTS[4][3] = {{1, 2, 3}, {0, 3, 2}, {0, 1, 3}, {0, 2, 1}};
+
+struct TetMesh {
+    std::vector<Vec3> vertices;
+    std::vector<std::array<int, 4> > tets;
+    std::vector<std::array<int, 4> > neighbors; // Tetraedro vizinho por face (-1 = fronteira)
+    std::vector<std::array<int, 4> > neighborFace; // Face correspondente no vizinho
+    std::vector<double> value; // Atributo por célula normalizado em [0, 1]
+    bool fromScalars = false; // true = CELL_DATA do arquivo; false = densidade de refinamento
+
+    // Fronteira do volume: triângulos + BVH, com a célula/face de origem de cada triângulo
+    SceneData boundary;
+    std::vector<int> boundaryTet, boundaryFace;
+};
+
+struct VolumeRenderSettings {
+    int width = 800;
+    int height = 600;
+    double density = 4.0; // Coeficiente de extinção para valor 1 (unidades da cena normalizada)
+    std::array<float, 5> camera = {0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+};
+
+// Custo da caminhada (para comparar com o custo da BVH em modo superfície)
+struct TetWalkStats {
+    uint64_t cellsVisited = 0;
+    uint64_t bvhQueries = 0;
+    uint64_t earlyExits = 0;
+};
+
+// ==========================================
+// 1. CONSTRUÇÃO (ADJACÊNCIA E FRONTEIRA)
+// ==========================================
+
+inline double tetSignedVolume(const Vec3 &a, const Vec3 &b, const Vec3 &c, const Vec3 &d) {
+    return (b - a).cross(c - a).dot(d - a) / 6.0;
+}
+
+// Monta a malha a partir das células lidas do arquivo. Células com 4 vértices são
+// tetraedros quando 'cellTypes' está vazio (POLYDATA) ou marca VTK_TETRA.
+// 'cellScalars' (opcional) é o primeiro campo de CELL_DATA.
+inline bool buildTetMesh(TetMesh &mesh, const std::vector<std::array<float, 3> > &vertices,
+                         const std::vector<std::vector<unsigned int> > &cells, const std::vector<int> &cellTypes,
+                         const std::vector<double> &cellScalars) {
+    mesh.vertices.clear();
+    mesh.tets.clear();
+    for (const auto &v: vertices) mesh.vertices.push_back(Vec3(v[0], v[1], v[2]));
+
+    std::vector<double> raw;
+    mesh.fromScalars = cellScalars.size() == cells.size();
+    size_t degenerate = 0;
+    for (size_t c = 0; c < cells.size(); ++c) {
+        if (cells[c].size() != 4) continue;
+        if (!cellTypes.empty() && (c >= cellTypes.size() || cellTypes[c] != VTK_TETRA)) continue;
+        std::array<int, 4> t = {(int) cells[c][0], (int) cells[c][1], (int) cells[c][2], (int) cells[c][3]};
+        double vol = tetSignedVolume(mesh.vertices[t[0]], mesh.vertices[t[1]], mesh.vertices[t[2]],
+                                     mesh.vertices[t[3]]);
+        // Células achatadas travariam a caminhada (planos indefinidos): ficam de fora
+        if (std::fabs(vol) < 1e-15) {
+            degenerate++;
+            continue;
+        }
+        if (vol < 0) std::swap(t[2], t[3]); // Orientação positiva
+        mesh.tets.push_back(t);
+        // Sem escalar no arquivo, o atributo é a densidade de refinamento (log de 1/volume)
+        raw.push_back(mesh.fromScalars ? cellScalars[c] : -std::log(std::fabs(vol)));
+    }
+    if (mesh.tets.empty()) {
+        std::cerr << "Nenhum tetraedro encontrado na malha." << std::endl;
+        return false;
+    }
+    if (degenerate) std::cerr << "Aviso: " << degenerate << " tetraedros degenerados ignorados." << std::endl;
+
+    // Normaliza o atributo para [0, 1]
+    double lo = *std::min_element(raw.begin(), raw.end());
+    double hi = *std::max_element(raw.begin(), raw.end());
+    mesh.value.resize(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) mesh.value[i] = hi > lo ? (raw[i] - lo) / (hi - lo) : 1.0;
+
+    // Adjacência: ordena as faces pela tripla de vértices; faces iguais ficam vizinhas no vetor
+    struct FaceKey {
+        std::array<int, 3> v;
+        int tet, face;
+    };
+    std::vector<FaceKey> keys;
+    keys.reserve(mesh.tets.size() * 4);
+    for (int t = 0; t < (int) mesh.tets.size(); ++t) {
+        for (int f = 0; f < 4; ++f) {
+            std::array<int, 3> v = {
+                mesh.tets[t][TET_FACE_VERTS[f][0]], mesh.tets[t][TET_FACE_VERTS[f][1]],
+                mesh.tets[t][TET_FACE_VERTS[f][2]]
+            };
+            std::sort(v.begin(), v.end());
+            keys.push_back({v, t, f});
+        }
+    }
+    std::sort(keys.begin(), keys.end(), [](const FaceKey &a, const FaceKey &b) { return a.v < b.v; });
+
+    mesh.neighbors.assign(mesh.tets.size(), {-1, -1, -1, -1});
+    mesh.neighborFace.assign(mesh.tets.size(), {-1, -1, -1, -1});
+    size_t nonManifold = 0;
+    for (size_t i = 0; i < keys.size();) {
+        size_t j = i + 1;
+        while (j < keys.size() && keys[j].v == keys[i].v) ++j;
+        if (j - i == 2) {
+            const FaceKey &a = keys[i], &b = keys[i + 1];
+            mesh.neighbors[a.tet][a.face] = b.tet;
+            mesh.neighborFace[a.tet][a.face] = b.face;
+            mesh.neighbors[b.tet][b.face] = a.tet;
+            mesh.neighborFace[b.tet][b.face] = a.face;
+        } else if (j - i > 2) {
+            nonManifold++; // Todas as cópias viram fronteira
+        }
+        i = j;
+    }
+    if (nonManifold) std::cerr << "Aviso: " << nonManifold << " faces compartilhadas por mais de 2 celulas." << std::endl;
+
+    // Fronteira -> SceneData com BVH própria (apenas para achar a célula de entrada)
+    SceneData &b = mesh.boundary;
+    b.vertices = mesh.vertices;
+    b.faces.clear();
+    b.faceMaterials.clear();
+    mesh.boundaryTet.clear();
+    mesh.boundaryFace.clear();
+    for (int t = 0; t < (int) mesh.tets.size(); ++t) {
+        for (int f = 0; f < 4; ++f) {
+            if (mesh.neighbors[t][f] != -1) continue;
+            b.faces.push_back({
+                (unsigned int) mesh.tets[t][TET_FACE_VERTS[f][0]], (unsigned int) mesh.tets[t][TET_FACE_VERTS[f][1]],
+                (unsigned int) mesh.tets[t][TET_FACE_VERTS[f][2]]
+            });
+            b.faceMaterials.push_back(0);
+            mesh.boundaryTet.push_back(t);
+            mesh.boundaryFace.push_back(f);
+        }
+    }
+    buildBVH(b);
+    std::cout << "Malha tetraedrica: " << mesh.tets.size() << " celulas, " << b.faces.size()
+            << " faces de fronteira." << std::endl;
+    return true;
+}
+
+// ==========================================
+// 2. CAMINHADA DO RAIO (TET WALKING)
+// ==========================================
+
+// Normal (não normalizada) da face 'f' apontando para fora do tetraedro 't'.
+inline Vec3 tetFaceNormal(const TetMesh &mesh, int t, int f) {
+    const auto &tet = mesh.tets[t];
+    const Vec3 &a = mesh.vertices[tet[TET_FACE_VERTS[f][0]]];
+    const Vec3 &b = mesh.vertices[tet[TET_FACE_VERTS[f][1]]];
+    const Vec3 &c = mesh.vertices[tet[TET_FACE_VERTS[f][2]]];
+    Vec3 n = (b - a).cross(c - a);
+    if (n.dot(mesh.vertices[tet[f]] - a) > 0) n = n * -1.0;
+    return n;
+}
+
+// Integra emissão-absorção ao longo do raio. Retorna a cor acumulada e a transmitância final.
+inline Vec3 tetVolumeRadiance(const TetMesh &mesh, const Ray &ray, double density, double &transmittance,
+                              TetWalkStats &stats) {
+    const double EPS = 1e-7;
+    Vec3 color(0, 0, 0);
+    transmittance = 1.0;
+    double tCur = 0.0;
+
+    // Guarda contra laços por imprecisão numérica (nunca deveria ser atingida)
+    size_t maxSteps = mesh.tets.size() + 64;
+    size_t steps = 0;
+
+    while (steps < maxSteps) {
+        // 1. Entrada (ou reentrada) pela fronteira via BVH
+        Ray probe(ray.o + ray.d * tCur, ray.d);
+        double tHit = 1e20, u, v;
+        int tri;
+        Vec3 nrm;
+        stats.bvhQueries++;
+        if (!intersectMesh(mesh.boundary, probe, tHit, tri, nrm, u, v)) break;
+        tCur += tHit;
+
+        int cell = mesh.boundaryTet[tri];
+        int entryFace = mesh.boundaryFace[tri];
+        // Face de fronteira vista por dentro (câmera dentro do volume): ignora e segue
+        if (tetFaceNormal(mesh, cell, entryFace).dot(ray.d) > 0) {
+            tCur += EPS;
+            steps++;
+            continue;
+        }
+
+        // 2. Caminha de célula em célula enquanto houver vizinho
+        while (cell >= 0 && steps < maxSteps) {
+            steps++;
+            stats.cellsVisited++;
+            const auto &tet = mesh.tets[cell];
+
+            int exitFace = -1;
+            double tExit = 1e20;
+            for (int f = 0; f < 4; ++f) {
+                if (f == entryFace) continue;
+                Vec3 n = tetFaceNormal(mesh, cell, f);
+                double dn = n.dot(ray.d);
+                if (dn <= 0) continue; // Raio não sai por esta face
+                double tf = n.dot(mesh.vertices[tet[TET_FACE_VERTS[f][0]]] - ray.o) / dn;
+                if (tf < tExit) {
+                    tExit = tf;
+                    exitFace = f;
+                }
+            }
+            if (exitFace < 0) break; // Célula degenerada para este raio: volta para a BVH
+
+            // Acumula o segmento dentro da célula
+            double len = std::max(0.0, tExit - tCur);
+            double val = mesh.value[cell];
+            double sigma = density * (mesh.fromScalars ? val : 0.25 + 0.75 * val);
+            double alpha = 1.0 - std::exp(-sigma * len);
+            color = color + heatColor(val) * (transmittance * alpha);
+            transmittance *= 1.0 - alpha;
+            tCur = std::max(tCur, tExit);
+
+            if (transmittance < 1e-3) {
+                stats.earlyExits++;
+                return color; // Saída antecipada: o resto do caminho não contribui
+            }
+
+            entryFace = mesh.neighborFace[cell][exitFace];
+            cell = mesh.neighbors[cell][exitFace];
+        }
+        tCur += EPS; // Saiu pela fronteira (ou célula degenerada): procura reentrada adiante
+    }
+    return color;
+}
+
+// ==========================================
+// 3. IMAGEM E PONTO DE ENTRADA
+// ==========================================
+
+inline void renderTetVolume(const TetMesh &mesh, const std::string &outputName, const VolumeRenderSettings &settings) {
+    PtCamera cam = makeCamera(settings.camera, settings.width, settings.height);
+
+    // Reaproveita o formato do checkpoint (uma amostra por pixel) para gravar a imagem
+    RenderCheckpoint image;
+    image.reset(settings.width, settings.height);
+
+    uint64_t cellsVisited = 0, bvhQueries = 0, earlyExits = 0;
+    auto start = std::chrono::steady_clock::now();
+
+#pragma omp parallel for schedule(dynamic, 2) reduction(+:cellsVisited, bvhQueries, earlyExits)
+    for (int y = 0; y < cam.height; ++y) {
+        TetWalkStats stats;
+        for (int x = 0; x < cam.width; ++x) {
+            int i = (cam.height - 1 - y) * cam.width + x;
+            Ray ray = cameraRay(cam, x + 0.5, y + 0.5);
+            double transmittance;
+            Vec3 c = tetVolumeRadiance(mesh, ray, settings.density, transmittance, stats);
+            image.accum[i] = c + backgroundRadiance(ray.d) * transmittance;
+            image.counts[i] = 1;
+        }
+        cellsVisited += stats.cellsVisited;
+        bvhQueries += stats.bvhQueries;
+        earlyExits += stats.earlyExits;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double pixels = (double) cam.width * cam.height;
+    std::cout << "Volume renderizado em " << elapsed << " s: " << cellsVisited / pixels << " celulas/pixel, "
+            << bvhQueries / pixels << " consultas BVH/pixel, " << earlyExits << " saidas antecipadas." << std::endl;
+    if (writePPM(outputName, image)) std::cout << "Imagem salva em " << outputName << std::endl;
+}
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef TIMING_OVERLAY_H
+#define TIMING_OVERLAY_H
+
+/*
+ * ======================================================================================
+ * TIMING OVERLAY - PAINEL DE TEMPOS DE QUADRO (GPU/CPU) NO VISUALIZADOR
+ * ======================================================================================
+ *
+ * Desenhado por cima da cena (tecla 'G'), em coordenadas de janela e no pipeline fixo,
+ * como o traço da seleção por região:
+ *
+ * 1. GRÁFICO: os últimos HISTORY quadros, CPU (do início do display até o painel) e GPU
+ * (soma das passadas). A linha verde é o orçamento do agendador (FrameScheduler.h).
+ *
+ * 2. PASSADAS: faces, arestas, vértices, texturas e buffer de IDs, com o tempo de GPU
+ * (timer queries, ver ObjectProfiling.cpp) e o de submissão na CPU; depois as
+ * reconstruções e o descarte, que só existem na CPU.
+ *
+ * 3. VOLUME: triângulos, linhas, pontos, chamadas de desenho e bytes enviados à GPU.
+ *
+ * Com o redesenho sob demanda o gráfico só anda quando há quadros: cena parada, gráfico
+ * parado. Os tempos de GPU chegam com alguns quadros de atraso.
+ *
+ * ======================================================================================
+ */
+
+#include "../models/object/Object.h"
+#include "FrameScheduler.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// ==========================================
+// 1. HISTÓRICO
+// ==========================================
+
+struct TimingOverlay {
+    static const int HISTORY = 180;
+    bool visible = false;
+    std::vector<float> cpuMs = std::vector<float>(HISTORY, 0.0f);
+    std::vector<float> gpuMs = std::vector<float>(HISTORY, 0.0f);
+    int head = 0; // Próxima posição a escrever (anel)
+    int filled = 0;
+
+    void record(double cpuFrameMs, const object::FrameTimings &timings) {
+        double gpu = 0.0;
+        if (timings.gpuValid)
+            for (double ms: timings.gpuMs) gpu += ms;
+        cpuMs[head] = static_cast<float>(cpuFrameMs);
+        gpuMs[head] = static_cast<float>(gpu);
+        head = (head + 1) % HISTORY;
+        filled = std::min(filled + 1, HISTORY);
+    }
+};
+
+// ==========================================
+// 2. DESENHO
+// ==========================================
+
+inline void overlayText(float x, float y, const std::string &text) {
+    glRasterPos2f(x, y);
+    for (char c: text) glutBitmapCharacter(GLUT_BITMAP_8_BY_13, c);
+}
+
+inline std::string formatBytes(size_t bytes) {
+    char buf[32];
+    if (bytes >= 1024 * 1024) std::snprintf(buf, sizeof(buf), "%.2f MB", bytes / (1024.0 * 1024.0));
+    else if (bytes >= 1024) std::snprintf(buf, sizeof(buf), "%.1f KB", bytes / 1024.0);
+    else std::snprintf(buf, sizeof(buf), "%zu B", bytes);
+    return buf;
+}
+
+// Painel no canto superior esquerdo. 'budgetMs' marca o orçamento no gráfico.
+inline void drawTimingOverlay(const TimingOverlay &overlay, const object::FrameTimings &timings,
+                              const FrameStats &stats, double budgetMs, int winWidth, int winHeight) {
+    static const char *PASS_NAMES[object::PASS_COUNT] = {"faces", "arestas", "vertices", "texturas", "ids"};
+    const float panelX = 8.0f, panelY = 8.0f, panelW = 360.0f, lineH = 14.0f;
+    const float graphH = 70.0f;
+    const int textLines = 4 + object::PASS_COUNT + 4;
+    const float panelH = graphH + 16.0f + textLines * lineH;
+
+    glPushAttrib(GL_ENABLE_BIT | GL_LINE_BIT | GL_CURRENT_BIT | GL_COLOR_BUFFER_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_TEXTURE_2D);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, winWidth, winHeight, 0, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    // Fundo
+    glColor4f(0.1f, 0.1f, 0.1f, 0.75f);
+    glBegin(GL_QUADS);
+    glVertex2f(panelX, panelY);
+    glVertex2f(panelX + panelW, panelY);
+    glVertex2f(panelX + panelW, panelY + panelH);
+    glVertex2f(panelX, panelY + panelH);
+    glEnd();
+
+    // Gráfico: escala até o maior valor visível (no mínimo 2x o orçamento)
+    float gx = panelX + 8.0f, gy = panelY + 8.0f, gw = panelW - 16.0f;
+    float scale = static_cast<float>(budgetMs * 2.0);
+    for (int i = 0; i < overlay.filled; ++i)
+        scale = std::max(scale, std::max(overlay.cpuMs[i], overlay.gpuMs[i]));
+    auto plot = [&](const std::vector<float> &values) {
+        glBegin(GL_LINE_STRIP);
+        for (int i = 0; i < overlay.filled; ++i) {
+            int idx = (overlay.head - overlay.filled + i + TimingOverlay::HISTORY) % TimingOverlay::HISTORY;
+            float x = gx + gw * static_cast<float>(TimingOverlay::HISTORY - overlay.filled + i) /
+                                   (TimingOverlay::HISTORY - 1);
+            glVertex2f(x, gy + graphH - graphH * values[idx] / scale);
+        }
+        glEnd();
+    };
+    glLineWidth(1.0f);
+    glColor3f(0.2f, 0.8f, 0.2f); // Orçamento
+    float budgetY = gy + graphH - graphH * static_cast<float>(budgetMs) / scale;
+    glBegin(GL_LINES);
+    glVertex2f(gx, budgetY);
+    glVertex2f(gx + gw, budgetY);
+    glEnd();
+    glColor3f(0.3f, 0.6f, 1.0f);
+    plot(overlay.cpuMs);
+    glColor3f(1.0f, 0.6f, 0.2f);
+    plot(overlay.gpuMs);
+
+    // Texto
+    char line[128];
+    float y = gy + graphH + 20.0f;
+    auto text = [&](float r, float g, float b) {
+        glColor3f(r, g, b);
+        overlayText(gx, y, line);
+        y += lineH;
+    };
+    double gpuTotal = 0.0, cpuTotal = timings.rebuildMs + timings.cullMs;
+    for (int p = 0; p < object::PASS_COUNT; ++p) {
+        gpuTotal += timings.gpuMs[p];
+        cpuTotal += timings.cpuMs[p];
+    }
+    std::snprintf(line, sizeof(line), "CPU %.2f ms (media %.2f, pico %.2f)", stats.lastMs, stats.averageMs,
+                  stats.peakMs);
+    text(0.3f, 0.6f, 1.0f);
+    if (timings.gpuValid) std::snprintf(line, sizeof(line), "GPU %.2f ms", gpuTotal);
+    else std::snprintf(line, sizeof(line), "GPU -- (sem timer queries)");
+    text(1.0f, 0.6f, 0.2f);
+    std::snprintf(line, sizeof(line), "%lu quadros, %lu acima de %.1f ms", stats.frames, stats.overBudget, budgetMs);
+    text(0.8f, 0.8f, 0.8f);
+    std::snprintf(line, sizeof(line), "%-12s %9s %9s", "passada", "GPU ms", "CPU ms");
+    text(1.0f, 1.0f, 1.0f);
+    for (int p = 0; p < object::PASS_COUNT; ++p) {
+        if (timings.gpuValid)
+            std::snprintf(line, sizeof(line), "%-12s %9.3f %9.3f", PASS_NAMES[p], timings.gpuMs[p], timings.cpuMs[p]);
+        else
+            std::snprintf(line, sizeof(line), "%-12s %9s %9.3f", PASS_NAMES[p], "--", timings.cpuMs[p]);
+        text(0.9f, 0.9f, 0.9f);
+    }
+    std::snprintf(line, sizeof(line), "%-12s %9s %9.3f", "reconstrucao", "", timings.rebuildMs);
+    text(0.9f, 0.9f, 0.9f);
+    std::snprintf(line, sizeof(line), "%-12s %9s %9.3f", "descarte", "", timings.cullMs);
+    text(0.9f, 0.9f, 0.9f);
+    std::snprintf(line, sizeof(line), "%d triangulos, %d linhas, %d pontos", timings.triangles, timings.lines,
+                  timings.points);
+    text(0.8f, 0.8f, 0.8f);
+    std::snprintf(line, sizeof(line), "%d chamadas, envio %s (CPU objeto %.2f ms)", timings.drawCalls,
+                  formatBytes(timings.uploadBytes).c_str(), cpuTotal);
+    text(0.8f, 0.8f, 0.8f);
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glPopAttrib();
+}
+
+#endif // TIMING_OVERLAY_H
@@ -0,0 +1,206 @@
+#ifndef TRAVERSAL_HEATMAP_H
+#define TRAVERSAL_HEATMAP_H
+
+/*
+ * ======================================================================================
+ * TRAVERSAL HEATMAP - MAPA DE CALOR DO CUSTO DE TRAVESSIA DA BVH
+ * ======================================================================================
+ *
+ * Quando um frame está lento, não dá para saber só pelo tempo total se o culpado é a
+ * BVH (caixas grandes e sobrepostas) ou a cena (muitos triângulos finos no mesmo lugar).
+ * Este modo de instrumentação mede, POR PIXEL, quanto trabalho o getIntersection fez:
+ *
+ * - Nós visitados (caixas atingidas pelo raio)
+ * - Testes Raio vs AABB
+ * - Testes Raio vs Triângulo
+ *
+ * SAÍDAS:
+ * 1. Uma imagem em falsa cor por métrica (azul = barato, vermelho = caro).
+ * A escala pode ser fixada (scaleMax) para comparar BVHs diferentes na mesma vista.
+ * 2. Um histograma (CSV) e um resumo textual (média, percentis, máximo).
+ *
+ * ======================================================================================
+ */
+
+#include "PathTracer.h"
+#include "OfflineRender.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+struct HeatmapSettings {
+    int width = 800;
+    int height = 600;
+    int samplesPerPixel = 1;
+    bool primaryOnly = false; // true = só raios primários; false = caminho completo (bounces + sombras)
+    float scaleMax = 0.0f; // Valor mapeado para vermelho; 0 = automático (percentil 99)
+    int histogramBins = 32;
+    std::array<float, 5> camera = {0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+};
+
+// Custo médio por amostra de cada pixel (mesma ordem de linhas do g_accumBuffer).
+struct TraversalHeatmap {
+    int width = 0, height = 0;
+    std::vector<float> nodesVisited, aabbTests, triTests;
+};
+
+// ==========================================
+// 1. COLETA
+// ==========================================
+
+inline TraversalHeatmap renderTraversalHeatmap(const PtCamera &cam, const HeatmapSettings &settings) {
+    TraversalHeatmap map;
+    map.width = cam.width;
+    map.height = cam.height;
+    size_t n = static_cast<size_t>(cam.width) * cam.height;
+    map.nodesVisited.assign(n, 0.0f);
+    map.aabbTests.assign(n, 0.0f);
+    map.triTests.assign(n, 0.0f);
+
+    int spp = std::max(1, settings.samplesPerPixel);
+
+#pragma omp parallel for schedule(dynamic, 2)
+    for (int y = 0; y < cam.height; ++y) {
+        for (int x = 0; x < cam.width; ++x) {
+            int i = (cam.height - 1 - y) * cam.width + x;
+            TraversalStats stats;
+            t_traversalStats = &stats; // thread_local: cada thread conta apenas os seus raios
+
+            for (int s = 0; s < spp; ++s) {
+                uint32_t seed = pixelSeed(1, (uint32_t) s, (uint32_t) i);
+                Ray ray = cameraRay(cam, x + 0.5, y + 0.5);
+                if (settings.primaryOnly) {
+                    double t, u, v;
+                    int id, face;
+                    Vec3 nrm;
+                    getIntersection(ray, t, id, nrm, face, u, v);
+                } else {
+                    radiance(ray, seed);
+                }
+            }
+
+            t_traversalStats = nullptr;
+            map.nodesVisited[i] = (float) stats.nodesVisited / spp;
+            map.aabbTests[i] = (float) stats.aabbTests / spp;
+            map.triTests[i] = (float) stats.triTests / spp;
+        }
+    }
+    return map;
+}
+
+// ==========================================
+// 2. SAÍDAS (IMAGEM EM FALSA COR + HISTOGRAMA)
+// ==========================================
+
+// Gradiente azul -> ciano -> verde -> amarelo -> vermelho para t em [0, 1].
+inline Vec3 heatColor(double t) {
+    static const Vec3 stops[5] = {
+        Vec3(0.0, 0.0, 0.5), Vec3(0.0, 0.8, 1.0), Vec3(0.1, 0.9, 0.1), Vec3(1.0, 0.9, 0.0), Vec3(0.9, 0.0, 0.0)
+    };
+    t = clamp(t) * 4.0;
+    int k = std::min(3, (int) t);
+    double f = t - k;
+    return stops[k] * (1.0 - f) + stops[k + 1] * f;
+}
+
+inline float percentile(std::vector<float> values, double p) {
+    if (values.empty()) return 0.0f;
+    size_t k = std::min(values.size() - 1, (size_t) (p * (values.size() - 1)));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+inline bool writeHeatmapPPM(const std::string &path, const std::vector<float> &values, int width, int height,
+                            float scaleMax) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Erro ao abrir imagem para escrita: " << path << std::endl;
+        return false;
+    }
+    out << "P6\n" << width << " " << height << "\n255\n";
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            Vec3 c = heatColor(values[(height - 1 - y) * width + x] / scaleMax);
+            unsigned char rgb[3] = {
+                (unsigned char) (c.x * 255.0 + 0.5), (unsigned char) (c.y * 255.0 + 0.5),
+                (unsigned char) (c.z * 255.0 + 0.5)
+            };
+            out.write(reinterpret_cast<const char *>(rgb), 3);
+        }
+    }
+    return out.good();
+}
+
+// Grava <prefixo>_nos.ppm, <prefixo>_aabb.ppm, <prefixo>_triangulos.ppm,
+// <prefixo>_histograma.csv e <prefixo>_resumo.txt.
+inline void writeTraversalReport(const std::string &prefix, const TraversalHeatmap &map,
+                                 const HeatmapSettings &settings) {
+    struct Metric {
+        const char *name;
+        const std::vector<float> *values;
+    };
+    const Metric metrics[3] = {
+        {"nos", &map.nodesVisited}, {"aabb", &map.aabbTests}, {"triangulos", &map.triTests}
+    };
+
+    std::ofstream csv(prefix + "_histograma.csv");
+    std::ofstream txt(prefix + "_resumo.txt");
+    csv << "Metrica,Inicio,Fim,Pixels\n";
+    txt << std::fixed << std::setprecision(2);
+    txt << "Resolucao: " << map.width << "x" << map.height << ", amostras por pixel: " << settings.samplesPerPixel
+            << (settings.primaryOnly ? " (apenas raios primarios)" : " (caminho completo)") << "\n";
+
+    for (const auto &m: metrics) {
+        const auto &v = *m.values;
+        double sum = 0.0;
+        float maxVal = 0.0f;
+        for (float x: v) {
+            sum += x;
+            maxVal = std::max(maxVal, x);
+        }
+        float p50 = percentile(v, 0.50), p95 = percentile(v, 0.95), p99 = percentile(v, 0.99);
+        float scale = settings.scaleMax > 0.0f ? settings.scaleMax : std::max(1.0f, p99);
+
+        writeHeatmapPPM(prefix + "_" + m.name + ".ppm", v, map.width, map.height, scale);
+
+        // Histograma linear de 0 até o máximo observado
+        int bins = std::max(1, settings.histogramBins);
+        std::vector<size_t> hist(bins, 0);
+        float binWidth = std::max(1.0f, maxVal) / bins;
+        for (float x: v) hist[std::min(bins - 1, (int) (x / binWidth))]++;
+        for (int b = 0; b < bins; ++b)
+            csv << m.name << "," << b * binWidth << "," << (b + 1) * binWidth << "," << hist[b] << "\n";
+
+        txt << "\n=== " << m.name << " por pixel ===\n";
+        txt << "media=" << (v.empty() ? 0.0 : sum / v.size()) << ", p50=" << p50 << ", p95=" << p95 << ", p99=" << p99
+                << ", max=" << maxVal << ", total=" << sum << "\n";
+        txt << "escala da imagem (vermelho)=" << scale << "\n";
+    }
+}
+
+// Ponto de entrada do modo de instrumentação: constrói a cena e a BVH, mede e grava os relatórios.
+inline void renderTraversalHeatmapMode(const std::vector<std::array<float, 3> > &vertices,
+                                       const std::vector<std::vector<unsigned int> > &faces,
+                                       const std::string &prefix, const HeatmapSettings &settings) {
+    SceneData scene;
+    buildSceneFromMesh(scene, vertices, faces);
+    g_bvhReportEnabled = true; // Modo de benchmark: sempre imprime a qualidade da árvore
+    buildBVH(scene);
+    g_renderMesh = &scene;
+
+    PtCamera cam = makeCamera(settings.camera, settings.width, settings.height);
+    TraversalHeatmap map = renderTraversalHeatmap(cam, settings);
+    writeTraversalReport(prefix, map, settings);
+
+    // Anexa o relatório da BVH ao resumo, para comparar construtores numericamente
+    std::ofstream txt(prefix + "_resumo.txt", std::ios::app);
+    txt << "\n";
+    printBVHReport(analyzeBVH(scene), txt);
+    std::cout << "Heatmap de travessia salvo com prefixo " << prefix << std::endl;
+
+    g_renderMesh = nullptr;
+}
+
+#endif
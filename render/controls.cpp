@@ -1,5 +1,6 @@
 #include "controls.h"
 #include <cctype>
+#include <cmath>
 #include <iostream>
 #include <set>
 #include <vector>
@@ -15,6 +16,11 @@
 #include "../models/file_io/file_io.h"
 #include "tinyfiledialogs.h"
 #include "../render/PathTracer.h"
+#include "../render/Bidirectional.h"
+#include "../render/AmbientOcclusion.h"
+#include "../render/RayPicking.h"
+#include "../render/FrameScheduler.h"
+#include "../render/TimingOverlay.h"
 #include <queue>
 
 /*
@@ -43,9 +49,16 @@ extern float g_rotation_x;
 extern float g_rotation_y;
 extern float g_offset_x;
 extern float g_offset_y;
+extern FrameScheduler g_frameScheduler; // Redesenho sob demanda e trabalho adiado
 
 // Variáveis do Path Tracing
 extern bool g_pathTracingMode;
+extern int g_ptIntegrator;
+extern int g_ptSamples;
+extern std::vector<Vec3> g_accumBuffer;
+
+// Céu HDR escolhido pelo usuário (tecla 'H'). Copiado para a cena a cada ativação do Path Tracing.
+static EnvironmentMap g_environment;
 extern std::vector<Vec3> g_ptVertices;
 extern std::vector<std::vector<unsigned int> > g_ptFaces;
 
@@ -112,6 +125,75 @@ namespace {
     void getViewport(int viewport[4]) {
         glGetIntegerv(GL_VIEWPORT, viewport);
     }
+
+    // Picking por raio na CPU (tecla 'C'): BVH persistente da malha, sem redesenho na GPU.
+    // Com ele ligado, a face sob o cursor é destacada (hover).
+    bool useRayPicking = false;
+    RayPicker rayPicker;
+    int hoverFace = -1;
+
+    // Com a AO ligada, toda edição dispara um bake incremental (só a vizinhança alterada).
+    // O bake e a BVH do picking vão para a fila do agendador: rodam no idle, depois do
+    // quadro que mostra a edição, e edições seguidas se fundem num único trabalho.
+    void refreshAmbientOcclusion() {
+        if (g_object && useRayPicking)
+            g_frameScheduler.defer("bvh-picking", [] {
+                if (g_object && useRayPicking) syncRayPicker(rayPicker, *g_object);
+            });
+        if (!g_object || !g_object->isAOEnabled()) return;
+        g_frameScheduler.defer("ao", [] {
+            if (!g_object || !g_object->isAOEnabled()) return;
+            std::array<float, 3> minP, maxP;
+            if (!g_object->getAODirtyRegion(minP, maxP) &&
+                g_object->getVertexAO().size() == g_object->getVertices().size())
+                return;
+            size_t n = bakeAmbientOcclusion(*g_object);
+            if (n) std::cout << "AO atualizada em " << n << " vertices." << std::endl;
+        });
+    }
+
+    // Seleção por região: arrastar com o botão esquerdo desenha um retângulo (CTRL = laço).
+    // Sem ALT, seleciona só o visível (buffer de IDs); com ALT (ou com o picking por raio
+    // ligado), seleciona através da malha pela BVH. SHIFT acumula, como no clique.
+    bool regionDragging = false;
+    bool regionLasso = false, regionThrough = false, regionAdditive = false;
+    std::vector<std::array<float, 2> > regionPath; // Laço: pontos do traço; retângulo: [início, fim]
+
+    // Painel de tempos de quadro (tecla 'G')
+    TimingOverlay timingOverlay;
+
+    PickCamera currentPickCamera() {
+        return makePickCamera(g_rotation_x, g_rotation_y, g_zoom, g_offset_x, g_offset_y, *g_object,
+                              glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT));
+    }
+
+    RayPickResult rayPickAt(int x, int y) {
+        return rayPick(rayPicker, *g_object, currentPickCamera(), x, y);
+    }
+
+    // Polígono da região na tela (o retângulo vira 4 cantos).
+    std::vector<std::array<float, 2> > regionPolygon() {
+        if (regionLasso || regionPath.size() < 2) return regionPath;
+        const auto &a = regionPath.front(), &b = regionPath.back();
+        return {{a[0], a[1]}, {b[0], a[1]}, {b[0], b[1]}, {a[0], b[1]}};
+    }
+
+    // Resolve a região e aplica tudo de uma vez (um único reenvio de cores no próximo frame).
+    // No modo apenas vértices seleciona vértices; nos demais, faces.
+    void finishRegionSelection() {
+        std::vector<std::array<float, 2> > polygon = regionPolygon();
+        bool wantVertices = g_vertex_only_mode;
+        std::vector<int> ids;
+        int viewport[4];
+        getViewport(viewport);
+        bool resolved = !regionThrough && !useRayPicking && g_object->pickRegion(polygon, viewport, wantVertices, ids);
+        if (!resolved) ids = rayPickRegion(rayPicker, *g_object, currentPickCamera(), polygon, wantVertices);
+
+        if (!regionAdditive) g_object->clearSelection();
+        if (wantVertices) g_object->addToSelection({}, ids);
+        else g_object->addToSelection(ids, {});
+    }
+
 }
 
 namespace controls {
@@ -138,6 +220,15 @@ namespace controls {
         if (keysDown.count('d')) rotation_y += rotationStep; // Direita
     }
 
+    // Câmera em movimento contínuo (teclas de rotação ou de pan seguradas)
+    bool isAnimating() {
+        for (unsigned char key: {'w', 'a', 's', 'd'})
+            if (keysDown.count(key)) return true;
+        for (int key: {GLUT_KEY_UP, GLUT_KEY_DOWN, GLUT_KEY_LEFT, GLUT_KEY_RIGHT})
+            if (specialKeysDown.count(key)) return true;
+        return false;
+    }
+
     // Lógica de Zoom (Escala)
     void processZoom(float &zoom, unsigned char key, int modifiers) {
         const float zoomStep = 0.05f;
@@ -234,6 +325,7 @@ namespace controls {
                 scene.faceTextureID.clear();
                 scene.faceUVs.clear();
                 scene.faceMaterials.clear();
+                scene.environment = g_environment;
 
                 // Copia vértices transformados
                 for (const auto &v: currentVertices) {
@@ -260,10 +352,17 @@ namespace controls {
                     glToPtMap[glID] = (int) scene.textures.size() - 1;
                 }
 
-                // 5. Triangulação de Faces e Atribuição de materiais
-                for (size_t fIdx = 0; fIdx < currentFaces.size(); ++fIdx) {
-                    const auto &face = currentFaces[fIdx];
+                // 5. Triângulos da triangulação em cache do objeto (a mesma do rasterizador)
+                // e atribuição de materiais por face
+                const auto &triIndices = g_object->getTriangleIndices();
+                const auto &faceTris = g_object->getFaceTriangles();
+                size_t triCount = g_object->getTriangleToFace().size();
+                scene.faces.reserve(triCount);
+                scene.faceTextureID.reserve(triCount);
+                scene.faceMaterials.reserve(triCount);
+                scene.faceUVs.reserve(triCount);
 
+                for (size_t fIdx = 0; fIdx < currentFaces.size(); ++fIdx) {
                     // Verifica se a face no editor está marcada como transparente
                     int matType = 0; // 0 = Difuso/Padrão
                     if (g_object->isFaceTransparent((int) fIdx)) {
@@ -283,34 +382,15 @@ namespace controls {
                             originalUVs.push_back({uv.u, uv.v});
                         }
                     }
+                    bool hasUVs = currentTexID != -1 && originalUVs.size() >= currentFaces[fIdx].size();
 
-                    // --- Triangulação ---
-
-                    if (face.size() == 3) {
-                        // Triângulo
-                        scene.faces.push_back({face[0], face[1], face[2]});
-                        scene.faceTextureID.push_back(currentTexID);
-                        scene.faceMaterials.push_back(matType);
-
-                        if (currentTexID != -1 && originalUVs.size() >= 3)
-                            scene.faceUVs.push_back({originalUVs[0], originalUVs[1], originalUVs[2]});
-                        else scene.faceUVs.push_back({});
-                    } else if (face.size() == 4) {
-                        // Quadrado (2 Triângulos)
-                        // Tri 1
-                        scene.faces.push_back({face[0], face[1], face[2]});
+                    // Triângulos da face: [primeiro, fim); o k-ésimo usa os cantos (0, k+1, k+2)
+                    for (int t = faceTris[fIdx][0]; t < faceTris[fIdx][1]; ++t) {
+                        size_t k = static_cast<size_t>(t - faceTris[fIdx][0]);
+                        scene.faces.push_back({triIndices[t * 3], triIndices[t * 3 + 1], triIndices[t * 3 + 2]});
                         scene.faceTextureID.push_back(currentTexID);
                         scene.faceMaterials.push_back(matType);
-                        if (currentTexID != -1 && originalUVs.size() >= 4)
-                            scene.faceUVs.push_back({originalUVs[0], originalUVs[1], originalUVs[2]});
-                        else scene.faceUVs.push_back({});
-
-                        // Tri 2
-                        scene.faces.push_back({face[0], face[2], face[3]});
-                        scene.faceTextureID.push_back(currentTexID);
-                        scene.faceMaterials.push_back(matType);
-                        if (currentTexID != -1 && originalUVs.size() >= 4)
-                            scene.faceUVs.push_back({originalUVs[0], originalUVs[2], originalUVs[3]});
+                        if (hasUVs) scene.faceUVs.push_back({originalUVs[0], originalUVs[k + 1], originalUVs[k + 2]});
                         else scene.faceUVs.push_back({});
                     }
                 }
@@ -329,6 +409,60 @@ namespace controls {
             glutPostRedisplay();
         }
 
+        // --- 'I': Alternar Integrador (Path Tracing <-> BDPT) ---
+        // O BDPT converge muito mais rápido quando a luz é vista através de vidro (cáusticas).
+        else if (lowerKey == 'i') {
+            g_ptIntegrator = (g_ptIntegrator == INTEGRATOR_BDPT) ? INTEGRATOR_PATH : INTEGRATOR_BDPT;
+            std::cout << "Integrador: " << (g_ptIntegrator == INTEGRATOR_BDPT ? "BDPT (bidirecional)" : "Path Tracing")
+                    << std::endl;
+            glutPostRedisplay();
+        }
+
+        // --- 'H': Céu HDR (Environment Map) ---
+        // H abre um .hdr equiretangular; SHIFT + H volta para a luz ambiente constante.
+        else if (lowerKey == 'h') {
+            bool changed = false;
+            if (modifiers & GLUT_ACTIVE_SHIFT) {
+                g_environment = EnvironmentMap();
+                changed = true;
+                std::cout << "Environment map removido." << std::endl;
+            } else {
+                const char *filters[] = {"*.hdr"};
+                const char *filepath = tinyfd_openFileDialog(
+                    "Selecionar Environment Map", "", 1, filters, "Imagens HDR", 0
+                );
+                EnvironmentMap env;
+                if (filepath && loadEnvironmentMap(filepath, env)) {
+                    g_environment = std::move(env);
+                    changed = true;
+                }
+            }
+
+            // Atualiza a cena em uso e reinicia a acumulação (as amostras antigas usam outro céu)
+            if (changed && g_pathTracingMode && g_renderMesh) {
+                g_renderMesh->environment = g_environment;
+                g_ptSamples = 0;
+                std::fill(g_accumBuffer.begin(), g_accumBuffer.end(), Vec3(0, 0, 0));
+            }
+            glutPostRedisplay();
+        }
+
+        // --- 'O': Oclusão Ambiente (preview rápido sem Path Tracing) ---
+        // O calcula (ou atualiza) a AO por vértice e liga a modulação; SHIFT + O desliga.
+        else if (lowerKey == 'o') {
+            if (modifiers & GLUT_ACTIVE_SHIFT) {
+                g_object->setAOEnabled(false);
+                std::cout << "Oclusao ambiente desativada." << std::endl;
+            } else {
+                int start = glutGet(GLUT_ELAPSED_TIME);
+                size_t n = bakeAmbientOcclusion(*g_object);
+                g_object->setAOEnabled(true);
+                std::cout << "Oclusao ambiente: " << n << " vertices calculados em "
+                        << glutGet(GLUT_ELAPSED_TIME) - start << " ms." << std::endl;
+            }
+            glutPostRedisplay();
+        }
+
         // --- 'A': Seleção Inteligente ---
         else if (lowerKey == 'a') {
             // SHIFT + A: Selecionar o objeto conectado
@@ -395,6 +529,89 @@ namespace controls {
             glutPostRedisplay();
         }
 
+        // --- 'C': Picking por raio (CPU/BVH) <-> buffer de IDs (GPU) ---
+        else if (lowerKey == 'c') {
+            useRayPicking = !useRayPicking;
+            hoverFace = -1;
+            std::cout << "Picking: " << (useRayPicking ? "ray casting na CPU (BVH)" : "buffer de IDs na GPU")
+                    << std::endl;
+            glutPostRedisplay();
+        }
+
+        // --- 'M': Wireframe em passada única (shader das faces) <-> passada de linhas ---
+        else if (lowerKey == 'm') {
+            g_object->setSinglePassWireframe(!g_object->isSinglePassWireframe());
+            std::cout << "Wireframe: " << (g_object->isSinglePassWireframe()
+                                                ? "passada unica (shader das faces)"
+                                                : "passada separada de linhas") << std::endl;
+            glutPostRedisplay();
+        }
+
+        // --- 'U': Descarte por blocos (frustum -> + cones -> + oclusão -> desligado) ---
+        else if (lowerKey == 'u') {
+            object::CullingSettings culling = g_object->getCullingSettings();
+            const object::CullingStats &stats = g_object->getCullingStats();
+            std::cout << "Ultimo frame: " << stats.visible << "/" << stats.chunks << " blocos visiveis (frustum "
+                    << stats.frustumCulled << ", cones " << stats.coneCulled << ", oclusao " << stats.occlusionCulled
+                    << ", " << stats.drawCalls << " chamadas, " << stats.triangles << " triangulos)" << std::endl;
+            if (!culling.frustum) culling = object::CullingSettings();
+            else if (!culling.normalCones) culling.normalCones = true;
+            else if (!culling.occlusion) culling.occlusion = true;
+            else culling.frustum = culling.normalCones = culling.occlusion = false;
+            g_object->setCullingSettings(culling);
+            std::cout << "Descarte: " << (!culling.frustum ? "desligado"
+                                          : culling.occlusion ? "frustum + cones + oclusao (Hi-Z)"
+                                          : culling.normalCones ? "frustum + cones de normais"
+                                          : "frustum") << std::endl;
+            glutPostRedisplay();
+        }
+
+        // --- 'G': Painel de tempos (GPU/CPU por passada, gráfico dos últimos quadros) ---
+        else if (lowerKey == 'g') {
+            timingOverlay.visible = !timingOverlay.visible;
+            g_object->setProfilingEnabled(timingOverlay.visible);
+            std::cout << "Painel de tempos: " << (timingOverlay.visible ? "ligado" : "desligado") << std::endl;
+            glutPostRedisplay();
+        }
+
+        // --- 'J': Estatísticas de quadro (SHIFT + J zera) ---
+        else if (lowerKey == 'j') {
+            const FrameStats &stats = g_frameScheduler.stats();
+            std::cout << "Quadros: " << stats.frames << " (ultimo " << stats.lastMs << " ms, media "
+                    << stats.averageMs << " ms, pico " << stats.peakMs << " ms, " << stats.overBudget
+                    << " acima de " << g_frameScheduler.budgetMs << " ms); trabalho adiado: "
+                    << stats.deferredTasksRun << " tarefas em " << stats.deferredMs << " ms" << std::endl;
+            if (modifiers & GLUT_ACTIVE_SHIFT) g_frameScheduler.resetStats();
+        }
+
+        // --- 'Y': Níveis de detalhe por bloco (LOD) ---
+        else if (lowerKey == 'y') {
+            object::LodSettings lod = g_object->getLodSettings();
+            lod.enabled = !lod.enabled;
+            g_object->setLodSettings(lod);
+            std::cout << "LOD: " << (lod.enabled ? "ligado" : "desligado") << " (erro maximo de " << lod.pixelError
+                    << " px)" << std::endl;
+            glutPostRedisplay();
+        }
+
+        // --- 'X': Simplificar a malha (QEM) ---
+        else if (lowerKey == 'x') {
+            std::string suggestion = std::to_string(g_object->getFaces().size() / 2);
+            const char *res = tinyfd_inputBox("Simplificar Malha", "Faces desejadas:", suggestion.c_str());
+            if (!res) return;
+            object::DecimationSettings settings;
+            if (sscanf(res, "%d", &settings.targetFaces) != 1 || settings.targetFaces <= 0) {
+                std::cerr << "Numero de faces invalido." << std::endl;
+                return;
+            }
+            object::DecimationStats stats = g_object->decimate(settings);
+            std::cout << "Simplificacao: " << stats.facesBefore << " -> " << stats.facesAfter << " faces, "
+                    << stats.verticesBefore << " -> " << stats.verticesAfter << " vertices em " << stats.seconds
+                    << " s (erro maximo " << stats.maxError << ")." << std::endl;
+            hoverFace = -1;
+            glutPostRedisplay();
+        }
+
         // --- 'T': Aplicar Textura ---
         else if (lowerKey == 't') {
             if (modifiers & GLUT_ACTIVE_SHIFT) {
@@ -430,9 +647,7 @@ namespace controls {
                 std::cout << "Resetando faces selecionadas para o padrao (Cinza Solido)..." << std::endl;
 
                 //Chama a função de limpeza na classe objeto
-                g_object->resetSelectedFacesToDefault();
-
-                g_object->updateVBOs();
+                g_object->resetSelectedFacesToDefault(); // Marca só as faces resetadas para reenvio
 
                 glutPostRedisplay();
             } else {
@@ -578,6 +793,7 @@ namespace controls {
             processZoom(g_zoom, key, modifiers);
             keyDown(key);
         }
+        refreshAmbientOcclusion();
         glutPostRedisplay();
     }
 
@@ -586,8 +802,12 @@ namespace controls {
     }
 
     // Callbacks para teclas especiais (Setas, F1, etc.)
+    // O idle pode estar desligado (cena parada): o pedido de quadro o rearma pelo display,
+    // e a partir daí a animação do pan segue enquanto a seta estiver pressionada.
     void specialKeyboardDownCallback(int key, int x, int y) {
         specialKeyDown(key);
+        g_frameScheduler.requestRedraw();
+        glutPostRedisplay();
     }
 
     void specialKeyboardUpCallback(int key, int x, int y) {
@@ -598,7 +818,27 @@ namespace controls {
     // CALLBACK DE MOUSE (Picking / Ray Casting)
     //---------------------------
     void mouseCallback(int button, int state, int x, int y) {
+        // Fim de um arraste: seleção por região (arrastes curtos contam só como clique)
+        if (button == GLUT_LEFT_BUTTON && state == GLUT_UP && regionDragging) {
+            regionDragging = false;
+            const auto &start = regionPath.front();
+            bool moved = std::abs(x - start[0]) > 4 || std::abs(y - start[1]) > 4;
+            if (moved && (!regionLasso || regionPath.size() >= 3)) {
+                if (!regionLasso) regionPath.push_back({(float) x, (float) y});
+                finishRegionSelection();
+            }
+            regionPath.clear();
+            glutPostRedisplay();
+            return;
+        }
+
         if (button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) {
+            int downModifiers = glutGetModifiers();
+            regionDragging = !g_pathTracingMode;
+            regionLasso = (downModifiers & GLUT_ACTIVE_CTRL) != 0;
+            regionThrough = (downModifiers & GLUT_ACTIVE_ALT) != 0;
+            regionAdditive = (downModifiers & GLUT_ACTIVE_SHIFT) != 0;
+            regionPath.assign(1, {(float) x, (float) y});
 
             // 1. Obter dados comuns (Tempo e Viewport)
             int currentTime = glutGet(GLUT_ELAPSED_TIME);
@@ -609,12 +849,16 @@ namespace controls {
             // ---------------------------------------------------------
             // 2. Lógica de Duplo Clique (Edição de Vértice)
             // ---------------------------------------------------------
+            RayPickResult rayHit;
+            if (useRayPicking) rayHit = rayPickAt(x, y);
+
             if (!g_face_only_mode && (currentTime - lastLeftClickTime < threshold)) {
-                int vertexIndex = g_object->pickVertex(x, y, viewport);
+                int vertexIndex = useRayPicking ? rayHit.vertex : g_object->pickVertex(x, y, viewport);
                 if (vertexIndex >= 0) {
                     std::cout << "Duplo clique no vértice " << vertexIndex << std::endl;
                     g_object->editVertexCoordinates(vertexIndex);
                     g_object->setVertexColor(vertexIndex, {0.0f, 1.0f, 0.0f});
+                    refreshAmbientOcclusion();
                     glutPostRedisplay();
                     lastLeftClickTime = currentTime;
                     return;
@@ -632,10 +876,10 @@ namespace controls {
             int clickedVertex = -1;
             int clickedFace = -1;
             if (!g_face_only_mode) {
-                clickedVertex = g_object->pickVertex(x, y, viewport);
+                clickedVertex = useRayPicking ? rayHit.vertex : g_object->pickVertex(x, y, viewport);
             }
             if (clickedVertex == -1 && !g_vertex_only_mode) {
-                clickedFace = g_object->pickFace(x, y, viewport);
+                clickedFace = useRayPicking ? rayHit.face : g_object->pickFace(x, y, viewport);
             }
             if (!multiSelect) {
                 g_object->clearSelection();
@@ -660,4 +904,102 @@ namespace controls {
             glutPostRedisplay();
         }
     }
+
+    //---------------------------
+    // HOVER (Picking por raio)
+    //---------------------------
+    // Movimento sem botão: com o picking por raio ligado, atualiza a face sob o cursor.
+    // Uma travessia da BVH por evento; redesenha só quando a face muda.
+    void passiveMotionCallback(int x, int y) {
+        if (!useRayPicking || !g_object || g_pathTracingMode) return;
+        int face = rayPickAt(x, y).face;
+        if (face != hoverFace) {
+            hoverFace = face;
+            glutPostRedisplay();
+        }
+    }
+
+    // Contorno da face sob o cursor. Chamado pelo display com a câmera já aplicada.
+    void drawHoverHighlight() {
+        if (!useRayPicking || !g_object || hoverFace < 0) return;
+        const auto &faces = g_object->getFaces();
+        const auto &vertices = g_object->getVertices();
+        if (hoverFace >= (int) faces.size()) return;
+
+        glPushAttrib(GL_ENABLE_BIT | GL_LINE_BIT | GL_CURRENT_BIT);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_LIGHTING);
+        glDisable(GL_TEXTURE_2D);
+        glLineWidth(2.0f);
+        glColor3f(1.0f, 0.8f, 0.0f);
+        glPushMatrix();
+        const auto &pos = g_object->getPosition();
+        glTranslatef(pos[0], pos[1], pos[2]);
+        glScalef(g_object->getScale(), g_object->getScale(), g_object->getScale());
+        glBegin(GL_LINE_LOOP);
+        for (unsigned int v: faces[hoverFace])
+            if (v < vertices.size()) glVertex3f(vertices[v][0], vertices[v][1], vertices[v][2]);
+        glEnd();
+        glPopMatrix();
+        glPopAttrib();
+    }
+
+    //---------------------------
+    // SELEÇÃO POR REGIÃO (Arraste)
+    //---------------------------
+    // Movimento com botão pressionado: estende o laço ou move o canto do retângulo.
+    void motionCallback(int x, int y) {
+        if (!regionDragging) return;
+        std::array<float, 2> p = {(float) x, (float) y};
+        if (regionLasso) {
+            const auto &last = regionPath.back();
+            if (std::abs(p[0] - last[0]) + std::abs(p[1] - last[1]) < 3.0f) return; // Evita pontos redundantes
+            regionPath.push_back(p);
+        } else {
+            regionPath.resize(1);
+            regionPath.push_back(p);
+        }
+        glutPostRedisplay();
+    }
+
+    // Painel de tempos, depois de fechado o quadro do objeto (endFrameTimings). Chamado pelo
+    // display, fora da câmera. O objeto pode ter sido recriado: o perfilamento é reaplicado.
+    void drawTimingOverlay() {
+        if (!g_object) return;
+        g_object->setProfilingEnabled(timingOverlay.visible);
+        if (!timingOverlay.visible) return;
+        timingOverlay.record(g_frameScheduler.frameElapsedMs(), g_object->getFrameTimings());
+        ::drawTimingOverlay(timingOverlay, g_object->getFrameTimings(), g_frameScheduler.stats(),
+                            g_frameScheduler.budgetMs, glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT));
+    }
+
+    // Traço do retângulo/laço em coordenadas de janela. Chamado pelo display, fora da câmera.
+    void drawSelectionOverlay() {
+        if (!regionDragging || regionPath.size() < 2) return;
+        std::vector<std::array<float, 2> > polygon = regionPolygon();
+
+        glPushAttrib(GL_ENABLE_BIT | GL_LINE_BIT | GL_CURRENT_BIT);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_LIGHTING);
+        glDisable(GL_TEXTURE_2D);
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        glOrtho(0, glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT), 0, -1, 1);
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+
+        glLineWidth(1.0f);
+        glColor3f(0.1f, 0.4f, 1.0f);
+        glBegin(GL_LINE_LOOP);
+        for (const auto &p: polygon) glVertex2f(p[0], p[1]);
+        glEnd();
+
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+        glPopAttrib();
+    }
 } // namespace controls
@@ -9,6 +9,14 @@ namespace controls {
  void specialKeyboardDownCallback(int key, int x, int y);
  void specialKeyboardUpCallback(int key, int x, int y);
  void mouseCallback(int button, int state, int x, int y);
+ void passiveMotionCallback(int x, int y);
+ void motionCallback(int x, int y);
+
+ // Desenho auxiliar (face sob o cursor no picking por raio, traço da seleção por região,
+ // painel de tempos)
+ void drawHoverHighlight();
+ void drawSelectionOverlay();
+ void drawTimingOverlay();
 
  // Funções auxiliares
  void keyDown(unsigned char key);
@@ -18,6 +26,7 @@ namespace controls {
  void specialKeyDown(int key);
  void specialKeyUp(int key);
  void updateNavigation(float &offset_x, float &offset_y);
+ bool isAnimating();
 }
 
 #endif
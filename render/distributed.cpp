@@ -0,0 +1,580 @@
+/*
+ * ======================================================================================
+ * DISTRIBUTED.CPP - RENDERIZAÇÃO DISTRIBUÍDA POR TILES (COORDENADOR / WORKERS)
+ * ======================================================================================
+ *
+ * Permite que uma renderização offline escale além de uma única máquina.
+ *
+ * ARQUITETURA:
+ *
+ * 1. COORDENADOR:
+ * - Abre um socket TCP e (opcionalmente) lança N workers locais apontando para ele.
+ * - A cada worker que conecta, envia a cena no formato binário nativo (serializeScene).
+ * - Divide a imagem em tarefas: (tile, intervalo de passes). Cada tarefa é independente,
+ * pois a semente de cada amostra depende apenas de (semente, passe, pixel).
+ *
+ * 2. BALANCEAMENTO DINÂMICO (Pull Model):
+ * - Cada worker recebe UMA tarefa por vez; ao devolver o resultado recebe a próxima.
+ * Workers lentos naturalmente processam menos tarefas.
+ * - Se um worker morrer (socket fechado), sua tarefa volta para o início da fila.
+ * - Se a fila esvaziar e uma tarefa estiver demorando muito mais que a média, ela é
+ * duplicada em um worker ocioso (execução especulativa). O primeiro resultado vence.
+ *
+ * 3. WORKER:
+ * - Recebe a cena, constrói a BVH localmente e renderiza os tiles pedidos, devolvendo
+ * as somas HDR (float32) para o coordenador mesclar no acumulador.
+ *
+ * PROTOCOLO: mensagens [tipo u32 | tamanho u32 | payload]. Assume hosts little-endian.
+ *
+ * ======================================================================================
+ */
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "distributed.h"
+#include "PathTracer.h"
+#include "OfflineRender.h"
+#include "Checkpoint.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+
+#ifdef _WIN32
+using socket_t = SOCKET;
+#define CLOSE_SOCKET closesocket
+#else
+using socket_t = int;
+#define INVALID_SOCKET (-1)
+#define CLOSE_SOCKET close
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL // Evita SIGPIPE ao escrever em um worker que morreu
+#else
+#define SEND_FLAGS 0
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    enum MessageType : uint32_t {
+        MSG_SCENE = 1, // Coordenador -> Worker: resolução, câmera e cena
+        MSG_TASK = 2, // Coordenador -> Worker: tile + intervalo de passes
+        MSG_RESULT = 3, // Worker -> Coordenador: somas HDR do tile
+        MSG_BYE = 4 // Coordenador -> Worker: encerrar
+    };
+
+    const char SCENE_MAGIC[4] = {'P', 'T', 'S', 'C'};
+    const uint32_t SCENE_VERSION = 1;
+
+    // ============================================================
+    // 1. SERIALIZAÇÃO BINÁRIA
+    // ============================================================
+
+    template<typename T>
+    void put(std::vector<char> &buf, const T &value) {
+        const char *p = reinterpret_cast<const char *>(&value);
+        buf.insert(buf.end(), p, p + sizeof(T));
+    }
+
+    template<typename T>
+    void putArray(std::vector<char> &buf, const T *data, size_t count) {
+        const char *p = reinterpret_cast<const char *>(data);
+        buf.insert(buf.end(), p, p + count * sizeof(T));
+    }
+
+    template<typename T>
+    bool get(const std::vector<char> &buf, size_t &offset, T &value) {
+        if (offset + sizeof(T) > buf.size()) return false;
+        std::memcpy(&value, buf.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    template<typename T>
+    bool getArray(const std::vector<char> &buf, size_t &offset, T *data, size_t count) {
+        if (offset + count * sizeof(T) > buf.size()) return false;
+        std::memcpy(data, buf.data() + offset, count * sizeof(T));
+        offset += count * sizeof(T);
+        return true;
+    }
+
+    // ============================================================
+    // 2. SOCKETS (Abstração mínima Winsock / POSIX)
+    // ============================================================
+
+    bool initSockets() {
+#ifdef _WIN32
+        WSADATA wsa;
+        return WSAStartup(MAKEWORD(2, 2), &wsa) == 0;
+#else
+        return true;
+#endif
+    }
+
+    void shutdownSockets() {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+
+    bool sendAll(socket_t sock, const char *data, size_t size) {
+        while (size > 0) {
+            int chunk = static_cast<int>(std::min<size_t>(size, 1 << 20));
+            int sent = send(sock, data, chunk, SEND_FLAGS);
+            if (sent <= 0) return false;
+            data += sent;
+            size -= sent;
+        }
+        return true;
+    }
+
+    bool recvAll(socket_t sock, char *data, size_t size) {
+        while (size > 0) {
+            int chunk = static_cast<int>(std::min<size_t>(size, 1 << 20));
+            int got = recv(sock, data, chunk, 0);
+            if (got <= 0) return false;
+            data += got;
+            size -= got;
+        }
+        return true;
+    }
+
+    bool sendMessage(socket_t sock, uint32_t type, const std::vector<char> &payload) {
+        uint32_t header[2] = {type, static_cast<uint32_t>(payload.size())};
+        return sendAll(sock, reinterpret_cast<const char *>(header), sizeof(header)) &&
+               sendAll(sock, payload.data(), payload.size());
+    }
+
+    bool recvMessage(socket_t sock, uint32_t &type, std::vector<char> &payload) {
+        uint32_t header[2];
+        if (!recvAll(sock, reinterpret_cast<char *>(header), sizeof(header))) return false;
+        type = header[0];
+        payload.resize(header[1]);
+        return recvAll(sock, payload.data(), payload.size());
+    }
+
+    // ============================================================
+    // 3. ESTADO DO COORDENADOR
+    // ============================================================
+
+    struct Task {
+        uint32_t id;
+        int x0, y0, x1, y1;
+        uint32_t passBegin, passCount;
+        bool done = false;
+        int inFlight = 0; // Quantos workers estão executando esta tarefa (>1 = especulativa)
+    };
+
+    struct WorkerConnection {
+        socket_t sock;
+        std::vector<char> inbox; // Bytes recebidos ainda não processados
+        int task = -1; // Tarefa em execução (-1 = ocioso)
+        Clock::time_point started;
+        bool alive = true;
+    };
+
+    void launchLocalWorker(const std::string &exe, int port) {
+#ifdef _WIN32
+        std::string cmd = "start \"\" /B \"" + exe + "\" 5 127.0.0.1 " + std::to_string(port);
+#else
+        std::string cmd = "\"" + exe + "\" 5 127.0.0.1 " + std::to_string(port) + " &";
+#endif
+        if (std::system(cmd.c_str()) != 0)
+            std::cerr << "Falha ao lancar worker local: " << cmd << std::endl;
+    }
+}
+
+namespace distributed {
+    // ============================================================
+    // 4. FORMATO BINÁRIO DA CENA
+    // ============================================================
+
+    void serializeScene(const SceneData &scene, std::vector<char> &out) {
+        putArray(out, SCENE_MAGIC, 4);
+        put(out, SCENE_VERSION);
+
+        put(out, static_cast<uint32_t>(scene.vertices.size()));
+        for (const auto &v: scene.vertices) {
+            put(out, v.x);
+            put(out, v.y);
+            put(out, v.z);
+        }
+
+        // Faces já trianguladas: sempre 3 índices
+        put(out, static_cast<uint32_t>(scene.faces.size()));
+        for (const auto &f: scene.faces) putArray(out, f.data(), 3);
+
+        put(out, static_cast<uint32_t>(scene.faceMaterials.size()));
+        putArray(out, scene.faceMaterials.data(), scene.faceMaterials.size());
+        put(out, static_cast<uint32_t>(scene.faceTextureID.size()));
+        putArray(out, scene.faceTextureID.data(), scene.faceTextureID.size());
+
+        put(out, static_cast<uint32_t>(scene.faceUVs.size()));
+        for (const auto &uvs: scene.faceUVs) {
+            put(out, static_cast<uint32_t>(uvs.size()));
+            putArray(out, uvs.data(), uvs.size());
+        }
+
+        put(out, static_cast<uint32_t>(scene.textures.size()));
+        for (const auto &tex: scene.textures) {
+            put(out, static_cast<int32_t>(tex.width));
+            put(out, static_cast<int32_t>(tex.height));
+            put(out, static_cast<uint32_t>(tex.pixels.size()));
+            putArray(out, tex.pixels.data(), tex.pixels.size());
+        }
+    }
+
+    bool deserializeScene(const std::vector<char> &in, size_t &offset, SceneData &scene) {
+        char magic[4];
+        uint32_t version = 0, n = 0;
+        if (!getArray(in, offset, magic, 4) || std::memcmp(magic, SCENE_MAGIC, 4) != 0) return false;
+        if (!get(in, offset, version) || version != SCENE_VERSION) return false;
+
+        if (!get(in, offset, n)) return false;
+        scene.vertices.resize(n);
+        for (auto &v: scene.vertices) {
+            if (!get(in, offset, v.x) || !get(in, offset, v.y) || !get(in, offset, v.z)) return false;
+        }
+
+        if (!get(in, offset, n)) return false;
+        scene.faces.assign(n, std::vector<unsigned int>(3));
+        for (auto &f: scene.faces) {
+            if (!getArray(in, offset, f.data(), 3)) return false;
+        }
+
+        if (!get(in, offset, n)) return false;
+        scene.faceMaterials.resize(n);
+        if (!getArray(in, offset, scene.faceMaterials.data(), n)) return false;
+        if (!get(in, offset, n)) return false;
+        scene.faceTextureID.resize(n);
+        if (!getArray(in, offset, scene.faceTextureID.data(), n)) return false;
+
+        if (!get(in, offset, n)) return false;
+        scene.faceUVs.resize(n);
+        for (auto &uvs: scene.faceUVs) {
+            uint32_t k = 0;
+            if (!get(in, offset, k)) return false;
+            uvs.resize(k);
+            if (!getArray(in, offset, uvs.data(), k)) return false;
+        }
+
+        if (!get(in, offset, n)) return false;
+        scene.textures.resize(n);
+        for (auto &tex: scene.textures) {
+            int32_t w = 0, h = 0;
+            uint32_t count = 0;
+            if (!get(in, offset, w) || !get(in, offset, h) || !get(in, offset, count)) return false;
+            tex.width = w;
+            tex.height = h;
+            tex.pixels.resize(count);
+            if (!getArray(in, offset, tex.pixels.data(), count)) return false;
+        }
+        return true;
+    }
+
+    // ============================================================
+    // 5. COORDENADOR
+    // ============================================================
+
+    void runCoordinator(const SceneData &scene, const CoordinatorSettings &settings) {
+        if (!initSockets()) {
+            std::cerr << "Erro ao inicializar sockets." << std::endl;
+            return;
+        }
+
+        socket_t listener = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(static_cast<unsigned short>(settings.port));
+        if (listener == INVALID_SOCKET || bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+            listen(listener, 16) != 0) {
+            std::cerr << "Erro ao escutar na porta " << settings.port << std::endl;
+            shutdownSockets();
+            return;
+        }
+        std::cout << "Coordenador escutando na porta " << settings.port << "..." << std::endl;
+
+        // 1. Mensagem de cena (enviada a cada worker que conecta)
+        std::vector<char> scenePayload;
+        put(scenePayload, static_cast<uint32_t>(settings.width));
+        put(scenePayload, static_cast<uint32_t>(settings.height));
+        putArray(scenePayload, settings.camera.data(), 5);
+        serializeScene(scene, scenePayload);
+
+        // 2. Tarefas: tiles x blocos de passes
+        std::vector<Task> tasks;
+        for (uint32_t p = 0; p < (uint32_t) settings.samplesPerPixel; p += settings.passesPerTask) {
+            uint32_t count = std::min<uint32_t>(settings.passesPerTask, settings.samplesPerPixel - p);
+            for (int y = 0; y < settings.height; y += settings.tileSize) {
+                for (int x = 0; x < settings.width; x += settings.tileSize) {
+                    Task t;
+                    t.id = (uint32_t) tasks.size();
+                    t.x0 = x;
+                    t.y0 = y;
+                    t.x1 = std::min(x + settings.tileSize, settings.width);
+                    t.y1 = std::min(y + settings.tileSize, settings.height);
+                    t.passBegin = p;
+                    t.passCount = count;
+                    tasks.push_back(t);
+                }
+            }
+        }
+        std::deque<int> pending;
+        for (const auto &t: tasks) pending.push_back((int) t.id);
+
+        RenderCheckpoint ck;
+        ck.reset(settings.width, settings.height);
+        ck.camera = settings.camera;
+        ck.sceneHash = hashScene(scene);
+        ck.streams = {SamplerStream{settings.seed, (uint32_t) settings.samplesPerPixel}};
+
+        for (int i = 0; i < settings.localWorkers; ++i) launchLocalWorker(settings.workerExecutable, settings.port);
+
+        std::vector<WorkerConnection> workers;
+        size_t doneCount = 0;
+        double totalTaskSeconds = 0.0;
+        auto start = Clock::now();
+
+        // Devolve a tarefa de um worker morto para a fila
+        auto dropWorker = [&](WorkerConnection &w) {
+            std::cerr << "Worker desconectado." << std::endl;
+            CLOSE_SOCKET(w.sock);
+            w.alive = false;
+            if (w.task >= 0) {
+                Task &t = tasks[w.task];
+                t.inFlight--;
+                if (!t.done && t.inFlight == 0) pending.push_front(w.task);
+                w.task = -1;
+            }
+        };
+
+        auto assign = [&](WorkerConnection &w, int taskIdx) {
+            Task &t = tasks[taskIdx];
+            std::vector<char> payload;
+            for (uint32_t v: {t.id, (uint32_t) t.x0, (uint32_t) t.y0, (uint32_t) t.x1, (uint32_t) t.y1,
+                              settings.seed, t.passBegin, t.passCount})
+                put(payload, v);
+            w.task = taskIdx;
+            w.started = Clock::now();
+            t.inFlight++;
+            if (!sendMessage(w.sock, MSG_TASK, payload)) dropWorker(w);
+        };
+
+        // 3. Loop de eventos
+        while (doneCount < tasks.size()) {
+            fd_set readSet;
+            FD_ZERO(&readSet);
+            FD_SET(listener, &readSet);
+            socket_t maxSock = listener;
+            for (const auto &w: workers) {
+                if (!w.alive) continue;
+                FD_SET(w.sock, &readSet);
+                if (w.sock > maxSock) maxSock = w.sock;
+            }
+            timeval timeout{0, 200000};
+            if (select(static_cast<int>(maxSock + 1), &readSet, nullptr, nullptr, &timeout) < 0) break;
+
+            // A. Novas conexões
+            if (FD_ISSET(listener, &readSet)) {
+                socket_t s = accept(listener, nullptr, nullptr);
+                if (s != INVALID_SOCKET) {
+                    WorkerConnection w;
+                    w.sock = s;
+                    if (sendMessage(s, MSG_SCENE, scenePayload)) {
+                        workers.push_back(w);
+                        std::cout << "Worker conectado (" << workers.size() << ")." << std::endl;
+                    } else {
+                        CLOSE_SOCKET(s);
+                    }
+                }
+            }
+
+            // B. Resultados
+            for (auto &w: workers) {
+                if (!w.alive || !FD_ISSET(w.sock, &readSet)) continue;
+                char buf[65536];
+                int got = recv(w.sock, buf, sizeof(buf), 0);
+                if (got <= 0) {
+                    dropWorker(w);
+                    continue;
+                }
+                w.inbox.insert(w.inbox.end(), buf, buf + got);
+
+                while (w.inbox.size() >= 8) {
+                    uint32_t header[2];
+                    std::memcpy(header, w.inbox.data(), sizeof(header));
+                    if (w.inbox.size() < 8 + (size_t) header[1]) break;
+                    std::vector<char> payload(w.inbox.begin() + 8, w.inbox.begin() + 8 + header[1]);
+                    w.inbox.erase(w.inbox.begin(), w.inbox.begin() + 8 + header[1]);
+                    if (header[0] != MSG_RESULT) continue;
+
+                    size_t off = 0;
+                    uint32_t id = 0;
+                    get(payload, off, id);
+                    if (id >= tasks.size()) continue;
+                    Task &t = tasks[id];
+                    if (w.task == (int) id) {
+                        t.inFlight--;
+                        totalTaskSeconds += std::chrono::duration<double>(Clock::now() - w.started).count();
+                        w.task = -1;
+                    }
+                    if (t.done) continue; // Duplicata especulativa chegou depois: descarta
+
+                    size_t tileW = t.x1 - t.x0, tileH = t.y1 - t.y0;
+                    std::vector<float> sums(tileW * tileH * 3);
+                    if (!getArray(payload, off, sums.data(), sums.size())) continue;
+                    for (size_t ty = 0; ty < tileH; ++ty) {
+                        for (size_t tx = 0; tx < tileW; ++tx) {
+                            int i = (settings.height - 1 - (t.y0 + (int) ty)) * settings.width + t.x0 + (int) tx;
+                            const float *s = &sums[(ty * tileW + tx) * 3];
+                            ck.accum[i] = ck.accum[i] + Vec3(s[0], s[1], s[2]);
+                            ck.counts[i] += t.passCount;
+                        }
+                    }
+                    t.done = true;
+                    doneCount++;
+                    if (doneCount % std::max<size_t>(1, tasks.size() / 20) == 0)
+                        std::cout << "Progresso: " << (100 * doneCount / tasks.size()) << "%" << std::endl;
+                }
+            }
+
+            // C. Distribuição de trabalho para workers ociosos
+            double avgTask = doneCount ? totalTaskSeconds / doneCount : 0.0;
+            for (auto &w: workers) {
+                if (!w.alive || w.task >= 0) continue;
+                while (!pending.empty() && tasks[pending.front()].done) pending.pop_front();
+                if (!pending.empty()) {
+                    int next = pending.front();
+                    pending.pop_front();
+                    assign(w, next);
+                    continue;
+                }
+                // Fila vazia: duplica a tarefa mais atrasada (worker lento)
+                if (avgTask <= 0.0) continue;
+                int straggler = -1;
+                double worst = 3.0 * avgTask;
+                for (const auto &other: workers) {
+                    if (!other.alive || other.task < 0 || tasks[other.task].inFlight > 1) continue;
+                    double running = std::chrono::duration<double>(Clock::now() - other.started).count();
+                    if (running > worst) {
+                        worst = running;
+                        straggler = other.task;
+                    }
+                }
+                if (straggler >= 0) assign(w, straggler);
+            }
+        }
+
+        for (auto &w: workers) {
+            if (!w.alive) continue;
+            sendMessage(w.sock, MSG_BYE, {});
+            CLOSE_SOCKET(w.sock);
+        }
+        CLOSE_SOCKET(listener);
+        shutdownSockets();
+
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << "Renderizacao distribuida concluida em " << elapsed << " s (" << workers.size()
+                << " workers)." << std::endl;
+        if (!settings.checkpointPath.empty()) saveCheckpoint(settings.checkpointPath, ck);
+        if (writePPM(settings.outputName, ck)) std::cout << "Imagem salva em " << settings.outputName << std::endl;
+    }
+
+    // ============================================================
+    // 6. WORKER
+    // ============================================================
+
+    int runWorker(const std::string &host, int port) {
+        if (!initSockets()) return EXIT_FAILURE;
+
+        addrinfo hints{}, *res = nullptr;
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0 || !res) {
+            std::cerr << "Worker: host invalido " << host << std::endl;
+            shutdownSockets();
+            return EXIT_FAILURE;
+        }
+        socket_t sock = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        bool connected = sock != INVALID_SOCKET && connect(sock, res->ai_addr, (int) res->ai_addrlen) == 0;
+        freeaddrinfo(res);
+        if (!connected) {
+            std::cerr << "Worker: falha ao conectar em " << host << ":" << port << std::endl;
+            shutdownSockets();
+            return EXIT_FAILURE;
+        }
+
+        static SceneData scene;
+        PtCamera cam;
+        std::vector<Vec3> accum;
+        std::vector<uint32_t> counts;
+
+        uint32_t type;
+        std::vector<char> payload;
+        while (recvMessage(sock, type, payload)) {
+            size_t off = 0;
+            if (type == MSG_SCENE) {
+                uint32_t w = 0, h = 0;
+                std::array<float, 5> camera{};
+                get(payload, off, w);
+                get(payload, off, h);
+                getArray(payload, off, camera.data(), 5);
+                if (!deserializeScene(payload, off, scene)) {
+                    std::cerr << "Worker: cena corrompida." << std::endl;
+                    break;
+                }
+                buildBVH(scene);
+                g_renderMesh = &scene;
+                cam = makeCamera(camera, (int) w, (int) h);
+                accum.assign((size_t) w * h, Vec3(0, 0, 0));
+                counts.assign((size_t) w * h, 0);
+            } else if (type == MSG_TASK) {
+                uint32_t v[8];
+                for (auto &x: v) get(payload, off, x);
+                int x0 = v[1], y0 = v[2], x1 = v[3], y1 = v[4];
+
+                for (int y = y0; y < y1; ++y) {
+                    for (int x = x0; x < x1; ++x) accum[(cam.height - 1 - y) * cam.width + x] = Vec3(0, 0, 0);
+                }
+                for (uint32_t p = 0; p < v[7]; ++p)
+                    renderPass(cam, SamplerStream{v[5], v[6] + p}, x0, y0, x1, y1, accum, counts);
+
+                std::vector<char> result;
+                put(result, v[0]);
+                for (int y = y0; y < y1; ++y) {
+                    for (int x = x0; x < x1; ++x) {
+                        const Vec3 &c = accum[(cam.height - 1 - y) * cam.width + x];
+                        put(result, (float) c.x);
+                        put(result, (float) c.y);
+                        put(result, (float) c.z);
+                    }
+                }
+                if (!sendMessage(sock, MSG_RESULT, result)) break;
+            } else if (type == MSG_BYE) {
+                break;
+            }
+        }
+
+        g_renderMesh = nullptr;
+        CLOSE_SOCKET(sock);
+        shutdownSockets();
+        return 0;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SceneData;
+
+namespace distributed {
+
+    // Parâmetros do coordenador (processo que divide a imagem e junta os resultados).
+    struct CoordinatorSettings {
+        int port = 5555;
+        int localWorkers = 2; // Workers lançados automaticamente nesta máquina (0 = apenas remotos)
+        int width = 800;
+        int height = 600;
+        int samplesPerPixel = 64;
+        int tileSize = 64; // Lado do tile em pixels
+        int passesPerTask = 4; // Amostras por pixel em cada tarefa
+        uint32_t seed = 1;
+        std::array<float, 5> camera = {0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+        std::string workerExecutable; // Caminho do executável (argv[0]) para lançar workers locais
+        std::string outputName = "render_distribuido.ppm";
+        std::string checkpointPath; // Opcional: grava o acumulador final como checkpoint
+    };
+
+    // Formato binário nativo da cena do Path Tracer (geometria, materiais, UVs e texturas).
+    void serializeScene(const SceneData &scene, std::vector<char> &out);
+    bool deserializeScene(const std::vector<char> &in, size_t &offset, SceneData &scene);
+
+    // Coordenador: escuta em 'port', envia a cena a cada worker conectado e distribui
+    // tarefas (tile + intervalo de passes) sob demanda até completar a imagem.
+    void runCoordinator(const SceneData &scene, const CoordinatorSettings &settings);
+
+    // Worker: conecta ao coordenador, recebe a cena e renderiza tarefas até receber BYE.
+    int runWorker(const std::string &host, int port);
+}
+
+#endif
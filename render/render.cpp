@@ -56,6 +56,24 @@ namespace render {
         glEnable(GL_DEPTH_TEST);
     }
 
+    /*
+     * Equivalente de setup_opengl + glTranslatef/glScalef/glRotatef do display, calculado na CPU.
+     * A ordem das multiplicaes  a mesma da pilha de matrizes: Recuo * Pan * Zoom * RotX * RotY.
+     */
+    void camera_matrices(int width, int height, float offsetX, float offsetY, float zoom,
+                         float rotationX, float rotationY,
+                         math_utils::Mat4 &projection, math_utils::Mat4 &view) {
+        using namespace math_utils;
+        float aspect = height > 0 ? static_cast<float>(width) / static_cast<float>(height) : 1.0f;
+        projection = mat4_perspective(45.0f, aspect, 0.1f, 50.0f);
+
+        view = mat4_translate(0.0f, 0.0f, -10.0f);
+        view = mat4_multiply(view, mat4_translate(offsetX, offsetY, 0.0f));
+        view = mat4_multiply(view, mat4_scale(zoom, zoom, zoom));
+        view = mat4_multiply(view, mat4_rotate(rotationX, 1.0f, 0.0f, 0.0f));
+        view = mat4_multiply(view, mat4_rotate(rotationY, 0.0f, 1.0f, 0.0f));
+    }
+
     /*
      * Funo genrica para limpar a tela e comandar o desenho de um objeto.
      * Recebe uma referncia polimrfica `Drawable&`, desacoplando o renderizador da malha especfica.
@@ -12,6 +12,7 @@
 #include <map>
 #include <string>
 #include <array>
+#include "../utils/math_utils.h"
 
 namespace render {
 
@@ -31,6 +32,12 @@ namespace render {
     // Configura o OpenGL (viewport, projeção, câmera e ativação do depth test)
     void setup_opengl(int width, int height);
 
+    // Mesma câmera de setup_opengl + transformações do modo raster (pan, zoom, rotação), como
+    // matrizes para o renderizador core profile (uniforms em vez da pilha do pipeline fixo).
+    void camera_matrices(int width, int height, float offsetX, float offsetY, float zoom,
+                         float rotationX, float rotationY,
+                         math_utils::Mat4 &projection, math_utils::Mat4 &view);
+
     // Desenha a cena: limpa a tela com a cor de fundo e chama o metodo draw do objeto.
     void draw_scene(Drawable &obj,
                     bool vertexOnlyMode,
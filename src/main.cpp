@@ -9,6 +9,8 @@
  * 1. PIPELINE DE RASTERIZAÇÃO (OpenGL Padrão):
  * - Uso: Visualização em tempo real, edição de malha, feedback imediato (60 FPS).
  * - Técnica: Projeção de geometria 3D em plano 2D usando a GPU (Graphics Pipeline).
+ * - Por padrão usa o renderizador core profile (VAOs + shaders, câmera por uniform);
+ * `1 --legacy-gl` força o pipeline fixo antigo.
  *
  * 2. PIPELINE DE RAY TRACING (Path Tracer via CPU):
  * - Uso: Renderização fotorealista fisicamente baseada (PBR).
@@ -28,12 +30,20 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
 
 #include "../models/file_io/file_io.h"
 #include "../models/object/Object.h"
 #include "performance.h"
 #include "performance-no-prep.h"
 #include "../render/PathTracer.h"
+#include "../render/OfflineRender.h"
+#include "../render/distributed.h"
+#include "../render/TraversalHeatmap.h"
+#include "../render/TetVolume.h"
+#include "../render/FrameScheduler.h"
 #include "../render/render.h"
 #include "../render/controls.h"
 
@@ -53,6 +63,7 @@ SceneData *g_renderMesh = nullptr;
 
 bool g_pathTracingMode = false; // Flag de Estado: Alterna entre OpenGL e Path Tracing
 int g_ptSamples = 0; // Acumulador: Número de quadros (samples) já calculados para a média
+int g_ptIntegrator = INTEGRATOR_PATH; // Integrador do modo interativo (tecla 'i' alterna para BDPT)
 GLuint g_ptTexture = 0; // Handle OpenGL: Textura onde escrevemos o resultado do Ray Tracing
 
 // Buffers de Imagem (Framebuffers de Software):
@@ -81,6 +92,12 @@ float g_offset_y = 0.0f; // Pan Y
 float g_zoom = 1.0f; // Fator de escala da visualização
 bool g_vertex_only_mode = false; // Flag de visualização: Apenas vértices (nuvem de pontos)
 bool g_face_only_mode = false; // Flag de visualização: Apenas faces (sem wireframe)
+// Pipeline fixo legado (glPushMatrix/client arrays) em vez do renderizador core profile.
+// Ligado por "--legacy-gl" na linha de comando, ou automaticamente sem OpenGL 3.3.
+bool g_legacy_pipeline = false;
+// Redesenho sob demanda: o idle só pede quadros com entrada, animação ou trabalho adiado
+// concluído (controls.cpp enfileira o bake de AO e a BVH do picking aqui).
+FrameScheduler g_frameScheduler;
 
 // ---------------------------------------------------------
 // INICIALIZAÇÃO DE RECURSOS DO PATH TRACER
@@ -118,12 +135,14 @@ void updatePathTracingFrame() {
     static float last_zoom = 0.0f;
     static float last_off_x = 0.0f;
     static float last_off_y = 0.0f;
+    static int last_integrator = INTEGRATOR_PATH;
 
     bool isMoving = false;
 
-    // Verifica se houve mudança na câmera
+    // Verifica se houve mudança na câmera (ou no integrador: as amostras não são somáveis)
     if (last_rot_x != g_rotation_x || last_rot_y != g_rotation_y ||
-        last_zoom != g_zoom || last_off_x != g_offset_x || last_off_y != g_offset_y) {
+        last_zoom != g_zoom || last_off_x != g_offset_x || last_off_y != g_offset_y ||
+        last_integrator != g_ptIntegrator) {
         isMoving = true;
         g_ptSamples = 0;
         std::fill(g_accumBuffer.begin(), g_accumBuffer.end(), Vec3(0, 0, 0));
@@ -133,6 +152,7 @@ void updatePathTracingFrame() {
         last_zoom = g_zoom;
         last_off_x = g_offset_x;
         last_off_y = g_offset_y;
+        last_integrator = g_ptIntegrator;
     }
 
     // --- 2. Resolução Dinâmica (OTIMIZAÇÃO CRÍTICA) ---
@@ -141,30 +161,28 @@ void updatePathTracingFrame() {
     int step = (g_ptSamples < 4) ? 6 : 1;
 
     // --- 3. Cálculo da Câmera ---
-    float radX = g_rotation_x * 0.0174533f;
-    float radY = g_rotation_y * 0.0174533f;
-    float dist = 4.0f / (g_zoom > 0.1f ? g_zoom : 0.1f);
+    PtCamera camera = makeCamera(g_rotation_x, g_rotation_y, g_zoom, g_offset_x, g_offset_y, g_winWidth, g_winHeight);
 
-    float camX = sin(radY) * cos(radX) * dist;
-    float camY = -sin(radX) * dist;
-    float camZ = cos(radY) * cos(radX) * dist;
-    camX -= g_offset_x;
-    camY -= g_offset_y;
-
-    Vec3 origin(camX, camY, camZ);
-    Vec3 target(-g_offset_x, -g_offset_y, 0);
-    Vec3 direction = (target - origin).norm();
-    Ray cam(origin, direction);
+    g_ptSamples++;
 
-    Vec3 worldUp(0, 1, 0);
-    Vec3 right = direction.cross(worldUp).norm();
-    Vec3 up = right.cross(direction).norm();
+    // --- 4a. BDPT: sempre quadro inteiro ---
+    // O light tracing espalha contribuições por toda a imagem, então não há preview em blocos.
+    if (g_ptIntegrator == INTEGRATOR_BDPT) {
+        renderPassBidirectional(camera, SamplerStream{1, (uint32_t) g_ptSamples}, g_accumBuffer);
 
-    double aspect = (double) g_winWidth / (double) g_winHeight;
-    Vec3 cx = right * 0.5135 * aspect;
-    Vec3 cy = up * -0.5135;
+#pragma omp parallel for
+        for (int i = 0; i < g_winWidth * g_winHeight; ++i) {
+            Vec3 color = g_accumBuffer[i] * (1.0 / g_ptSamples);
+            g_pixelBuffer[i * 3 + 0] = toInt(color.x);
+            g_pixelBuffer[i * 3 + 1] = toInt(color.y);
+            g_pixelBuffer[i * 3 + 2] = toInt(color.z);
+        }
 
-    g_ptSamples++;
+        glBindTexture(GL_TEXTURE_2D, g_ptTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, g_winWidth, g_winHeight, GL_RGB, GL_UNSIGNED_BYTE,
+                        g_pixelBuffer.data());
+        return;
+    }
 
     // --- 4. Render Loop com Salto de Pixels ---
     // O loop pula 'step' pixels para ganhar velocidade
@@ -184,10 +202,7 @@ void updatePathTracingFrame() {
                 dy = (r2 < 1.0f) ? sqrt(r2) - 1.0f : 1.0f - sqrt(2.0f - r2);
             }
 
-            Vec3 d = cx * (((x + dx) / g_winWidth) - 0.5) * 2.0 +
-                     cy * (((y + dy) / g_winHeight) - 0.5) * 2.0 + cam.d;
-
-            Vec3 rayColor = radiance(Ray(cam.o, d.norm()), seed);
+            Vec3 rayColor = radiance(cameraRay(camera, x + dx, y + dy), seed);
 
             // Acumula
             if (step == 1) {
@@ -224,10 +239,14 @@ void updatePathTracingFrame() {
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, g_winWidth, g_winHeight, GL_RGB, GL_UNSIGNED_BYTE, g_pixelBuffer.data());
 }
 
+void idleCallback();
+
 // ---------------------------------------------------------
 // CALLBACK DE DESENHO (DISPLAY)
 // ---------------------------------------------------------
 void displayCallback() {
+    g_frameScheduler.beginFrame();
+
     // Limpa o fundo e o buffer de profundidade (Z-Buffer)
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -277,8 +296,9 @@ void displayCallback() {
         glPopMatrix(); // Restaura Projection
         glMatrixMode(GL_MODELVIEW);
 
+        g_frameScheduler.endFrame();
         glutSwapBuffers();
-        glutPostRedisplay();
+        glutPostRedisplay(); // Cada quadro acumula mais amostras: o redesenho é contínuo
     } else {
         // ====================================================
         // MODO RASTERIZAÇÃO PADRÃO (OpenGL Tradicional)
@@ -297,13 +317,34 @@ void displayCallback() {
         colors["vertex"] = {0.0f, 0.0f, 0.0f};
 
         if (g_object) {
-            g_object->draw(colors, g_vertex_only_mode, g_face_only_mode);
-            if (!g_vertex_only_mode) {
-                g_object->drawTexturedFaces();
+            bool drawn = false;
+            if (!g_legacy_pipeline) {
+                // Core profile: a câmera vai para os shaders como matrizes (a pilha acima só
+                // serve aos overlays de controls.cpp)
+                math_utils::Mat4 projection, view;
+                render::camera_matrices(glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT),
+                                        g_offset_x, g_offset_y, g_zoom, g_rotation_x, g_rotation_y,
+                                        projection, view);
+                drawn = g_object->drawCore(projection, view, colors, g_vertex_only_mode, g_face_only_mode);
+                if (!drawn) g_legacy_pipeline = true; // Sem suporte: não tenta de novo
             }
+            if (!drawn) {
+                g_object->draw(colors, g_vertex_only_mode, g_face_only_mode);
+                if (!g_vertex_only_mode) {
+                    g_object->drawTexturedFaces();
+                }
+            }
+            controls::drawHoverHighlight();
+            g_object->endFrameTimings(); // Fecha os tempos do quadro para o painel
         }
         glPopMatrix();
+        controls::drawSelectionOverlay();
+        controls::drawTimingOverlay();
+        g_frameScheduler.endFrame();
         glutSwapBuffers();
+
+        // Rearma o idle (ele se desliga quando não há nada a fazer)
+        glutIdleFunc(idleCallback);
     }
 }
 
@@ -313,16 +354,42 @@ void reshapeCallback(int width, int height) {
 }
 
 // Callback chamado quando o sistema está ocioso (Idle)
+// 1. Animação (WASD/setas seguradas): avança a câmera no ritmo do orçamento de quadro.
+// 2. Nas sobras do orçamento, uma fatia de trabalho adiado (AO, BVH do picking).
+// 3. Sem pedido de redesenho, animação ou fila: desliga o idle até o próximo evento
+// (o display o rearma), em vez de redesenhar a cena parada sem parar.
 void idleCallback() {
-    controls::updateRotation(g_rotation_x, g_rotation_y);
-    controls::updateNavigation(g_offset_x, g_offset_y);
-    glutPostRedisplay();
+    if (g_pathTracingMode) { // O display do Path Tracer já se reagenda
+        glutIdleFunc(nullptr);
+        return;
+    }
+
+    bool animating = controls::isAnimating();
+    double wait = g_frameScheduler.msUntilNextFrame();
+    if (animating && wait <= 0.0) {
+        controls::updateRotation(g_rotation_x, g_rotation_y);
+        controls::updateNavigation(g_offset_x, g_offset_y);
+        g_frameScheduler.requestRedraw();
+    }
+    if (!g_frameScheduler.redrawPending()) g_frameScheduler.runDeferredSlice(animating);
+
+    if (g_frameScheduler.redrawPending()) {
+        glutPostRedisplay();
+    } else if (animating) {
+        // Espera o próximo quadro da animação sem ocupar o processador
+        std::this_thread::sleep_for(std::chrono::microseconds((long) (std::min(wait, 2.0) * 1000.0)));
+    } else if (!g_frameScheduler.hasDeferredWork()) {
+        glutIdleFunc(nullptr);
+    }
 }
 
 // ---------------------------------------------------------
 // APLICAÇÃO GRÁFICA INTERATIVA (MODO 1)
 // ---------------------------------------------------------
 void runGraphicalApp(int argc, char **argv) {
+    for (int i = 2; i < argc; ++i)
+        if (std::string(argv[i]) == "--legacy-gl") g_legacy_pipeline = true;
+
     // 1. Inicialização do GLUT (Janela e Contexto)
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
@@ -441,6 +508,8 @@ void runGraphicalApp(int argc, char **argv) {
     glutSpecialUpFunc(controls::specialKeyboardUpCallback);
     glutIdleFunc(idleCallback);
     glutMouseFunc(controls::mouseCallback);
+    glutPassiveMotionFunc(controls::passiveMotionCallback);
+    glutMotionFunc(controls::motionCallback);
 
     // Entra no Loop Principal
     glutMainLoop();
@@ -452,11 +521,10 @@ void runGraphicalApp(int argc, char **argv) {
 // -----------------------
 // MODO PATH TRACING OFFLINE (MODO 3)
 // -----------------------
-// Versão headless/console que gera um arquivo de imagem direto sem interface.
-void runPathTracingMode() {
-    std::string filename = "../assets/indoor_plant_02.obj";
-    std::cout << "Modo Path Tracing: Carregando " << filename << "..." << std::endl;
-
+// Carrega uma malha do disco, centraliza e escala para caber em [-1, 1] (mesma
+// normalização usada pelo visualizador). Usado pelos modos headless do Path Tracer.
+void loadNormalizedMesh(const std::string &filename, std::vector<std::array<float, 3> > &vertices,
+                        std::vector<std::vector<unsigned int> > &faces, fileio::MeshData *cellData = nullptr) {
     // 1. Carrega o arquivo
     fileio::MeshData mesh;
     try {
@@ -466,7 +534,7 @@ void runPathTracingMode() {
         exit(EXIT_FAILURE);
     }
 
-    std::vector<std::array<float, 3> > vertices;
+    vertices.clear();
     for (const auto &v: mesh.vertices) {
         vertices.push_back({static_cast<float>(v[0]), static_cast<float>(v[1]), static_cast<float>(v[2])});
     }
@@ -506,15 +574,187 @@ void runPathTracingMode() {
     }
 
     // 5. Prepara as faces
-    std::vector<std::vector<unsigned int> > faces;
+    faces.clear();
     for (const auto &face: mesh.faces) {
         std::vector<unsigned int> f;
         for (auto idx: face) f.push_back(static_cast<unsigned int>(idx));
         faces.push_back(f);
     }
 
-    // 6. Renderiza
-    renderPathTracing(vertices, faces, "render_output2_plant.ppm");
+    // 6. Atributos por célula (VTK), se quem chamou precisar deles
+    if (cellData) {
+        cellData->cellTypes = std::move(mesh.cellTypes);
+        cellData->cellScalars = std::move(mesh.cellScalars);
+    }
+}
+
+// Versão headless/console que gera um arquivo de imagem direto sem interface.
+// Argumentos opcionais: [amostras por pixel] [arquivo de checkpoint] [semente] [integrador: pt|bdpt] [ceu.hdr]
+// Se o checkpoint existir, a renderização é retomada (ou estendida até o novo alvo de amostras);
+// se ele existir mas não servir para esta cena/integrador, nada é renderizado nem sobrescrito.
+void runPathTracingMode(int argc, char **argv) {
+    std::string filename = "../assets/indoor_plant_02.obj";
+
+    OfflineRenderSettings settings;
+    if (argc > 2) settings.samplesPerPixel = std::max(1, std::atoi(argv[2]));
+    if (argc > 3) settings.checkpointPath = argv[3];
+    if (argc > 4) settings.seed = static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10));
+    if (argc > 5) {
+        std::string integrator = argv[5];
+        if (integrator != "pt" && integrator != "bdpt") {
+            std::cerr << "Integrador invalido: '" << integrator << "'. Use 'pt' ou 'bdpt'." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        settings.integrator = integrator == "bdpt" ? INTEGRATOR_BDPT : INTEGRATOR_PATH;
+    }
+    if (argc > 6) settings.environmentPath = argv[6];
+    std::cout << "Modo Path Tracing: Carregando " << filename << "..." << std::endl;
+
+    std::vector<std::array<float, 3> > vertices;
+    std::vector<std::vector<unsigned int> > faces;
+    loadNormalizedMesh(filename, vertices, faces);
+
+    if (!renderPathTracing(vertices, faces, "render_output2_plant.ppm", settings)) exit(EXIT_FAILURE);
+}
+
+// -----------------------
+// MERGE DE CHECKPOINTS (MODO 4)
+// -----------------------
+// Soma checkpoints de execuções independentes (sementes disjuntas) da mesma cena:
+// teste 4 <saida.ptck> <entrada1.ptck> <entrada2.ptck> ...
+void runMergeCheckpoints(int argc, char **argv) {
+    if (argc < 5) {
+        std::cerr << "Uso: " << argv[0] << " 4 <saida.ptck> <entrada1.ptck> <entrada2.ptck> ..." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    RenderCheckpoint merged;
+    if (!loadCheckpoint(argv[3], merged)) {
+        std::cerr << "Erro ao ler checkpoint: " << argv[3] << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 4; i < argc; ++i) {
+        RenderCheckpoint other;
+        if (!loadCheckpoint(argv[i], other) || !mergeCheckpoint(merged, other)) {
+            std::cerr << "Falha ao mesclar " << argv[i] << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    std::string output = argv[2];
+    saveCheckpoint(output, merged);
+    writePPM(output + ".ppm", merged);
+    std::cout << "Checkpoints mesclados: " << minSampleCount(merged) << " amostras por pixel." << std::endl;
+}
+
+// -----------------------
+// RENDERIZAÇÃO DISTRIBUÍDA (MODOS 5 E 6)
+// -----------------------
+// Worker: teste 5 <host> <porta>
+// Coordenador: teste 6 [porta] [workers locais] [amostras por pixel]
+void runDistributedCoordinator(int argc, char **argv) {
+    std::string filename = "../assets/indoor_plant_02.obj";
+
+    distributed::CoordinatorSettings settings;
+    settings.workerExecutable = argv[0];
+    settings.outputName = "render_output_plant_distribuido.ppm";
+    if (argc > 2) settings.port = std::atoi(argv[2]);
+    if (argc > 3) settings.localWorkers = std::max(0, std::atoi(argv[3]));
+    if (argc > 4) settings.samplesPerPixel = std::max(1, std::atoi(argv[4]));
+
+    std::vector<std::array<float, 3> > vertices;
+    std::vector<std::vector<unsigned int> > faces;
+    loadNormalizedMesh(filename, vertices, faces);
+
+    SceneData scene;
+    buildSceneFromMesh(scene, vertices, faces);
+    distributed::runCoordinator(scene, settings);
+}
+
+// -----------------------
+// HEATMAP DE TRAVESSIA DA BVH (MODO 7)
+// -----------------------
+// teste 7 [prefixo] [amostras por pixel] [apenas primarios: 0/1] [escala maxima]
+void runTraversalHeatmapMode(int argc, char **argv) {
+    std::string filename = "../assets/indoor_plant_02.obj";
+
+    HeatmapSettings settings;
+    std::string prefix = argc > 2 ? argv[2] : "heatmap_plant";
+    if (argc > 3) settings.samplesPerPixel = std::max(1, std::atoi(argv[3]));
+    if (argc > 4) settings.primaryOnly = std::atoi(argv[4]) != 0;
+    if (argc > 5) settings.scaleMax = static_cast<float>(std::atof(argv[5]));
+
+    std::vector<std::array<float, 3> > vertices;
+    std::vector<std::vector<unsigned int> > faces;
+    loadNormalizedMesh(filename, vertices, faces);
+    renderTraversalHeatmapMode(vertices, faces, prefix, settings);
+}
+
+// -----------------------
+// RENDERIZAÇÃO VOLUMÉTRICA DE MALHAS TETRAÉDRICAS (MODO 8)
+// -----------------------
+// teste 8 [arquivo.vtk] [saida.ppm] [densidade] [largura] [altura]
+void runTetVolumeMode(int argc, char **argv) {
+    std::string filename = argc > 2 ? argv[2] : "../assets/tetraHeart35x35x35-0.vtk";
+    std::string output = argc > 3 ? argv[3] : "volume_tetra.ppm";
+
+    VolumeRenderSettings settings;
+    if (argc > 4) settings.density = std::atof(argv[4]);
+    if (argc > 5) settings.width = std::max(1, std::atoi(argv[5]));
+    if (argc > 6) settings.height = std::max(1, std::atoi(argv[6]));
+
+    std::vector<std::array<float, 3> > vertices;
+    std::vector<std::vector<unsigned int> > cells;
+    fileio::MeshData cellData;
+    loadNormalizedMesh(filename, vertices, cells, &cellData);
+
+    TetMesh mesh;
+    if (!buildTetMesh(mesh, vertices, cells, cellData.cellTypes, cellData.cellScalars)) return;
+    renderTetVolume(mesh, output, settings);
+}
+
+// -----------------------
+// SIMPLIFICAÇÃO DE MALHAS (MODO 9)
+// -----------------------
+// teste 9 <entrada> <saida> [faces alvo] [erro maximo]
+// Sem alvo, reduz à metade. O erro é medido nas unidades do arquivo (sem normalização).
+void runDecimationMode(int argc, char **argv) {
+    if (argc < 4) {
+        std::cerr << "Uso: " << argv[0] << " 9 <entrada> <saida> [faces alvo] [erro maximo]" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    fileio::MeshData mesh;
+    try {
+        mesh = fileio::read_file(argv[2]);
+    } catch (const std::exception &e) {
+        std::cerr << "Erro ao carregar o arquivo: " << e.what() << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<std::array<float, 3> > vertices;
+    for (const auto &v: mesh.vertices)
+        vertices.push_back({static_cast<float>(v[0]), static_cast<float>(v[1]), static_cast<float>(v[2])});
+    std::vector<std::vector<unsigned int> > faces;
+    for (const auto &face: mesh.faces) faces.push_back(std::vector<unsigned int>(face.begin(), face.end()));
+    std::vector<unsigned int> face_cells(mesh.faceCells.begin(), mesh.faceCells.end());
+
+    object::Object obj({0.0f, 0.0f, 0.0f}, vertices, faces, face_cells, argv[2], 100, false);
+
+    object::DecimationSettings settings;
+    settings.targetFaces = argc > 4 ? std::atoi(argv[4]) : static_cast<int>(faces.size() / 2);
+    if (argc > 5) settings.maxError = static_cast<float>(std::atof(argv[5]));
+    object::DecimationStats stats = obj.decimate(settings);
+    std::cout << "Simplificacao: " << stats.facesBefore << " -> " << stats.facesAfter << " faces, "
+            << stats.verticesBefore << " -> " << stats.verticesAfter << " vertices em " << stats.rounds
+            << " rodadas (" << stats.seconds << " s, erro maximo " << stats.maxError << ")." << std::endl;
+
+    try {
+        fileio::save_file(argv[3], obj.getVertices(), obj.getFaces());
+        std::cout << "Arquivo salvo com sucesso: " << argv[3] << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << "Erro ao salvar o arquivo: " << e.what() << std::endl;
+        exit(EXIT_FAILURE);
+    }
 }
 
 // -----------------------
@@ -618,8 +858,28 @@ void runPerformanceTestNoPrep() {
 // Main: escolhe o modo com base no argumento de linha de comando
 // -----------------------
 
+// Tabela de modos e argumentos (<obrigatorio> [opcional]), impressa quando o modo é inválido.
+void printUsage(const char *program) {
+    std::cerr << "Uso: " << program << " [modo] [argumentos]\n"
+            << "  0                                   teste de desempenho (com pre-processamento)\n"
+            << "  1 [--legacy-gl]                     aplicacao grafica (padrao sem argumentos)\n"
+            << "  2                                   teste de desempenho (sem pre-processamento)\n"
+            << "  3 [spp] [checkpoint.ptck] [semente] [pt|bdpt] [ceu.hdr]\n"
+            << "                                      Path Tracing offline com checkpoints\n"
+            << "  4 <saida.ptck> <entrada1.ptck> <entrada2.ptck> ...\n"
+            << "                                      mescla checkpoints\n"
+            << "  5 <host> <porta>                    worker da renderizacao distribuida\n"
+            << "  6 [porta] [workers locais] [spp]    coordenador da renderizacao distribuida\n"
+            << "  7 [prefixo] [spp] [apenas primarios: 0/1] [escala maxima]\n"
+            << "                                      heatmap de travessia da BVH\n"
+            << "  8 [arquivo.vtk] [saida.ppm] [densidade] [largura] [altura]\n"
+            << "                                      volume de malha tetraedrica\n"
+            << "  9 <entrada> <saida> [faces alvo] [erro maximo]\n"
+            << "                                      simplificacao de malha" << std::endl;
+}
+
 int main(int argc, char **argv) {
-    // Se receber um argumento, verifique: "0" para performance test, "1" para a aplicação gráfica.
+    // Se receber um argumento, ele escolhe o modo (ver printUsage).
     if (argc > 1) {
         std::string mode = argv[1];
         if (mode == "0") {
@@ -629,9 +889,26 @@ int main(int argc, char **argv) {
         } else if (mode == "2") {
             runPerformanceTestNoPrep();
         } else if (mode == "3") {
-            runPathTracingMode();
+            runPathTracingMode(argc, argv);
+        } else if (mode == "4") {
+            runMergeCheckpoints(argc, argv);
+        } else if (mode == "5") {
+            if (argc < 4) {
+                std::cerr << "Uso: " << argv[0] << " 5 <host> <porta>" << std::endl;
+                return EXIT_FAILURE;
+            }
+            return distributed::runWorker(argv[2], std::atoi(argv[3]));
+        } else if (mode == "6") {
+            runDistributedCoordinator(argc, argv);
+        } else if (mode == "7") {
+            runTraversalHeatmapMode(argc, argv);
+        } else if (mode == "8") {
+            runTetVolumeMode(argc, argv);
+        } else if (mode == "9") {
+            runDecimationMode(argc, argv);
         } else {
-            std::cerr << "Modo inválido. Use '0' para teste de desempenho ou '1' para aplicação gráfica." << std::endl;
+            std::cerr << "Modo invalido: '" << mode << "'." << std::endl;
+            printUsage(argv[0]);
             return EXIT_FAILURE;
         }
     } else {
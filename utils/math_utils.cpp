@@ -30,4 +30,75 @@ namespace math_utils {
         return normalize(cp);
     }
 
+    bool point_in_polygon(float x, float y, const std::vector<std::array<float, 2>>& polygon) {
+        bool inside = false;
+        for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+            const auto &a = polygon[i], &b = polygon[j];
+            if ((a[1] > y) != (b[1] > y) && x < (b[0] - a[0]) * (y - a[1]) / (b[1] - a[1]) + a[0])
+                inside = !inside;
+        }
+        return inside;
+    }
+
+    Mat4 mat4_identity() {
+        return {1, 0, 0, 0,
+                0, 1, 0, 0,
+                0, 0, 1, 0,
+                0, 0, 0, 1};
+    }
+
+    Mat4 mat4_multiply(const Mat4& a, const Mat4& b) {
+        Mat4 r{};
+        for (int col = 0; col < 4; ++col)
+            for (int row = 0; row < 4; ++row) {
+                float sum = 0.0f;
+                for (int k = 0; k < 4; ++k) sum += a[k * 4 + row] * b[col * 4 + k];
+                r[col * 4 + row] = sum;
+            }
+        return r;
+    }
+
+    Mat4 mat4_translate(float x, float y, float z) {
+        Mat4 r = mat4_identity();
+        r[12] = x;
+        r[13] = y;
+        r[14] = z;
+        return r;
+    }
+
+    Mat4 mat4_scale(float x, float y, float z) {
+        Mat4 r = mat4_identity();
+        r[0] = x;
+        r[5] = y;
+        r[10] = z;
+        return r;
+    }
+
+    // Rotação em torno de um eixo arbitrário (fórmula de Rodrigues, como o glRotatef).
+    Mat4 mat4_rotate(float angleDegrees, float x, float y, float z) {
+        float len = std::sqrt(x * x + y * y + z * z);
+        if (len == 0.0f) return mat4_identity();
+        x /= len;
+        y /= len;
+        z /= len;
+        float a = angleDegrees * 3.14159265358979f / 180.0f;
+        float c = std::cos(a), s = std::sin(a), t = 1.0f - c;
+        return {t * x * x + c,     t * x * y + s * z, t * x * z - s * y, 0,
+                t * x * y - s * z, t * y * y + c,     t * y * z + s * x, 0,
+                t * x * z + s * y, t * y * z - s * x, t * z * z + c,     0,
+                0,                 0,                 0,                 1};
+    }
+
+    // Mesma matriz do gluPerspective.
+    Mat4 mat4_perspective(float fovyDegrees, float aspect, float zNear, float zFar) {
+        float f = 1.0f / std::tan(fovyDegrees * 3.14159265358979f / 360.0f);
+        Mat4 r{};
+        r[0] = f / aspect;
+        r[5] = f;
+        r[10] = (zFar + zNear) / (zNear - zFar);
+        r[11] = -1.0f;
+        r[14] = 2.0f * zFar * zNear / (zNear - zFar);
+        return r;
+    }
+
 } // namespace math_utils
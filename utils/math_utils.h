@@ -2,6 +2,7 @@
 #define MATH_UTILS_H
 
 #include <array>
+#include <vector>
 
 namespace math_utils {
 
@@ -12,6 +13,18 @@ namespace math_utils {
     std::array<float, 3> calculate_normal(const std::array<float, 3>& v1,
                                             const std::array<float, 3>& v2,
                                             const std::array<float, 3>& v3);
+    // Regra par-ímpar; serve para retângulos e laços (polígonos fechados, não necessariamente convexos).
+    bool point_in_polygon(float x, float y, const std::vector<std::array<float, 2>>& polygon);
+
+    // Matriz 4x4 em colunas (mesma convenção do OpenGL: glUniformMatrix4fv sem transpor).
+    // Cada função equivale à chamada do pipeline fixo de mesmo nome (glTranslatef, glRotatef...).
+    using Mat4 = std::array<float, 16>;
+    Mat4 mat4_identity();
+    Mat4 mat4_multiply(const Mat4& a, const Mat4& b); // a * b
+    Mat4 mat4_translate(float x, float y, float z);
+    Mat4 mat4_scale(float x, float y, float z);
+    Mat4 mat4_rotate(float angleDegrees, float x, float y, float z);
+    Mat4 mat4_perspective(float fovyDegrees, float aspect, float zNear, float zFar);
 
 } // namespace math_utils
 